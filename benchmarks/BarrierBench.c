@@ -0,0 +1,537 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * @brief   Measures the performance of the 'Hook Barrier' fast path.
+ *
+ * The benchmark measures the time of a `ZyrexBarrierTryEnter` + `ZyrexBarrierLeave` pair while
+ * sweeping the recursion depth, the number of distinct handles that are simultaneously entered by
+ * each thread and the number of threads. The `lookup` variant additionally resolves the handle of
+ * a real trampoline by `ZyrexBarrierGetHandle` before every `ZyrexBarrierTryEnter`, as done by a
+ * hook callback. Results are written to `stdout` in CSV format.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/Transaction.h>
+#include <Zyrex/Zyrex.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <pthread.h>
+#   include <time.h>
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * The maximum number of distinct handles that are entered by a single thread.
+ */
+#define BENCH_MAX_HANDLES   1024
+
+/**
+ * The maximum number of threads.
+ */
+#define BENCH_MAX_THREADS   16
+
+/**
+ * The minimum number of barrier operations performed by each thread per measurement.
+ */
+#define BENCH_MIN_OPS       (1 << 22)
+
+/**
+ * The base address of the synthetic non-dense barrier handles.
+ */
+#define BENCH_SPARSE_BASE   0x00007FF600010000ULL
+
+/**
+ * The size of a single synthetic target function (in bytes).
+ */
+#define BENCH_TARGET_SIZE   16
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `BenchHandleKind` enum.
+ */
+typedef enum BenchHandleKind_
+{
+    /**
+     * Dense handles, as returned for trampolines allocated by Zyrex.
+     */
+    BENCH_HANDLE_KIND_DENSE,
+    /**
+     * Opaque pointer handles, which are stored in the per-thread hash table.
+     */
+    BENCH_HANDLE_KIND_SPARSE,
+    /**
+     * Dense handles, that are resolved from the trampolines of installed hooks by
+     * `ZyrexBarrierGetHandle` before every barrier enter.
+     */
+    BENCH_HANDLE_KIND_LOOKUP
+} BenchHandleKind;
+
+/**
+ * Defines the `BenchParams` struct.
+ */
+typedef struct BenchParams_
+{
+    /**
+     * The handle kind.
+     */
+    BenchHandleKind kind;
+    /**
+     * The recursion depth entered for each handle.
+     */
+    ZyanU32 depth;
+    /**
+     * The number of distinct handles entered at the same time.
+     */
+    ZyanU32 handle_count;
+    /**
+     * The number of rounds to perform.
+     */
+    ZyanU64 rounds;
+} BenchParams;
+
+/**
+ * Defines the `BenchThreadContext` struct.
+ */
+typedef struct BenchThreadContext_
+{
+    /**
+     * The benchmark parameters.
+     */
+    const BenchParams* params;
+    /**
+     * Receives the elapsed time in nanoseconds.
+     */
+    ZyanU64 elapsed;
+    /**
+     * Receives `ZYAN_FALSE`, if one of the barrier operations returned an unexpected result.
+     */
+    ZyanBool is_valid;
+} BenchThreadContext;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * The synthetic target functions.
+ */
+static ZyanU8* g_bench_targets;
+
+/**
+ * The trampolines of the hooks installed on the synthetic target functions.
+ */
+static ZyanConstVoidPointer g_bench_trampolines[BENCH_MAX_HANDLES];
+
+/* ============================================================================================== */
+/* Helper functions                                                                               */
+/* ============================================================================================== */
+
+/**
+ * Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return  A monotonic timestamp in nanoseconds.
+ */
+static ZyanU64 BenchGetTimestamp(void)
+{
+#if defined(ZYAN_WINDOWS)
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (ZyanU64)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ZyanU64)ts.tv_sec * 1000000000ULL + (ZyanU64)ts.tv_nsec;
+#endif
+}
+
+/**
+ * Returns the barrier handle with the given `index`.
+ *
+ * @param   kind    The handle kind.
+ * @param   index   The handle index.
+ *
+ * @return  The barrier handle.
+ */
+static ZyrexBarrierHandle BenchGetHandle(BenchHandleKind kind, ZyanU32 index)
+{
+    switch (kind)
+    {
+    case BENCH_HANDLE_KIND_DENSE:
+        return (ZyrexBarrierHandle)index;
+    case BENCH_HANDLE_KIND_LOOKUP:
+        return ZyrexBarrierGetHandle(g_bench_trampolines[index]);
+    default:
+        // Mimic the layout of trampoline code buffers
+        return (ZyrexBarrierHandle)(BENCH_SPARSE_BASE + (ZyanU64)index * 0xD8);
+    }
+}
+
+/**
+ * The callback of the hooks installed on the synthetic target functions.
+ *
+ * @return  An arbitrary value.
+ *
+ * The hooked functions are never called. The hooks only provide the trampolines for the
+ * `lookup` variant.
+ */
+static ZyanU32 ZYAN_NOINLINE BenchCallback(void)
+{
+    return 0;
+}
+
+/**
+ * Generates the synthetic target functions and installs a hook on each of them.
+ *
+ * @return  `ZYAN_TRUE`, if the hooks have been installed, `ZYAN_FALSE` if not.
+ *
+ * Every target function consists of a `mov eax, imm32` that loads its index, followed by a `ret`.
+ */
+static ZyanBool BenchInstallHooks(void)
+{
+    const ZyanUSize size = BENCH_MAX_HANDLES * BENCH_TARGET_SIZE;
+
+#if defined(ZYAN_WINDOWS)
+    g_bench_targets = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!g_bench_targets)
+    {
+        return ZYAN_FALSE;
+    }
+#else
+    void* const memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+        -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return ZYAN_FALSE;
+    }
+    g_bench_targets = memory;
+#endif
+
+    memset(g_bench_targets, 0xCC, size);
+    for (ZyanU32 i = 0; i < BENCH_MAX_HANDLES; ++i)
+    {
+        ZyanU8* const target = &g_bench_targets[i * BENCH_TARGET_SIZE];
+        // mov eax, imm32
+        target[0] = 0xB8;
+        memcpy(&target[1], &i, sizeof(i));
+        // ret
+        target[5] = 0xC3;
+    }
+
+#if defined(ZYAN_WINDOWS)
+    DWORD old_protection;
+    if (!VirtualProtect(g_bench_targets, size, PAGE_EXECUTE_READ, &old_protection))
+    {
+        return ZYAN_FALSE;
+    }
+    FlushInstructionCache(GetCurrentProcess(), g_bench_targets, size);
+#else
+    if (mprotect(g_bench_targets, size, PROT_READ | PROT_EXEC))
+    {
+        return ZYAN_FALSE;
+    }
+#endif
+
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()))
+    {
+        return ZYAN_FALSE;
+    }
+    for (ZyanU32 i = 0; i < BENCH_MAX_HANDLES; ++i)
+    {
+        if (!ZYAN_SUCCESS(ZyrexInstallInlineHook(&g_bench_targets[i * BENCH_TARGET_SIZE],
+            (const void*)(ZyanUPointer)&BenchCallback, &g_bench_trampolines[i])))
+        {
+            ZyrexTransactionAbort();
+            return ZYAN_FALSE;
+        }
+    }
+    if (!ZYAN_SUCCESS(ZyrexUpdateAllThreads()) || !ZYAN_SUCCESS(ZyrexTransactionCommit()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+
+    return ZYAN_TRUE;
+}
+
+/* ============================================================================================== */
+/* Benchmark                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * Performs a single round of barrier operations.
+ *
+ * @param   params  The benchmark parameters.
+ * @param   handles The barrier handles.
+ *
+ * @return  `ZYAN_TRUE`, if all barrier operations returned the expected result, `ZYAN_FALSE` if
+ *          not.
+ */
+static ZyanBool BenchRound(const BenchParams* params, const ZyrexBarrierHandle* handles)
+{
+    ZyanBool result = ZYAN_TRUE;
+
+    const ZyanBool is_lookup = (params->kind == BENCH_HANDLE_KIND_LOOKUP);
+    for (ZyanU32 i = 0; i < params->handle_count; ++i)
+    {
+        for (ZyanU32 j = 0; j < params->depth; ++j)
+        {
+            // Every nested callback invocation resolves its own handle
+            const ZyrexBarrierHandle handle =
+                is_lookup ? BenchGetHandle(params->kind, i) : handles[i];
+            result &= (handle == handles[i]);
+            result &= (ZyrexBarrierTryEnterEx(handle, params->depth) == ZYAN_STATUS_TRUE);
+        }
+    }
+    for (ZyanU32 i = params->handle_count; i > 0; --i)
+    {
+        for (ZyanU32 j = 0; j < params->depth; ++j)
+        {
+            result &= (ZyrexBarrierLeave(handles[i - 1]) == ZYAN_STATUS_TRUE);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * The benchmark thread.
+ *
+ * @param   context A pointer to the `BenchThreadContext` struct.
+ */
+static void BenchThread(BenchThreadContext* context)
+{
+    const BenchParams* const params = context->params;
+
+    ZyrexBarrierHandle handles[BENCH_MAX_HANDLES];
+    for (ZyanU32 i = 0; i < params->handle_count; ++i)
+    {
+        handles[i] = BenchGetHandle(params->kind, i);
+    }
+
+    // Warm up and make sure the thread data has already been allocated
+    context->is_valid = BenchRound(params, handles);
+
+    const ZyanU64 start = BenchGetTimestamp();
+    for (ZyanU64 i = 0; i < params->rounds; ++i)
+    {
+        context->is_valid &= BenchRound(params, handles);
+    }
+    context->elapsed = BenchGetTimestamp() - start;
+}
+
+#if defined(ZYAN_WINDOWS)
+static DWORD WINAPI BenchThreadProc(LPVOID parameter)
+{
+    BenchThread((BenchThreadContext*)parameter);
+    return 0;
+}
+#else
+static void* BenchThreadProc(void* parameter)
+{
+    BenchThread((BenchThreadContext*)parameter);
+    return NULL;
+}
+#endif
+
+/**
+ * Runs a single benchmark configuration and prints the result.
+ *
+ * @param   params          The benchmark parameters.
+ * @param   thread_count    The number of threads.
+ *
+ * @return  `ZYAN_TRUE`, if the benchmark succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchRun(const BenchParams* params, ZyanU32 thread_count)
+{
+    BenchThreadContext contexts[BENCH_MAX_THREADS];
+#if defined(ZYAN_WINDOWS)
+    HANDLE threads[BENCH_MAX_THREADS];
+#else
+    pthread_t threads[BENCH_MAX_THREADS];
+#endif
+
+    ZyanU32 started = 0;
+    for (; started < thread_count; ++started)
+    {
+        BenchThreadContext* const context = &contexts[started];
+        context->params = params;
+        context->elapsed = 0;
+        context->is_valid = ZYAN_FALSE;
+#if defined(ZYAN_WINDOWS)
+        threads[started] = CreateThread(NULL, 0, &BenchThreadProc, context, 0, NULL);
+        if (!threads[started])
+        {
+            break;
+        }
+#else
+        if (pthread_create(&threads[started], NULL, &BenchThreadProc, context))
+        {
+            break;
+        }
+#endif
+    }
+
+    // The threads that have already been started are joined in any case, to not distort the
+    // following configurations
+    ZyanBool is_valid = ZYAN_TRUE;
+    ZyanU64 elapsed_total = 0;
+    ZyanU64 elapsed_max = 0;
+    for (ZyanU32 i = 0; i < started; ++i)
+    {
+#if defined(ZYAN_WINDOWS)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+        is_valid &= contexts[i].is_valid;
+        elapsed_total += contexts[i].elapsed;
+        if (contexts[i].elapsed > elapsed_max)
+        {
+            elapsed_max = contexts[i].elapsed;
+        }
+    }
+
+    if (started < thread_count)
+    {
+        return ZYAN_FALSE;
+    }
+
+    static const char* const kinds[] = { "dense", "sparse", "lookup" };
+
+    // Every operation consists of one `ZyrexBarrierTryEnterEx` and one `ZyrexBarrierLeave` call,
+    // preceded by one `ZyrexBarrierGetHandle` call for the `lookup` variant
+    const double ops = (double)params->rounds * params->handle_count * params->depth;
+    printf("%s,%u,%u,%u,%llu,%.3f,%.3f,%s\n",
+        kinds[params->kind],
+        thread_count,
+        params->depth,
+        params->handle_count,
+        (unsigned long long)ops,
+        (double)elapsed_total / thread_count / ops,
+        (double)elapsed_max / ops,
+        is_valid ? "ok" : "invalid");
+    fflush(stdout);
+
+    return is_valid;
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+int main(int argc, char** argv)
+{
+    static const ZyanU32 depths[] = { 1, 2, 4, 8 };
+    static const ZyanU32 handle_counts[] = { 1, 2, 4, 8, 16, 32, 64, 126, 256, 512, 1024 };
+    static const ZyanU32 thread_counts[] = { 1, 2, 4, 8, 16 };
+
+    ZyanU32 max_threads = 8;
+    if (argc > 1)
+    {
+        max_threads = (ZyanU32)strtoul(argv[1], NULL, 10);
+        if ((max_threads == 0) || (max_threads > BENCH_MAX_THREADS))
+        {
+            fprintf(stderr, "Usage: %s [max_threads (1..%d)]\n", argv[0], BENCH_MAX_THREADS);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!ZYAN_SUCCESS(ZyrexInitialize()) || !ZYAN_SUCCESS(ZyrexBarrierSystemInitialize()))
+    {
+        fputs("Failed to initialize Zyrex\n", stderr);
+        return EXIT_FAILURE;
+    }
+    if (!BenchInstallHooks())
+    {
+        fputs("Failed to install the hooks\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    puts("kind,threads,depth,handles,ops_per_thread,ns_per_op,ns_per_op_max,status");
+
+    ZyanBool is_valid = ZYAN_TRUE;
+    for (int kind = BENCH_HANDLE_KIND_DENSE; kind <= BENCH_HANDLE_KIND_LOOKUP; ++kind)
+    {
+        for (ZyanUSize t = 0; t < ZYAN_ARRAY_LENGTH(thread_counts); ++t)
+        {
+            if (thread_counts[t] > max_threads)
+            {
+                break;
+            }
+            for (ZyanUSize d = 0; d < ZYAN_ARRAY_LENGTH(depths); ++d)
+            {
+                for (ZyanUSize h = 0; h < ZYAN_ARRAY_LENGTH(handle_counts); ++h)
+                {
+                    // Sparse handles are limited by the capacity of the per-thread hash table
+                    if ((kind == BENCH_HANDLE_KIND_SPARSE) && (handle_counts[h] > 126))
+                    {
+                        break;
+                    }
+
+                    BenchParams params;
+                    params.kind = (BenchHandleKind)kind;
+                    params.depth = depths[d];
+                    params.handle_count = handle_counts[h];
+                    params.rounds = BENCH_MIN_OPS / (depths[d] * handle_counts[h]);
+
+                    is_valid &= BenchRun(&params, thread_counts[t]);
+                }
+            }
+        }
+    }
+
+    ZyrexBarrierSystemShutdown();
+    ZyrexShutdown();
+
+    return is_valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,736 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * @brief   Measures the end-to-end performance of the hook engine.
+ *
+ * The benchmark consists of two scenarios:
+ * - The installation and removal of inline hooks for a growing number of synthetic target
+ *   functions, while a number of threads keeps running. The time spent in the install calls, in
+ *   `ZyrexUpdateAllThreads` and in `ZyrexTransactionCommitEx` is measured separately. Threads
+ *   are frozen from the thread update until the end of the commit. The committed trampoline
+ *   memory per hook is reported as well.
+ * - The per-call overhead of a hooked function compared to the original function and to a
+ *   direct call of the trampoline.
+ *
+ * Results are written to `stdout` in CSV format. Each scenario prints its own table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/Transaction.h>
+#include <Zyrex/Zyrex.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <pthread.h>
+#   include <time.h>
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * The maximum number of synthetic target functions.
+ */
+#define BENCH_MAX_TARGETS       10000
+
+/**
+ * The size of a single synthetic target function (in bytes).
+ */
+#define BENCH_TARGET_SIZE       16
+
+/**
+ * The maximum number of running threads.
+ */
+#define BENCH_MAX_THREADS       16
+
+/**
+ * The number of calls performed per call overhead measurement.
+ */
+#define BENCH_CALL_COUNT        (1 << 24)
+
+/**
+ * The number of repetitions of each measurement. The fastest repetition is reported.
+ */
+#define BENCH_REPETITIONS       5
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `BenchFunction` function prototype.
+ *
+ * All synthetic target functions return their index.
+ */
+typedef ZyanU32 (*BenchFunction)(void);
+
+/**
+ * Defines the `BenchInstallResult` struct.
+ */
+typedef struct BenchInstallResult_
+{
+    /**
+     * The time spent in the install calls (in nanoseconds).
+     */
+    ZyanU64 install;
+    /**
+     * The time spent in the thread update of the install transaction (in nanoseconds).
+     */
+    ZyanU64 install_update;
+    /**
+     * The time spent in the commit of the install transaction (in nanoseconds).
+     */
+    ZyanU64 install_commit;
+    /**
+     * The time spent in the remove calls (in nanoseconds).
+     */
+    ZyanU64 remove;
+    /**
+     * The time spent in the thread update of the remove transaction (in nanoseconds).
+     */
+    ZyanU64 remove_update;
+    /**
+     * The time spent in the commit of the remove transaction (in nanoseconds).
+     */
+    ZyanU64 remove_commit;
+    /**
+     * The amount of trampoline memory committed while the hooks were installed (in bytes).
+     */
+    ZyanUSize committed_bytes;
+    /**
+     * The amount of trampoline memory reserved while the hooks were installed (in bytes).
+     */
+    ZyanUSize reserved_bytes;
+} BenchInstallResult;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * The synthetic target functions.
+ */
+static ZyanU8* g_bench_targets;
+
+/**
+ * Receives the trampolines of the installed hooks.
+ */
+static ZyanConstVoidPointer g_bench_originals[BENCH_MAX_TARGETS];
+
+/**
+ * The trampoline that is invoked by the pass-through callbacks.
+ */
+static BenchFunction volatile g_bench_original;
+
+/**
+ * Signals the running threads to exit.
+ */
+static volatile ZyanBool g_bench_stop;
+
+/* ============================================================================================== */
+/* Helper functions                                                                               */
+/* ============================================================================================== */
+
+/**
+ * Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return  A monotonic timestamp in nanoseconds.
+ */
+static ZyanU64 BenchGetTimestamp(void)
+{
+#if defined(ZYAN_WINDOWS)
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (ZyanU64)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ZyanU64)ts.tv_sec * 1000000000ULL + (ZyanU64)ts.tv_nsec;
+#endif
+}
+
+/**
+ * Generates the synthetic target functions.
+ *
+ * @return  `ZYAN_TRUE`, if the target functions have been generated, `ZYAN_FALSE` if not.
+ *
+ * Every target function consists of a `mov eax, imm32` that loads its index, followed by a `ret`.
+ * The functions are aligned to `BENCH_TARGET_SIZE` bytes, which allows the hook jumps to be
+ * written atomically.
+ */
+static ZyanBool BenchCreateTargets(void)
+{
+    const ZyanUSize size = BENCH_MAX_TARGETS * BENCH_TARGET_SIZE;
+
+#if defined(ZYAN_WINDOWS)
+    g_bench_targets = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!g_bench_targets)
+    {
+        return ZYAN_FALSE;
+    }
+#else
+    void* const memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+        -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return ZYAN_FALSE;
+    }
+    g_bench_targets = memory;
+#endif
+
+    memset(g_bench_targets, 0xCC, size);
+    for (ZyanU32 i = 0; i < BENCH_MAX_TARGETS; ++i)
+    {
+        ZyanU8* const target = &g_bench_targets[i * BENCH_TARGET_SIZE];
+        // mov eax, imm32
+        target[0] = 0xB8;
+        memcpy(&target[1], &i, sizeof(i));
+        // ret
+        target[5] = 0xC3;
+    }
+
+#if defined(ZYAN_WINDOWS)
+    DWORD old_protection;
+    if (!VirtualProtect(g_bench_targets, size, PAGE_EXECUTE_READ, &old_protection))
+    {
+        return ZYAN_FALSE;
+    }
+    FlushInstructionCache(GetCurrentProcess(), g_bench_targets, size);
+#else
+    if (mprotect(g_bench_targets, size, PROT_READ | PROT_EXEC))
+    {
+        return ZYAN_FALSE;
+    }
+#endif
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * Returns the synthetic target function with the given `index`.
+ *
+ * @param   index   The index of the target function.
+ *
+ * @return  The synthetic target function.
+ */
+static BenchFunction BenchGetTarget(ZyanU32 index)
+{
+    return (BenchFunction)(ZyanUPointer)&g_bench_targets[index * BENCH_TARGET_SIZE];
+}
+
+/* ============================================================================================== */
+/* Callbacks                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * The callback used for the install measurements.
+ *
+ * @return  An arbitrary value.
+ */
+static ZyanU32 ZYAN_NOINLINE BenchCallbackReturn(void)
+{
+    return 0;
+}
+
+/**
+ * A pass-through callback that invokes the trampoline.
+ *
+ * @return  The return value of the original function plus one.
+ */
+static ZyanU32 ZYAN_NOINLINE BenchCallbackPassThrough(void)
+{
+    return (*g_bench_original)() + 1;
+}
+
+/**
+ * A pass-through callback that invokes the trampoline inside the barrier.
+ *
+ * @return  The return value of the original function plus one.
+ */
+static ZyanU32 ZYAN_NOINLINE BenchCallbackBarrier(void)
+{
+    const BenchFunction original = g_bench_original;
+    const ZyrexBarrierHandle handle = ZyrexBarrierGetHandle((const void*)(ZyanUPointer)original);
+    if (ZyrexBarrierTryEnter(handle) != ZYAN_STATUS_TRUE)
+    {
+        return (*original)();
+    }
+
+    const ZyanU32 result = (*original)() + 1;
+    ZyrexBarrierLeave(handle);
+
+    return result;
+}
+
+/* ============================================================================================== */
+/* Running threads                                                                                */
+/* ============================================================================================== */
+
+/**
+ * The running thread, which keeps a core busy until `g_bench_stop` is set.
+ */
+static void BenchRunningThread(void)
+{
+    volatile ZyanU64 counter = 0;
+    while (!g_bench_stop)
+    {
+        ++counter;
+    }
+}
+
+#if defined(ZYAN_WINDOWS)
+static DWORD WINAPI BenchThreadProc(LPVOID parameter)
+{
+    ZYAN_UNUSED(parameter);
+    BenchRunningThread();
+    return 0;
+}
+#else
+static void* BenchThreadProc(void* parameter)
+{
+    ZYAN_UNUSED(parameter);
+    BenchRunningThread();
+    return NULL;
+}
+#endif
+
+/* ============================================================================================== */
+/* Install benchmark                                                                              */
+/* ============================================================================================== */
+
+/**
+ * Installs or removes the hooks for the given number of target functions in a single
+ * transaction.
+ *
+ * @param   count   The number of target functions.
+ * @param   install `ZYAN_TRUE` to install the hooks or `ZYAN_FALSE` to remove them.
+ * @param   calls   Receives the time spent in the install or remove calls.
+ * @param   update  Receives the time spent in the thread update.
+ * @param   commit  Receives the time spent in the commit.
+ * @param   info    Receives the memory info after the operations have been added to the
+ *                  transaction, or `ZYAN_NULL`.
+ *
+ * @return  `ZYAN_TRUE`, if the transaction succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchTransaction(ZyanU32 count, ZyanBool install, ZyanU64* calls,
+    ZyanU64* update, ZyanU64* commit, ZyrexMemoryInfo* info)
+{
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZyanU64 timestamp = BenchGetTimestamp();
+    for (ZyanU32 i = 0; i < count; ++i)
+    {
+        const ZyanStatus status = install
+            ? ZyrexInstallInlineHook((void*)(ZyanUPointer)BenchGetTarget(i),
+                (const void*)(ZyanUPointer)&BenchCallbackReturn, &g_bench_originals[i])
+            : ZyrexRemoveInlineHook(&g_bench_originals[i]);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexTransactionAbort();
+            return ZYAN_FALSE;
+        }
+    }
+    *calls = BenchGetTimestamp() - timestamp;
+
+    // The trampolines are allocated by the install calls
+    if (info && !ZYAN_SUCCESS(ZyrexGetMemoryInfo(info)))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+
+    timestamp = BenchGetTimestamp();
+    if (!ZYAN_SUCCESS(ZyrexUpdateAllThreads()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+    *update = BenchGetTimestamp() - timestamp;
+
+    timestamp = BenchGetTimestamp();
+    const void* failed_operation = ZYAN_NULL;
+    const ZyanStatus status = ZyrexTransactionCommitEx(&failed_operation);
+    *commit = BenchGetTimestamp() - timestamp;
+
+    return ZYAN_SUCCESS(status);
+}
+
+/**
+ * Installs and removes the hooks for the given number of target functions.
+ *
+ * @param   count   The number of target functions.
+ * @param   result  Receives the fastest timings of all repetitions.
+ *
+ * @return  `ZYAN_TRUE`, if the benchmark succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchInstall(ZyanU32 count, BenchInstallResult* result)
+{
+    memset(result, 0xFF, sizeof(*result));
+
+    for (ZyanU32 i = 0; i < BENCH_REPETITIONS; ++i)
+    {
+        BenchInstallResult current;
+        ZyrexMemoryInfo info;
+
+        if (!BenchTransaction(count, ZYAN_TRUE, &current.install, &current.install_update,
+            &current.install_commit, &info))
+        {
+            return ZYAN_FALSE;
+        }
+        current.committed_bytes = info.committed_bytes;
+        current.reserved_bytes = info.reserved_bytes;
+
+        // The hooks must be removed in any case to restore the target functions
+        if (!BenchTransaction(count, ZYAN_FALSE, &current.remove, &current.remove_update,
+            &current.remove_commit, ZYAN_NULL))
+        {
+            return ZYAN_FALSE;
+        }
+
+        // The target functions must execute the original code again
+        for (ZyanU32 j = 0; j < count; ++j)
+        {
+            if ((*BenchGetTarget(j))() != j)
+            {
+                return ZYAN_FALSE;
+            }
+        }
+
+        result->install          = ZYAN_MIN(result->install, current.install);
+        result->install_update   = ZYAN_MIN(result->install_update, current.install_update);
+        result->install_commit   = ZYAN_MIN(result->install_commit, current.install_commit);
+        result->remove           = ZYAN_MIN(result->remove, current.remove);
+        result->remove_update    = ZYAN_MIN(result->remove_update, current.remove_update);
+        result->remove_commit    = ZYAN_MIN(result->remove_commit, current.remove_commit);
+        result->committed_bytes  = ZYAN_MIN(result->committed_bytes, current.committed_bytes);
+        result->reserved_bytes   = ZYAN_MIN(result->reserved_bytes, current.reserved_bytes);
+    }
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * Runs the install benchmark for the given number of target functions and running threads and
+ * prints the result.
+ *
+ * @param   count           The number of target functions.
+ * @param   thread_count    The number of running threads.
+ *
+ * @return  `ZYAN_TRUE`, if the benchmark succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchRunInstall(ZyanU32 count, ZyanU32 thread_count)
+{
+#if defined(ZYAN_WINDOWS)
+    HANDLE threads[BENCH_MAX_THREADS];
+#else
+    pthread_t threads[BENCH_MAX_THREADS];
+#endif
+
+    g_bench_stop = ZYAN_FALSE;
+    ZyanU32 started = 0;
+    for (; started < thread_count; ++started)
+    {
+#if defined(ZYAN_WINDOWS)
+        threads[started] = CreateThread(NULL, 0, &BenchThreadProc, NULL, 0, NULL);
+        if (!threads[started])
+        {
+            break;
+        }
+#else
+        if (pthread_create(&threads[started], NULL, &BenchThreadProc, NULL))
+        {
+            break;
+        }
+#endif
+    }
+
+    BenchInstallResult result;
+    const ZyanBool is_valid = (started == thread_count) && BenchInstall(count, &result);
+
+    // The threads that have already been started are stopped in any case, to not distort the
+    // following configurations
+    g_bench_stop = ZYAN_TRUE;
+    for (ZyanU32 i = 0; i < started; ++i)
+    {
+#if defined(ZYAN_WINDOWS)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    if (!is_valid)
+    {
+        printf("%u,%u,,,,,,,,,invalid\n", count, thread_count);
+        fflush(stdout);
+        return ZYAN_FALSE;
+    }
+
+    // Threads are frozen from the thread update until the end of the commit
+    printf("%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,ok\n",
+        count,
+        thread_count,
+        (double)result.install / count,
+        (double)(result.install_update + result.install_commit) / 1000.0,
+        (double)result.remove / count,
+        (double)(result.remove_update + result.remove_commit) / 1000.0,
+        (double)result.install_commit / 1000.0,
+        (double)result.remove_commit / 1000.0,
+        (double)result.committed_bytes / count,
+        (double)result.reserved_bytes / count);
+    fflush(stdout);
+
+    return ZYAN_TRUE;
+}
+
+/* ============================================================================================== */
+/* Call overhead benchmark                                                                        */
+/* ============================================================================================== */
+
+/**
+ * Measures the time of a call to the given `function`.
+ *
+ * @param   function    The function to call.
+ * @param   expected    The expected return value.
+ * @param   ns_per_call Receives the fastest time per call of all repetitions (in nanoseconds).
+ *
+ * @return  `ZYAN_TRUE`, if the function returned the expected value, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchMeasureCalls(BenchFunction function, ZyanU32 expected, double* ns_per_call)
+{
+    BenchFunction volatile target = function;
+    ZyanU64 best = (ZyanU64)-1;
+    ZyanBool is_valid = ZYAN_TRUE;
+
+    // Warm up
+    is_valid &= ((*target)() == expected);
+
+    for (ZyanU32 i = 0; i < BENCH_REPETITIONS; ++i)
+    {
+        ZyanU32 sum = 0;
+        const ZyanU64 start = BenchGetTimestamp();
+        for (ZyanU32 j = 0; j < BENCH_CALL_COUNT; ++j)
+        {
+            sum += (*target)();
+        }
+        const ZyanU64 elapsed = BenchGetTimestamp() - start;
+
+        is_valid &= (sum == (ZyanU32)(expected * (ZyanU64)BENCH_CALL_COUNT));
+        best = ZYAN_MIN(best, elapsed);
+    }
+
+    *ns_per_call = (double)best / BENCH_CALL_COUNT;
+    return is_valid;
+}
+
+/**
+ * Prints a single call overhead result.
+ *
+ * @param   variant     The name of the measured variant.
+ * @param   ns_per_call The time per call (in nanoseconds).
+ * @param   baseline    The time per call of the original function (in nanoseconds).
+ * @param   is_valid    Signals, if the measurement returned the expected results.
+ */
+static void BenchPrintCalls(const char* variant, double ns_per_call, double baseline,
+    ZyanBool is_valid)
+{
+    printf("%s,%llu,%.3f,%.3f,%s\n",
+        variant,
+        (unsigned long long)BENCH_CALL_COUNT,
+        ns_per_call,
+        ns_per_call - baseline,
+        is_valid ? "ok" : "invalid");
+    fflush(stdout);
+}
+
+/**
+ * Runs the call overhead benchmark for the given callback and prints the results.
+ *
+ * @param   variant     The name of the measured variant.
+ * @param   callback    The callback function.
+ * @param   baseline    The time per call of the original function (in nanoseconds).
+ *
+ * @return  `ZYAN_TRUE`, if the benchmark succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchRunCallback(const char* variant, BenchFunction callback, double baseline)
+{
+    const ZyanU32 index = 1;
+    const BenchFunction target = BenchGetTarget(index);
+
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()) ||
+        !ZYAN_SUCCESS(ZyrexInstallInlineHook((void*)(ZyanUPointer)target,
+            (const void*)(ZyanUPointer)callback, &g_bench_originals[index])) ||
+        !ZYAN_SUCCESS(ZyrexUpdateAllThreads()) ||
+        !ZYAN_SUCCESS(ZyrexTransactionCommit()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+    g_bench_original = (BenchFunction)(ZyanUPointer)g_bench_originals[index];
+
+    double ns_per_call;
+    const ZyanBool is_valid = BenchMeasureCalls(target, index + 1, &ns_per_call);
+    BenchPrintCalls(variant, ns_per_call, baseline, is_valid);
+
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()) ||
+        !ZYAN_SUCCESS(ZyrexRemoveInlineHook(&g_bench_originals[index])) ||
+        !ZYAN_SUCCESS(ZyrexUpdateAllThreads()) ||
+        !ZYAN_SUCCESS(ZyrexTransactionCommit()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+
+    return is_valid;
+}
+
+/**
+ * Runs the call overhead benchmark.
+ *
+ * @return  `ZYAN_TRUE`, if the benchmark succeeded, `ZYAN_FALSE` if not.
+ */
+static ZyanBool BenchRunCalls(void)
+{
+    const ZyanU32 index = 1;
+    const BenchFunction target = BenchGetTarget(index);
+
+    double baseline;
+    ZyanBool is_valid = BenchMeasureCalls(target, index, &baseline);
+    BenchPrintCalls("original", baseline, baseline, is_valid);
+
+    // The trampoline is measured while the hook is installed
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()) ||
+        !ZYAN_SUCCESS(ZyrexInstallInlineHook((void*)(ZyanUPointer)target,
+            (const void*)(ZyanUPointer)&BenchCallbackReturn, &g_bench_originals[index])) ||
+        !ZYAN_SUCCESS(ZyrexUpdateAllThreads()) ||
+        !ZYAN_SUCCESS(ZyrexTransactionCommit()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+
+    double ns_per_call;
+    const ZyanBool is_trampoline_valid = BenchMeasureCalls(
+        (BenchFunction)(ZyanUPointer)g_bench_originals[index], index, &ns_per_call);
+    BenchPrintCalls("trampoline", ns_per_call, baseline, is_trampoline_valid);
+    is_valid &= is_trampoline_valid;
+
+    if (!ZYAN_SUCCESS(ZyrexTransactionBegin()) ||
+        !ZYAN_SUCCESS(ZyrexRemoveInlineHook(&g_bench_originals[index])) ||
+        !ZYAN_SUCCESS(ZyrexUpdateAllThreads()) ||
+        !ZYAN_SUCCESS(ZyrexTransactionCommit()))
+    {
+        ZyrexTransactionAbort();
+        return ZYAN_FALSE;
+    }
+
+    is_valid &= BenchRunCallback("hooked", &BenchCallbackPassThrough, baseline);
+    is_valid &= BenchRunCallback("hooked_barrier", &BenchCallbackBarrier, baseline);
+
+    return is_valid;
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+int main(int argc, char** argv)
+{
+    static const ZyanU32 target_counts[] = { 1, 10, 100, 1000, 10000 };
+    static const ZyanU32 thread_counts[] = { 0, 1, 2, 4, 8, 16 };
+
+    ZyanU32 max_threads = 4;
+    if (argc > 1)
+    {
+        max_threads = (ZyanU32)strtoul(argv[1], NULL, 10);
+        if (max_threads > BENCH_MAX_THREADS)
+        {
+            fprintf(stderr, "Usage: %s [max_threads (0..%d)]\n", argv[0], BENCH_MAX_THREADS);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!ZYAN_SUCCESS(ZyrexInitialize()) || !ZYAN_SUCCESS(ZyrexBarrierSystemInitialize()))
+    {
+        fputs("Failed to initialize Zyrex\n", stderr);
+        return EXIT_FAILURE;
+    }
+    if (!BenchCreateTargets())
+    {
+        fputs("Failed to create the target functions\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    ZyanBool is_valid = ZYAN_TRUE;
+
+    puts("targets,threads,install_ns_per_hook,install_frozen_us,remove_ns_per_hook,"
+        "remove_frozen_us,install_commit_us,remove_commit_us,committed_bytes_per_hook,"
+        "reserved_bytes_per_hook,status");
+    for (ZyanUSize t = 0; t < ZYAN_ARRAY_LENGTH(thread_counts); ++t)
+    {
+        if (thread_counts[t] > max_threads)
+        {
+            break;
+        }
+        for (ZyanUSize n = 0; n < ZYAN_ARRAY_LENGTH(target_counts); ++n)
+        {
+            is_valid &= BenchRunInstall(target_counts[n], thread_counts[t]);
+        }
+    }
+
+    puts("");
+    puts("variant,calls,ns_per_call,ns_overhead,status");
+    is_valid &= BenchRunCalls();
+
+    ZyrexBarrierSystemShutdown();
+    ZyrexShutdown();
+
+    return is_valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ============================================================================================== */
@@ -29,11 +29,41 @@
 
 #include <ZyrexExportConfig.h>
 #include <Zycore/Status.h>
+#include <Zycore/API/Thread.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * Defines the number of dense barrier handles.
+ *
+ * Barrier handles lower than this value are dense indices, which are assigned to each trampoline
+ * by the trampoline allocator. The recursion depth for these handles is stored in a flat
+ * per-thread array. All other handle values are treated as opaque keys.
+ *
+ * Every thread that enters a barrier holds 4 bytes per dense handle (8 bytes, if
+ * `ZYREX_HOOK_STATISTICS` is enabled) and about 2 KiB for the table of other handles. With the
+ * default value this amounts to 6 KiB (10 KiB) per thread, which is reserved in the static TLS
+ * block of every thread, if `ZYREX_BARRIER_STATIC_TLS` is enabled. The value can be changed with
+ * the `ZYREX_BARRIER_DENSE_HANDLE_COUNT` CMake option and has to be a multiple of 32. It also
+ * limits the number of trampolines that support per-thread masks and statistics.
+ */
+#ifndef ZYREX_BARRIER_DENSE_HANDLE_COUNT
+#   define ZYREX_BARRIER_DENSE_HANDLE_COUNT 1024
+#endif
+
+/**
+ * Defines the number of records in the per-thread trace ring.
+ *
+ * Must be a power of two. Records are dropped, if the ring of a thread is full.
+ */
+#define ZYREX_BARRIER_TRACE_RING_SIZE       4096
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
@@ -47,6 +77,83 @@ extern "C" {
  */
 typedef ZyanUPointer ZyrexBarrierHandle;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Tracing                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Defines the `ZyrexBarrierTraceEvent` enum.
+ */
+typedef enum ZyrexBarrierTraceEvent_
+{
+    /**
+     * The barrier has been entered.
+     */
+    ZYREX_BARRIER_TRACE_EVENT_ENTER,
+    /**
+     * The barrier has been left.
+     */
+    ZYREX_BARRIER_TRACE_EVENT_LEAVE
+} ZyrexBarrierTraceEvent;
+
+/**
+ * Defines the `ZyrexBarrierTraceRecord` struct.
+ */
+typedef struct ZyrexBarrierTraceRecord_
+{
+    /**
+     * The value of the timestamp-counter at the time of the event.
+     */
+    ZyanU64 timestamp;
+    /**
+     * The barrier hook handle.
+     */
+    ZyrexBarrierHandle handle;
+    /**
+     * The recursion depth inside the barrier.
+     *
+     * The enter and leave records of the same invocation have the same depth.
+     */
+    ZyanU32 depth;
+    /**
+     * The event type.
+     */
+    ZyrexBarrierTraceEvent event;
+} ZyrexBarrierTraceRecord;
+
+/**
+ * Defines the `ZyrexBarrierTraceBatch` struct.
+ */
+typedef struct ZyrexBarrierTraceBatch_
+{
+    /**
+     * The id of the thread that produced the records.
+     */
+    ZyanThreadId thread_id;
+    /**
+     * The trace records in chronological order.
+     */
+    const ZyrexBarrierTraceRecord* records;
+    /**
+     * The number of records.
+     */
+    ZyanUSize count;
+    /**
+     * The total number of records of the thread that have been dropped so far, because its ring
+     * was full.
+     */
+    ZyanU64 dropped;
+} ZyrexBarrierTraceBatch;
+
+/**
+ * Defines the `ZyrexBarrierTraceCallback` function prototype.
+ *
+ * @param   batch   A pointer to the `ZyrexBarrierTraceBatch` struct. The records are only valid
+ *                  until the callback returns.
+ * @param   context The user-defined context passed to `ZyrexBarrierTraceDrain`.
+ */
+typedef void (*ZyrexBarrierTraceCallback)(const ZyrexBarrierTraceBatch* batch, void* context);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -132,6 +239,16 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierSystemShutdown(void);
  *
  * The returned handle should be saved and then used for all subsequent calls to the barrier API
  * inside the current hook callback.
+ *
+ * If the `trampoline` belongs to a trampoline chunk, the dense index of that chunk is returned.
+ * Otherwise the `trampoline` pointer itself is used as the handle value. The trampoline chunk is
+ * resolved without taking any locks or calling into other functions, so that hooked threads never
+ * serialize on this function and callbacks of hooks on synchronization primitives can not recurse
+ * into it.
+ *
+ * Dense indices are reused once a hook got removed. A handle is only valid as long as the hook
+ * it was obtained for is installed and must not be kept across hook removals. Any state that was
+ * left behind in the current thread by a previous owner of the index is reset by this function.
  */
 ZYREX_EXPORT ZyrexBarrierHandle ZyrexBarrierGetHandle(const void* trampoline);
 
@@ -157,7 +274,7 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle);
  *          generic zyan status code if an error occured.
  *
  * This function passes the barrier, if the `current_recursion_depth` is less than or equal to
- * the given `max_recursion_depth`.
+ * the given `max_recursion_depth`. The recursion depth of dense handles is limited to `65535`.
  */
 ZYREX_EXPORT ZyanStatus ZyrexBarrierTryEnterEx(ZyrexBarrierHandle handle,
     ZyanU32 max_recursion_depth);
@@ -188,6 +305,32 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle);
 ZYREX_EXPORT ZyanStatus ZyrexBarrierGetRecursionDepth(ZyrexBarrierHandle handle,
     ZyanU32* current_depth);
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Tracing                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Drains the trace rings of all threads.
+ *
+ * @param   callback    The callback that is invoked for every batch of trace records.
+ * @param   context     A user-defined context that is passed to the `callback`.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if the library was built without
+ *          `ZYREX_BARRIER_TRACE` or another thread is already draining the rings, or another zyan
+ *          status code.
+ *
+ * If the library was built with `ZYREX_BARRIER_TRACE`, every successful barrier enter and every
+ * barrier leave appends a record to the single-producer ring of the calling thread. The ring is
+ * allocated once per thread, when the thread enters its first barrier.
+ *
+ * This function is meant to be periodically called by a single background thread. The records of
+ * each thread are passed to the `callback` in at most two batches per call. The rings of threads
+ * that exited are released after they were drained completely. Tracing requires the thread exit
+ * notification of dynamic TLS and can not be combined with `ZYREX_BARRIER_STATIC_TLS`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexBarrierTraceDrain(ZyrexBarrierTraceCallback callback,
+    void* context);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -0,0 +1,238 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_HOOK_QUEUE_H
+#define ZYREX_HOOK_QUEUE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <ZyrexExportConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook request type                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexHookRequestType` enum.
+ */
+typedef enum ZyrexHookRequestType_
+{
+    /**
+     * @brief   Installs an inline hook (see `ZyrexInstallInlineHook`).
+     *
+     * Requires `address`, `callback` and `trampoline`.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE,
+    /**
+     * @brief   Removes an inline hook (see `ZyrexRemoveInlineHook`).
+     *
+     * Requires `trampoline`.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE,
+    /**
+     * @brief   Adds a callback to a chained inline hook (see `ZyrexInstallInlineHookChained`).
+     *
+     * Requires `address`, `callback` and `trampoline`, which receives the next function in the
+     * chain.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE_CHAINED,
+    /**
+     * @brief   Removes a callback from a chained inline hook (see
+     *          `ZyrexRemoveInlineHookChained`).
+     *
+     * Requires `trampoline`.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE_CHAINED,
+    /**
+     * @brief   Installs an import table hook (see `ZyrexInstallImportHook`).
+     *
+     * Requires `address`, `callback` and `trampoline`, which receives the original function.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_INSTALL_IMPORT,
+    /**
+     * @brief   Removes an import table hook (see `ZyrexRemoveImportHook`).
+     *
+     * Requires `address`.
+     */
+    ZYREX_HOOK_REQUEST_TYPE_REMOVE_IMPORT
+} ZyrexHookRequestType;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook request                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+typedef struct ZyrexHookRequest_ ZyrexHookRequest;
+
+/**
+ * @brief   Defines the `ZyrexHookRequestCompletion` function prototype.
+ *
+ * @param   request A pointer to the completed `ZyrexHookRequest` struct.
+ *
+ * The function is called by the thread that committed the request, after the transaction has
+ * been committed. It must not submit or wait for other requests.
+ */
+typedef void (*ZyrexHookRequestCompletion)(ZyrexHookRequest* request);
+
+/**
+ * @brief   Defines the `ZyrexHookRequest` struct.
+ *
+ * The memory of the request is owned by the caller and has to stay valid until the request has
+ * been completed.
+ */
+struct ZyrexHookRequest_
+{
+    /**
+     * @brief   The request type.
+     */
+    ZyrexHookRequestType type;
+    /**
+     * @brief   The address of the function to hook.
+     */
+    void* address;
+    /**
+     * @brief   The callback address.
+     */
+    const void* callback;
+    /**
+     * @brief   The pointer argument of the hook function that corresponds to the request `type`.
+     *
+     * The memory is written when the request is processed, but the written value does not point
+     * to a live hook before the request has been completed.
+     */
+    ZyanConstVoidPointer* trampoline;
+    /**
+     * @brief   An optional function that is called when the request has been completed.
+     */
+    ZyrexHookRequestCompletion completion;
+    /**
+     * @brief   User-defined data.
+     */
+    void* user_data;
+    /**
+     * @brief   Receives the status code of the request.
+     *
+     * A request that succeeded on its own receives the status code of the commit. A request that
+     * failed does not prevent the other requests of its batch from being committed.
+     */
+    ZyanStatus status;
+    /**
+     * @brief   Signals, if the request has been completed (private).
+     */
+    volatile ZyanBool is_completed;
+    /**
+     * @brief   The next request in the queue (private).
+     */
+    ZyrexHookRequest* next;
+};
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * @brief   Adds the given hook `request` to the submission queue.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is lock-free and can be called from any number of threads at the same time. The
+ * request is not processed before `ZyrexHookQueueCommit` or `ZyrexHookQueueWait` is called.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexHookQueueSubmit(ZyrexHookRequest* request);
+
+/**
+ * @brief   Sets the flags that are used to start the transaction of each committed batch.
+ *
+ * @param   flags   A combination of `ZyrexTransactionFlags` values. Defaults to
+ *                  `ZYREX_TRANSACTION_FLAG_NONE`.
+ *
+ * @return  A zyan status code.
+ *
+ * By default, all threads are suspended and migrated while a batch is committed, which is safe
+ * for every hook. `ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES` avoids the suspension for batches that
+ * only contain operations that can be written atomically, at the cost of the restrictions
+ * documented for this flag. The new flags are used by all batches that are committed afterwards.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexHookQueueSetTransactionFlags(ZyanU32 flags);
+
+/**
+ * @brief   Commits all queued hook requests.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if a transaction is in progress, or another zyan
+ *          status code.
+ *
+ * Only a single thread commits the queue at a time. All requests that are queued at once are
+ * applied to a single transaction, which suspends the threads and makes the patched memory
+ * pages writable only once per batch. The transaction is started with the flags passed to
+ * `ZyrexHookQueueSetTransactionFlags`. If another thread is already committing the queue, this
+ * function returns immediately and the requests are picked up by the other thread.
+ *
+ * If a transaction is in progress, the requests stay queued until the next call.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexHookQueueCommit(void);
+
+/**
+ * @brief   Checks, if the given hook `request` has been completed.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the request has been completed, or `ZYAN_FALSE`, if not.
+ */
+ZYREX_EXPORT ZyanBool ZyrexHookQueueIsCompleted(const ZyrexHookRequest* request);
+
+/**
+ * @brief   Waits until the given hook `request` has been completed.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if the request has not been completed yet and the
+ *          current thread has a transaction in progress, or the status code of the request.
+ *
+ * The queue is committed by the waiting thread, if no other thread is committing it already.
+ * While another thread has a transaction in progress, this function waits until it has been
+ * committed or aborted.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexHookQueueWait(const ZyrexHookRequest* request);
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_HOOK_QUEUE_H */
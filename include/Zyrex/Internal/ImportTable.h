@@ -0,0 +1,117 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_IMPORT_TABLE_H
+#define ZYREX_INTERNAL_IMPORT_TABLE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zycore/Vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexImportSlot` struct.
+ *
+ * Describes a single import or export table entry that refers to a hooked function.
+ */
+typedef struct ZyrexImportSlot_
+{
+    /**
+     * @brief   The address of the table entry.
+     */
+    void* address;
+    /**
+     * @brief   The size of the table entry (`4` for export table entries that contain a module
+     *          relative address or the size of a pointer for import table entries).
+     */
+    ZyanU8 size;
+    /**
+     * @brief   The original value of the table entry.
+     */
+    ZyanUPointer original;
+    /**
+     * @brief   The value that redirects the table entry to the callback.
+     */
+    ZyanUPointer replacement;
+    /**
+     * @brief   The original protection of the memory page that contains the table entry (only
+     *          used on platforms that can not query the page protection).
+     */
+    ZyanU32 protection;
+} ZyrexImportSlot;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Collects all import and export table entries of the loaded modules that refer to the
+ *          given `function`.
+ *
+ * @param   function    The address of the function.
+ * @param   callback    The callback address.
+ * @param   slots       A pointer to an initialized `ZyanVector<ZyrexImportSlot>` instance that
+ *                      receives the table entries.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if import table hooks are not supported on the
+ *          current platform, or another zyan status code.
+ *
+ * Export table entries are skipped, if the `callback` can not be expressed relative to the base
+ * address of the exporting module. On POSIX platforms only resolved `GOT` entries are found (e.g.
+ * entries of lazily bound functions are found after the first call).
+ */
+ZyanStatus ZyrexImportTableCollectSlots(const void* function, const void* callback,
+    ZyanVector* slots);
+
+/**
+ * @brief   Atomically replaces the value of the given table entry, if it still contains the
+ *          `expected` value.
+ *
+ * @param   slot        A pointer to the `ZyrexImportSlot` struct.
+ * @param   expected    The expected current value of the table entry.
+ * @param   desired     The new value of the table entry.
+ *
+ * @return  `ZYAN_TRUE`, if the entry has been replaced or `ZYAN_FALSE`, if not.
+ *
+ * The memory page that contains the table entry has to be writable.
+ */
+ZyanBool ZyrexImportTableExchangeSlot(const ZyrexImportSlot* slot, ZyanUPointer expected,
+    ZyanUPointer desired);
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_IMPORT_TABLE_H */
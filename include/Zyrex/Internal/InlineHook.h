@@ -56,6 +56,33 @@ typedef enum ZyrexThreadMigrationDirection_
     ZYREX_THREAD_MIGRATION_DIRECTION_DST_SRC,
 } ZyrexThreadMigrationDirection;
 
+/**
+ * @brief   Defines the `ZyrexThreadMigrationRange` struct.
+ */
+typedef struct ZyrexThreadMigrationRange_
+{
+    /**
+     * @brief   The start address of the code range to migrate threads away from.
+     */
+    ZyanUPointer source;
+    /**
+     * @brief   The length of the source code range.
+     */
+    ZyanUSize source_length;
+    /**
+     * @brief   The start address of the code range to migrate threads to.
+     */
+    ZyanUPointer destination;
+    /**
+     * @brief   The instruction translation map.
+     */
+    const ZyrexInstructionTranslationMap* translation_map;
+    /**
+     * @brief   The migration direction.
+     */
+    ZyrexThreadMigrationDirection direction;
+} ZyrexThreadMigrationRange;
+
 /* ============================================================================================== */
 /* Functions                                                                                      */
 /* ============================================================================================== */
@@ -64,12 +91,40 @@ typedef enum ZyrexThreadMigrationDirection_
 /* Attaching and detaching                                                                        */
 /* ---------------------------------------------------------------------------------------------- */
 
+/**
+ * @brief   Translates the given instruction pointer, if it is located inside one of the given
+ *          migration ranges.
+ *
+ * @param   ranges  A pointer to an array of `ZyrexThreadMigrationRange` items, sorted by their
+ *                  source address. The ranges must not overlap.
+ * @param   count   The number of items in the `ranges` array.
+ * @param   ip      The instruction pointer. Receives the translated instruction pointer.
+ *
+ * @return  `ZYAN_TRUE` if the instruction pointer has been changed, `ZYAN_FALSE` if not.
+ *
+ * The matching range is located by binary search.
+ */
+ZyanBool ZyrexMigrateInstructionPointer(const ZyrexThreadMigrationRange* ranges, ZyanUSize count,
+    ZyanUPointer* ip);
+
 #ifdef ZYAN_WINDOWS
 
-ZyanStatus ZyrexMigrateThread(HANDLE thread_handle, const void* source, ZyanUSize source_length,
-    const void* destination, ZyanUSize destination_length,
-    const ZyrexInstructionTranslationMap* translation_map, 
-    ZyrexThreadMigrationDirection direction);
+/**
+ * @brief   Migrates the given thread, if its instruction pointer is located inside one of the
+ *          given migration ranges.
+ *
+ * @param   thread_handle   The handle of an already suspended thread.
+ * @param   ranges          A pointer to an array of `ZyrexThreadMigrationRange` items, sorted by
+ *                          their source address. The ranges must not overlap.
+ * @param   count           The number of items in the `ranges` array.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer of the thread has been migrated,
+ *          `ZYAN_STATUS_FALSE`, if not, or a generic zyan status code, if an error occured.
+ *
+ * The thread context is read once and written at most once.
+ */
+ZyanStatus ZyrexMigrateThread(HANDLE thread_handle, const ZyrexThreadMigrationRange* ranges,
+    ZyanUSize count);
 
 #endif
 
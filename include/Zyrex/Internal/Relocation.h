@@ -28,12 +28,180 @@
 #define ZYREX_INTERNAL_RELOCATION_H
 
 #include <Zycore/Types.h>
+#include <Zydis/Zydis.h>
 #include <Zyrex/Internal/Trampoline.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum amount of instructions that can be analyzed and relocated.
+ *
+ * This value equals the capacity of the instruction translation map.
+ */
+#define ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT \
+    (ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT + ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT_BONUS)
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Analyzed instruction                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexAnalyzedInstruction` struct.
+ */
+typedef struct ZyrexAnalyzedInstruction_
+{
+    /**
+     * @brief   The address of the instruction relative to the start of the source buffer.
+     */
+    ZyanUSize address_offset;
+    /**
+     * @brief   The absolute runtime/memory address of the instruction.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The `ZydisDecodedInstruction` struct of the analyzed instruction.
+     */
+    ZydisDecodedInstruction instruction;
+    /**
+     * @brief   Signals, if the instruction refers to a target address using a relative offset.
+     */
+    ZyanBool has_relative_target;
+    /**
+     * @brief   Signals, if the target address referred by the relative offset is not inside the
+     *          analyzed code chunk.
+     */
+    ZyanBool has_external_target;
+    /**
+     * @brief   Signals, if this instruction is targeted by at least one instruction from inside
+     *          the analyzed code chunk.
+     */
+    ZyanBool is_internal_target;
+    /**
+     * @brief   The absolute target address of the instruction calculated from the relative offset,
+     *          if applicable.
+     */
+    ZyanU64 absolute_target_address;
+    /**
+     * @brief   A bitset that contains the ids of all instructions inside the analyzed code chunk
+     *          that are targeting this instruction using a relative offset.
+     */
+    ZyanU32 incoming;
+    /**
+     * @brief   The id of an instruction inside the analyzed code chunk which is targeted by
+     *          this instruction using a relative offset, or `-1` if not applicable.
+     */
+    ZyanU8 outgoing;
+} ZyrexAnalyzedInstruction;
+
+ZYAN_STATIC_ASSERT(ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT <= 32);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Code analysis                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexCodeAnalysis` struct.
+ */
+typedef struct ZyrexCodeAnalysis_
+{
+    /**
+     * @brief   A pointer to the analyzed buffer.
+     */
+    const void* buffer;
+    /**
+     * @brief   The maximum amount of bytes that can be safely read from the analyzed buffer.
+     */
+    ZyanUSize length;
+    /**
+     * @brief   The minimum number of bytes that were requested to be analyzed.
+     */
+    ZyanUSize bytes_to_analyze;
+    /**
+     * @brief   The exact amount of bytes analyzed.
+     */
+    ZyanUSize bytes_read;
+    /**
+     * @brief   Contains a `ZyrexAnalyzedInstruction` struct for each analyzed instruction.
+     */
+    ZyrexAnalyzedInstruction instructions[ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT];
+    /**
+     * @brief   The number of items in the `instructions` array.
+     */
+    ZyanU8 instruction_count;
+    /**
+     * @brief   Signals, if at least one of the analyzed instructions refers to a target address
+     *          using a relative offset.
+     */
+    ZyanBool has_relative_targets;
+    /**
+     * @brief   The lowest absolute target address of all instructions with relative offsets.
+     */
+    ZyanUPointer address_lo;
+    /**
+     * @brief   The highest absolute target address of all instructions with relative offsets.
+     */
+    ZyanUPointer address_hi;
+} ZyrexCodeAnalysis;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation fixups                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexRelocationFixup` struct.
+ *
+ * A fixup describes a relative offset in the relocated code that points to an absolute target
+ * address outside of the relocated code.
+ */
+typedef struct ZyrexRelocationFixup_
+{
+    /**
+     * @brief   The offset of the relative offset field relative to the beginning of the
+     *          destination buffer.
+     */
+    ZyanU8 offset;
+    /**
+     * @brief   The size of the relative offset field in bytes.
+     */
+    ZyanU8 size;
+    /**
+     * @brief   The offset relative to the beginning of the destination buffer the relative offset
+     *          is based on (usually the end of the instruction).
+     */
+    ZyanU8 base;
+    /**
+     * @brief   The absolute target address.
+     */
+    ZyanUPointer target_address;
+} ZyrexRelocationFixup;
+
+/**
+ * @brief   Defines the `ZyrexRelocationFixups` struct.
+ */
+typedef struct ZyrexRelocationFixups_
+{
+    /**
+     * @brief   The number of items in the `items` array.
+     */
+    ZyanU8 count;
+    /**
+     * @brief   The fixup items.
+     */
+    ZyrexRelocationFixup items[ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT];
+} ZyrexRelocationFixups;
+
+/* ---------------------------------------------------------------------------------------------- */
+
 /* ============================================================================================== */
 /* Functions                                                                                      */
 /* ============================================================================================== */
@@ -43,24 +211,39 @@ extern "C" {
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Copies all instructions from the `source` address to the given `trampoline` chunk
- *          until at least `min_bytes_to_reloc` bytes has been moved.
+ * @brief   Decodes and analyzes the code in the given buffer.
+ *
+ * @param   buffer              A pointer to the buffer that contains the code to analyze.
+ * @param   length              The maximum amount of bytes that can be safely read from the
+ *                              buffer.
+ * @param   bytes_to_analyze    The minimum number of bytes to analyze. More bytes might get
+ *                              accessed on demand to keep individual instructions intact.
+ * @param   analysis            Receives the analysis result.
+ *
+ * @return  A zyan status code.
+ *
+ * Every instruction is decoded exactly once. The result can be used to determine a suitable
+ * location for the trampoline and is consumed by `ZyrexRelocateCode` afterwards.
+ */
+ZyanStatus ZyrexAnalyzeCode(const void* buffer, ZyanUSize length, ZyanUSize bytes_to_analyze,
+    ZyrexCodeAnalysis* analysis);
+
+/**
+ * @brief   Copies all analyzed instructions to the given `trampoline` chunk.
  *
- * @param   source              A pointer to the source buffer.
- * @param   source_length       The maximum amount of bytes that can be safely read from the 
- *                              source buffer.
- * @param   trampoline          A pointer to the destination trampoline chunk.
- * @param   min_bytes_to_reloc  Specifies the minimum amount of bytes that should be relocated.
- *                              This function might copy more bytes on demand to keep individual
- *                              instructions intact.
- * @param   bytes_read          Returns the number of bytes read from the source buffer.
- * @param   bytes_written       Returns the number of bytes written to the destination buffer.
+ * @param   analysis        A pointer to the analysis result of the source code, as returned by
+ *                          `ZyrexAnalyzeCode`.
+ * @param   trampoline      A pointer to the destination trampoline chunk.
+ * @param   fixups          Receives the fixups for all relative offsets in the relocated code
+ *                          that point to targets outside of the relocated code. Can be
+ *                          `ZYAN_NULL`.
+ * @param   bytes_read      Returns the number of bytes read from the source buffer.
+ * @param   bytes_written   Returns the number of bytes written to the destination buffer.
  *
  * @return  A zyan status code.
  */
-ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length, 
-    ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
-    ZyanUSize* bytes_written);
+ZyanStatus ZyrexRelocateCode(const ZyrexCodeAnalysis* analysis, ZyrexTrampolineChunk* trampoline,
+    ZyrexRelocationFixups* fixups, ZyanUSize* bytes_read, ZyanUSize* bytes_written);
 
 /* ---------------------------------------------------------------------------------------------- */
 
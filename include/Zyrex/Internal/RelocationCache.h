@@ -0,0 +1,265 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_RELOCATION_CACHE_H
+#define ZYREX_INTERNAL_RELOCATION_CACHE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zyrex/RelocationCache.h>
+#include <Zyrex/Internal/Relocation.h>
+#include <Zyrex/Internal/Trampoline.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the signature of the relocation cache file (`ZRXC`).
+ */
+#define ZYREX_RELOCATION_CACHE_SIGNATURE    0x4358525A
+
+/**
+ * @brief   Defines the version of the relocation cache file format.
+ *
+ * Must be incremented every time the layout of the file or the relocation output changes.
+ */
+#define ZYREX_RELOCATION_CACHE_VERSION      1
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* File format                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheHeader` struct.
+ *
+ * The header is followed by `entry_count` `ZyrexRelocationCacheEntry` structs, sorted by
+ * `rva` and `bytes_to_analyze`.
+ */
+typedef struct ZyrexRelocationCacheHeader_
+{
+    /**
+     * @brief   The file signature (`ZYREX_RELOCATION_CACHE_SIGNATURE`).
+     */
+    ZyanU32 signature;
+    /**
+     * @brief   The file format version (`ZYREX_RELOCATION_CACHE_VERSION`).
+     */
+    ZyanU16 version;
+    /**
+     * @brief   The address width of the architecture the cache was created for.
+     */
+    ZyanU8 address_width;
+    /**
+     * @brief   Reserved for future use.
+     */
+    ZyanU8 reserved;
+    /**
+     * @brief   The size of a single `ZyrexRelocationCacheEntry` struct.
+     */
+    ZyanU32 entry_size;
+    /**
+     * @brief   The number of entries.
+     */
+    ZyanU32 entry_count;
+    /**
+     * @brief   The user-defined key that identifies the module build.
+     */
+    ZyanU64 module_key;
+} ZyrexRelocationCacheHeader;
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheFixup` struct.
+ */
+typedef struct ZyrexRelocationCacheFixup_
+{
+    /**
+     * @brief   The target address relative to the address of the hooked function.
+     */
+    ZyanI64 target_offset;
+    /**
+     * @brief   The offset of the 32-bit relative offset field in the relocated code.
+     */
+    ZyanU8 offset;
+    /**
+     * @brief   The offset in the relocated code the relative offset is based on.
+     */
+    ZyanU8 base;
+    /**
+     * @brief   Reserved for future use.
+     */
+    ZyanU8 reserved[6];
+} ZyrexRelocationCacheFixup;
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheTranslation` struct.
+ */
+typedef struct ZyrexRelocationCacheTranslation_
+{
+    /**
+     * @brief   The offset of the instruction in the original code.
+     */
+    ZyanU8 offset_source;
+    /**
+     * @brief   The offset of the instruction in the relocated code.
+     */
+    ZyanU8 offset_destination;
+} ZyrexRelocationCacheTranslation;
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheEntry` struct.
+ *
+ * Contains the relocated code of a single function in a position independent form.
+ */
+typedef struct ZyrexRelocationCacheEntry_
+{
+    /**
+     * @brief   The address of the hooked function relative to the module base.
+     */
+    ZyanU32 rva;
+    /**
+     * @brief   The minimum number of bytes that were requested to be relocated.
+     */
+    ZyanU8 bytes_to_analyze;
+    /**
+     * @brief   The number of bytes in the `original_code` buffer.
+     */
+    ZyanU8 original_code_size;
+    /**
+     * @brief   The number of bytes in the `code` buffer.
+     */
+    ZyanU8 code_size;
+    /**
+     * @brief   The number of items in the `translations` array.
+     */
+    ZyanU8 translation_count;
+    /**
+     * @brief   The number of items in the `fixups` array.
+     */
+    ZyanU8 fixup_count;
+    /**
+     * @brief   Reserved for future use.
+     */
+    ZyanU8 reserved[7];
+    /**
+     * @brief   The fixups that have to be applied to the relocated code.
+     */
+    ZyrexRelocationCacheFixup fixups[ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT];
+    /**
+     * @brief   The instruction translation items.
+     */
+    ZyrexRelocationCacheTranslation translations[ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT];
+    /**
+     * @brief   The original instruction bytes, used to verify that the function did not change.
+     */
+    ZyanU8 original_code[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
+    /**
+     * @brief   The relocated code before fixups were applied.
+     */
+    ZyanU8 code[ZYREX_TRAMPOLINE_MAX_CODE_SIZE + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS];
+} ZyrexRelocationCacheEntry;
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Searches the opened relocation caches for an entry of the given function.
+ *
+ * @param   address             The address of the function.
+ * @param   length              The maximum amount of bytes that can be safely read from the
+ *                              function.
+ * @param   bytes_to_analyze    The minimum number of bytes to relocate.
+ * @param   entry               Receives a copy of the cache entry, if found.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if a matching entry was found, `ZYAN_STATUS_FALSE` if not or
+ *          another zyan status code if an error occured.
+ *
+ * An entry only matches, if the original instruction bytes are still the same.
+ */
+ZyanStatus ZyrexRelocationCacheLookup(const void* address, ZyanUSize length,
+    ZyanUSize bytes_to_analyze, ZyrexRelocationCacheEntry* entry);
+
+/**
+ * @brief   Returns the address range of all external targets of the relocated code.
+ *
+ * @param   entry   A pointer to the `ZyrexRelocationCacheEntry` struct.
+ * @param   address The address of the function.
+ * @param   lo      Receives the lowest target address or `address`, if it is lower.
+ * @param   hi      Receives the highest target address or `address`, if it is higher.
+ */
+void ZyrexRelocationCacheGetTargetRange(const ZyrexRelocationCacheEntry* entry,
+    const void* address, ZyanUPointer* lo, ZyanUPointer* hi);
+
+/**
+ * @brief   Copies the relocated code of the given cache entry to the `trampoline` chunk and
+ *          rebases all relative offsets.
+ *
+ * @param   entry           A pointer to the `ZyrexRelocationCacheEntry` struct.
+ * @param   address         The address of the function.
+ * @param   trampoline      A pointer to the destination trampoline chunk.
+ * @param   bytes_read      Returns the number of original bytes covered by the relocated code.
+ * @param   bytes_written   Returns the number of bytes written to the destination buffer.
+ *
+ * @return  `ZYAN_STATUS_OUT_OF_RANGE`, if a target is not reachable from the trampoline, or
+ *          another zyan status code.
+ */
+ZyanStatus ZyrexRelocationCacheApply(const ZyrexRelocationCacheEntry* entry, const void* address,
+    ZyrexTrampolineChunk* trampoline, ZyanUSize* bytes_read, ZyanUSize* bytes_written);
+
+/**
+ * @brief   Adds the relocated code of the given `trampoline` to the relocation cache of the
+ *          module that contains the function.
+ *
+ * @param   analysis    A pointer to the analysis result of the original function code.
+ * @param   trampoline  A pointer to the trampoline chunk that contains the relocated code.
+ * @param   fixups      A pointer to the fixups of the relocated code.
+ *
+ * @return  A zyan status code.
+ *
+ * This function does nothing, if no relocation cache is opened for the module or the relocated
+ * code cannot be rebased (e.g. due to 8-bit relative offsets).
+ */
+ZyanStatus ZyrexRelocationCacheInsert(const ZyrexCodeAnalysis* analysis,
+    const ZyrexTrampolineChunk* trampoline, const ZyrexRelocationFixups* fixups);
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_RELOCATION_CACHE_H */
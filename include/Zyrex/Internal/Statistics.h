@@ -0,0 +1,203 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_STATISTICS_H
+#define ZYREX_INTERNAL_STATISTICS_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/Zyrex.h>
+
+#if defined(ZYAN_MSVC)
+#   include <intrin.h>
+#else
+#   include <x86intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ZYREX_HOOK_STATISTICS
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum number of instrumented trampolines.
+ *
+ * Statistics are stored for all trampolines with a dense index lower than this value. This
+ * matches the number of dense barrier handles, which allows the barrier to record latency
+ * samples without any additional lookup.
+ */
+#define ZYREX_HOOK_STATISTICS_MAX_ENTRIES   ZYREX_BARRIER_DENSE_HANDLE_COUNT
+
+/**
+ * @brief   Defines the latency sample rate.
+ *
+ * One out of this many outermost barrier-protected callback invocations of each thread is
+ * sampled. Must be a power of two.
+ */
+#define ZYREX_HOOK_STATISTICS_SAMPLE_RATE   16
+
+/**
+ * @brief   Defines the number of call counter shards of each instrumented trampoline.
+ *
+ * The callback stub increments the shard that is selected by the number of the processor it
+ * runs on, which keeps concurrent calls on different processors off each other's cache-lines.
+ * Must be a power of two.
+ */
+#define ZYREX_HOOK_STATISTICS_COUNTER_SHARDS    16
+
+/**
+ * @brief   Defines the binary logarithm of the size of a single call counter shard.
+ *
+ * Every shard occupies a whole cache-line.
+ */
+#define ZYREX_HOOK_STATISTICS_COUNTER_SHIFT     6
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexStatisticsCounter` struct.
+ */
+typedef struct ZyrexStatisticsCounter_
+{
+    /**
+     * @brief   The number of calls redirected to the hook callback on the processors that are
+     *          mapped to this shard.
+     *
+     * This value is incremented by the callback stub of the trampoline.
+     */
+    volatile ZyanU64 value;
+    /**
+     * @brief   Pads the shard to a whole cache-line.
+     */
+    ZyanU8 padding[(1 << ZYREX_HOOK_STATISTICS_COUNTER_SHIFT) - sizeof(ZyanU64)];
+} ZyrexStatisticsCounter;
+
+/**
+ * @brief   Defines the `ZyrexStatisticsEntry` struct.
+ */
+typedef struct ZyrexStatisticsEntry_
+{
+    /**
+     * @brief   The latency histogram.
+     */
+    volatile ZyanU32 latency_histogram[ZYREX_HOOK_STATISTICS_HISTOGRAM_SIZE];
+} ZyrexStatisticsEntry;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Returns the statistics entry for the trampoline with the given dense `index`.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ *
+ * @return  A pointer to the statistics entry or `ZYAN_NULL`, if the trampoline is not
+ *          instrumented.
+ */
+ZyrexStatisticsEntry* ZyrexStatisticsGetEntry(ZyanU32 index);
+
+/**
+ * @brief   Returns the call counter shards for the trampoline with the given dense `index`.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ *
+ * @return  A pointer to the first of `ZYREX_HOOK_STATISTICS_COUNTER_SHARDS` consecutive shards or
+ *          `ZYAN_NULL`, if the trampoline is not instrumented.
+ */
+ZyrexStatisticsCounter* ZyrexStatisticsGetCounters(ZyanU32 index);
+
+/**
+ * @brief   Returns the number of calls redirected to the hook callback of the trampoline with
+ *          the given dense `index`.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ *
+ * @return  The sum of all call counter shards of the trampoline.
+ */
+ZyanU64 ZyrexStatisticsGetCallCount(ZyanU32 index);
+
+/**
+ * @brief   Checks, if the processor number can be read by the callback stubs.
+ *
+ * @return  `ZYAN_TRUE`, if the `rdtscp` instruction is supported or `ZYAN_FALSE`, if not.
+ *
+ * If `rdtscp` is not supported, all calls are counted in the first shard.
+ */
+ZyanBool ZyrexStatisticsIsProcessorIdSupported(void);
+
+/**
+ * @brief   Clears the statistics entry and the call counters for the trampoline with the given
+ *          dense `index`.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ */
+void ZyrexStatisticsResetEntry(ZyanU32 index);
+
+/**
+ * @brief   Adds a latency sample to the histogram of the trampoline with the given dense
+ *          `index`.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ * @param   ticks   The number of timestamp-counter ticks the sampled invocation took.
+ */
+void ZyrexStatisticsRecordLatency(ZyanU32 index, ZyanU64 ticks);
+
+/* ============================================================================================== */
+
+#endif
+
+/* ============================================================================================== */
+/* Timestamp counter                                                                              */
+/* ============================================================================================== */
+
+/**
+ * @brief   Reads the timestamp-counter.
+ *
+ * @return  The current value of the timestamp-counter.
+ *
+ * This function is used for latency samples and trace records.
+ */
+ZYAN_INLINE ZyanU64 ZyrexReadTimestampCounter(void)
+{
+    return (ZyanU64)__rdtsc();
+}
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_STATISTICS_H */
@@ -0,0 +1,137 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_THREAD_MASK_H
+#define ZYREX_INTERNAL_THREAD_MASK_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/ThreadMask.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum number of trampolines that can be disabled individually.
+ *
+ * This matches the number of dense barrier handles, which allows the callback stub to index the
+ * mask with the dense index of the trampoline.
+ */
+#define ZYREX_THREAD_MASK_MAX_ENTRIES   ZYREX_BARRIER_DENSE_HANDLE_COUNT
+
+/**
+ * @brief   Defines the segment override prefix that is used to access the TLS slot of the
+ *          thread mask.
+ */
+#if defined(ZYAN_WINDOWS) == defined(ZYAN_X64)
+#   define ZYREX_THREAD_MASK_SEGMENT_PREFIX 0x65 /* gs */
+#else
+#   define ZYREX_THREAD_MASK_SEGMENT_PREFIX 0x64 /* fs */
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexThreadMask` struct.
+ *
+ * The struct is allocated once per thread, when the thread disables a hook for the first time.
+ * All thread masks are linked into a global list, so that the bit of a released dense index can
+ * be cleared for every thread (see `ZyrexThreadMaskReleaseIndex`). Bits are therefore modified
+ * atomically.
+ */
+typedef struct ZyrexThreadMask_
+{
+    /**
+     * @brief   Signals, if all hooks are disabled for the thread.
+     *
+     * This value is checked by the callback stub as a whole and must therefore be a 32-bit
+     * value.
+     */
+    ZyanU32 is_disabled;
+    /**
+     * @brief   Contains a bit for each dense trampoline index, which is set, if the corresponding
+     *          hook is disabled for the thread.
+     */
+    ZyanU32 disabled_hooks[ZYREX_THREAD_MASK_MAX_ENTRIES / 32];
+    /**
+     * @brief   The next thread mask in the global list.
+     */
+    struct ZyrexThreadMask_* next;
+    /**
+     * @brief   The previous thread mask in the global list.
+     */
+    struct ZyrexThreadMask_* previous;
+} ZyrexThreadMask;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Returns the offset of the TLS slot that holds the pointer to the thread mask of the
+ *          current thread.
+ *
+ * @param   offset  Receives the offset of the TLS slot, relative to the segment that is selected
+ *                  by `ZYREX_THREAD_MASK_SEGMENT_PREFIX`.
+ *
+ * @return  A zyan status code.
+ *
+ * `ZYAN_STATUS_INVALID_OPERATION` is returned, if the thread mask system is not initialized or
+ * not supported on the current platform.
+ */
+ZyanStatus ZyrexThreadMaskGetSlotOffset(ZyanU32* offset);
+
+/**
+ * @brief   Clears the bit of the given dense trampoline index in the thread masks of all threads.
+ *
+ * @param   index   The dense index of the trampoline chunk.
+ *
+ * @return  A zyan status code.
+ *
+ * This function has to be called before a released index can be reused. Otherwise a thread that
+ * disabled the previous owner of the index would silently bypass the new hook as well.
+ */
+ZyanStatus ZyrexThreadMaskReleaseIndex(ZyanU32 index);
+
+/* ============================================================================================== */
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_THREAD_MASK_H */
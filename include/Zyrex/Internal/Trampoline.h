@@ -29,6 +29,7 @@
 
 #include <Zycore/Types.h>
 #include <Zyrex/Status.h>
+#include <Zyrex/Zyrex.h>
 #include <Zyrex/Internal/Utils.h>
 
 #ifdef __cplusplus
@@ -78,6 +79,93 @@ extern "C" {
 #define ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT_BONUS \
     2
 
+/**
+ * @brief   Defines the size of the thread mask check at the beginning of the callback stub (in
+ *          bytes).
+ *
+ * If `ZYREX_HOOK_THREAD_MASK` is defined, the check redirects the calls of threads that disabled
+ * the hook straight to the trampoline code. The check is padded, so that the following jump to
+ * the callback function does not cross an 8-byte boundary.
+ */
+#ifdef ZYREX_HOOK_THREAD_MASK
+#   define ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE \
+        32
+#else
+#   define ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE \
+        0
+#endif
+
+/**
+ * @brief   Defines the size of the thread mask epilogue at the end of the callback stub (in
+ *          bytes).
+ *
+ * On 32-bit targets, the epilogue restores the scratch register of the thread mask check, before
+ * the bypassed calls enter the trampoline code.
+ */
+#if defined(ZYREX_HOOK_THREAD_MASK) && !defined(ZYAN_X64)
+#   define ZYREX_TRAMPOLINE_THREAD_MASK_EPILOGUE_SIZE \
+        1
+#else
+#   define ZYREX_TRAMPOLINE_THREAD_MASK_EPILOGUE_SIZE \
+        0
+#endif
+
+/**
+ * @brief   Defines the size of the call counter in the callback stub (in bytes).
+ *
+ * If `ZYREX_HOOK_STATISTICS` is defined, the stub increments the call counter shard of the
+ * current processor before jumping to the callback function. The size includes the padding that
+ * keeps the following jump from crossing an 8-byte boundary.
+ */
+#ifdef ZYREX_HOOK_STATISTICS
+#   define ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE \
+        32
+#else
+#   define ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE \
+        0
+#endif
+
+/**
+ * @brief   Defines the size of the callback stub of a trampoline (in bytes).
+ */
+#define ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE \
+    (ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE + ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE + \
+     ZYREX_SIZEOF_ABSOLUTE_JUMP + ZYREX_TRAMPOLINE_THREAD_MASK_EPILOGUE_SIZE)
+
+/**
+ * @brief   Defines the size of the `mov edi, edi` prologue of hot-patchable functions (in bytes).
+ */
+#define ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE \
+    2
+
+/**
+ * @brief   Defines the size of the padding in front of hot-patchable functions (in bytes).
+ *
+ * The padding receives the relative jump to the callback function.
+ */
+#define ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE \
+    (ZYREX_SIZEOF_RELATIVE_JUMP)
+
+/**
+ * @brief   Defines the size of the code buffer of a trampoline (in bytes).
+ */
+#define ZYREX_TRAMPOLINE_CODE_BUFFER_SIZE \
+    (ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS)
+
+/**
+ * @brief   Defines the size of a single trampoline chunk (in bytes).
+ *
+ * The size is a multiple of the cache-line size. The larger callback stubs used by
+ * `ZYREX_HOOK_STATISTICS` and `ZYREX_HOOK_THREAD_MASK` do not fit into a single cache-line.
+ */
+#if defined(ZYREX_HOOK_STATISTICS) || defined(ZYREX_HOOK_THREAD_MASK)
+#   define ZYREX_TRAMPOLINE_CHUNK_SIZE \
+        128
+#else
+#   define ZYREX_TRAMPOLINE_CHUNK_SIZE \
+        64
+#endif
+
 /**
  * @brief   Defines the trampoline region signature.
  *
@@ -157,36 +245,67 @@ typedef struct ZyrexInstructionTranslationMap_
 
 /**
  * @brief   Defines the `ZyrexTrampolineChunk` struct.
+ *
+ * The chunk only contains the data that is accessed while executing the hook. It lives in
+ * executable memory and is padded to `ZYREX_TRAMPOLINE_CHUNK_SIZE` bytes, so that chunks never
+ * straddle cache-lines. All bookkeeping data is stored separately in the corresponding
+ * `ZyrexTrampolineChunkInfo` struct (see `ZyrexTrampolineGetChunkInfo`).
  */
 typedef struct ZyrexTrampolineChunk_
 {
-    /**
-     * @brief   Signals, if the trampoline chunk is currently in use.
-     */
-    ZyanBool is_used;
     /**
      * @brief   The address of the callback function.
+     *
+     * The hook jump redirects to `callback_jump` which reads this value on every call. This
+     * allows to exchange the callback with a single atomic write.
      */
     ZyanUPointer callback_address;
-
-#if defined(ZYAN_X64)
-
-    /**
-     * @brief   The absolute jump to the callback function.
-     */
-    ZyanU8 callback_jump[ZYREX_SIZEOF_ABSOLUTE_JUMP];
-
-#endif
-
     /**
      * @brief   The backjump address.
      */
     ZyanUPointer backjump_address;
+    /**
+     * @brief   The callback stub which contains the jump to the callback function.
+     */
+    ZyanU8 callback_jump[ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE];
     /**
      * @brief   The buffer that holds the trampoline code and the backjump to the hooked function.
      */
-    ZyanU8 code_buffer[ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + 
-                       ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS];
+    ZyanU8 code_buffer[ZYREX_TRAMPOLINE_CODE_BUFFER_SIZE];
+    /**
+     * @brief   Pads the chunk to `ZYREX_TRAMPOLINE_CHUNK_SIZE` bytes.
+     */
+    ZyanU8 padding[ZYREX_TRAMPOLINE_CHUNK_SIZE - 2 * sizeof(ZyanUPointer) -
+                   ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE - ZYREX_TRAMPOLINE_CODE_BUFFER_SIZE];
+} ZyrexTrampolineChunk;
+
+/**
+ * @brief   Defines the `ZyrexTrampolineChunkInfo` struct.
+ *
+ * The info struct holds the bookkeeping data of a single trampoline chunk. It is stored in a
+ * non-executable array that runs parallel to the chunks of the trampoline-region.
+ */
+typedef struct ZyrexTrampolineChunkInfo_
+{
+    /**
+     * @brief   Signals, if the trampoline chunk is currently in use.
+     */
+    ZyanBool is_used;
+    /**
+     * @brief   The dense index of the trampoline chunk.
+     *
+     * The index is assigned by the trampoline allocator and stays constant for the whole lifetime
+     * of the chunk. Indices of freed chunks are reused.
+     */
+    ZyanU32 index;
+    /**
+     * @brief   The generation of the dense index.
+     *
+     * A new non-zero value is assigned every time an index is handed out. Per-thread data that
+     * is indexed by the dense index uses this value to detect state left behind by a previous
+     * owner of the index.
+     */
+    ZyanU32 generation;
     /**
      * @brief   The number of instruction bytes in the code buffer (not counting the backjump
      *          instruction).
@@ -204,7 +323,18 @@ typedef struct ZyrexTrampolineChunk_
      * @brief   The number of instruction bytes saved from the hooked function.
      */
     ZyanU8 original_code_size;
-} ZyrexTrampolineChunk;
+    /**
+     * @brief   Signals, if the trampoline belongs to a hot-patch hook.
+     *
+     * Hot-patch trampolines do not contain any relocated instructions. The `mov edi, edi`
+     * prologue is saved to `original_code` and the code buffer only contains the backjump.
+     */
+    ZyanBool is_hot_patch;
+    /**
+     * @brief   The padding bytes saved from the memory in front of a hot-patchable function.
+     */
+    ZyanU8 hot_patch_padding[ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE];
+} ZyrexTrampolineChunkInfo;
 
 /* ---------------------------------------------------------------------------------------------- */
 
@@ -233,15 +363,92 @@ typedef struct ZyrexTrampolineChunk_
 ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
     ZyanUSize min_bytes_to_reloc, ZyrexTrampolineChunk** trampoline);
 
+/**
+ * @brief   Creates a new trampoline for a hot-patchable function.
+ *
+ * @param   address     The address of the function to create the trampoline for.
+ * @param   callback    The address of the callback function the hook will redirect to.
+ * @param   trampoline  Receives the newly created trampoline chunk.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if the function is not hot-patchable (see
+ *          `ZyrexTrampolineIsHotPatchable`), or another zyan status code.
+ *
+ * No instructions are relocated. The trampoline directly jumps to the instruction following the
+ * `mov edi, edi` prologue.
+ */
+ZyanStatus ZyrexTrampolineCreateHotPatch(const void* address, const void* callback,
+    ZyrexTrampolineChunk** trampoline);
+
 /**
  * @brief   Destroys the given trampoline.
  *
  * @param   trampoline  The trampoline chunk.
  *
  * @return  A zyan status code.
+ *
+ * The memory of the chunk is decommitted, but the trampoline-region itself is never released, as
+ * concurrent calls to `ZyrexTrampolineGetIndex` might still read its region-header. Empty regions
+ * are reused by subsequent allocations.
  */
 ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline);
 
+/**
+ * @brief   Atomically exchanges the callback function of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   callback    The address of the new callback function.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook jump of the target function does not have to be modified. Threads that are currently
+ * executing the hook jump either observe the old or the new callback.
+ *
+ * The trampoline-region stays writable until `ZyrexTrampolineProtectRegions` is called.
+ */
+ZyanStatus ZyrexTrampolineSetCallback(ZyrexTrampolineChunk* trampoline, const void* callback);
+
+/**
+ * @brief   Allocates empty trampoline-regions close to the given `address`.
+ *
+ * @param   address The address to allocate the regions for (e.g. a module base address).
+ * @param   count   The number of regions to allocate.
+ *
+ * @return  A zyan status code.
+ *
+ * The regions are used for subsequently created trampolines and released as soon as the last
+ * trampoline in them gets freed.
+ */
+ZyanStatus ZyrexTrampolineReserveRegions(const void* address, ZyanUSize count);
+
+/**
+ * @brief   Makes sure that at least `count` unused trampoline chunks are available in a
+ *          +/-2GiB range to both given addresses.
+ *
+ * @param   address_lo  The memory address lower bound.
+ * @param   address_hi  The memory address upper bound.
+ * @param   count       The number of required trampoline chunks.
+ *
+ * @return  A zyan status code.
+ *
+ * All missing trampoline-regions are allocated in a single pass. Subsequently created trampolines
+ * for addresses in the given range fill these regions one chunk after another.
+ */
+ZyanStatus ZyrexTrampolineReserveChunks(const void* address_lo, const void* address_hi,
+    ZyanUSize count);
+
+/**
+ * @brief   Restores the memory protection of all trampoline-regions that have been modified
+ *          since the last call to this function.
+ *
+ * @return  A zyan status code.
+ *
+ * Creating or freeing trampolines leaves the affected trampoline-regions writable, so that
+ * subsequent changes in the same transaction do not have to change the memory protection
+ * again. This function should be called at the end of every transaction. The instruction cache
+ * is flushed once for every modified trampoline-region.
+ */
+ZyanStatus ZyrexTrampolineProtectRegions(void);
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Searching                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
@@ -254,9 +461,107 @@ ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline);
  *
  * @return  `ZYAN_STATUS_TRUE` if the element was found, `ZYAN_STATUS_FALSE` if not or an other
  *          zyan status code if an error occured.
+ *
+ * The trampoline chunk is located by address arithmetic, after the containing trampoline-region
+ * has been looked up in the global region table.
  */
 ZyanStatus ZyrexTrampolineFind(const void* original, ZyrexTrampolineChunk** trampoline);
 
+/**
+ * @brief   Returns the dense index of the trampoline chunk that is identified by the given
+ *          `trampoline` code pointer.
+ *
+ * @param   trampoline  A pointer to the code buffer of a trampoline chunk.
+ * @param   index       Receives the dense index of the trampoline chunk, if found.
+ * @param   generation  Receives the generation of the dense index, if found. This parameter is
+ *                      optional and may be `ZYAN_NULL`.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the trampoline chunk was found, `ZYAN_STATUS_FALSE` if not or an
+ *          other zyan status code if an error occured.
+ *
+ * In contrast to the other trampoline functions, this function can safely be called from any
+ * thread, e.g. from inside a hook callback. It does not take any locks, but looks up the
+ * containing trampoline-region in a lock-free hash table. Arbitrary pointers are rejected without
+ * dereferencing them.
+ */
+ZyanStatus ZyrexTrampolineGetIndex(const void* trampoline, ZyanU32* index,
+    ZyanU32* generation);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Information                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns information about the memory used by all trampoline-regions.
+ *
+ * @param   reserved_bytes          Receives the total amount of reserved bytes.
+ * @param   committed_bytes         Receives the total amount of committed bytes.
+ * @param   number_of_trampolines   Receives the number of currently allocated trampolines.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexTrampolineGetMemoryInfo(ZyanUSize* reserved_bytes, ZyanUSize* committed_bytes,
+    ZyanUSize* number_of_trampolines);
+
+/**
+ * @brief   Returns the number of trampoline-regions allocated since the initialization of the
+ *          trampoline API.
+ *
+ * @return  The number of allocated trampoline-regions, including the ones that have already been
+ *          freed.
+ */
+ZyanUSize ZyrexTrampolineGetRegionAllocationCount(void);
+
+/**
+ * @brief   Returns the bookkeeping data of the given trampoline chunk.
+ *
+ * @param   trampoline  The trampoline chunk.
+ *
+ * @return  A pointer to the `ZyrexTrampolineChunkInfo` struct of the trampoline chunk.
+ *
+ * The info struct is located in constant time by address arithmetic.
+ */
+ZyrexTrampolineChunkInfo* ZyrexTrampolineGetChunkInfo(const ZyrexTrampolineChunk* trampoline);
+
+/**
+ * @brief   Returns the writable alias of the given address inside of a trampoline-region.
+ *
+ * @param   address An address inside of a trampoline-region.
+ *
+ * @return  The address at which the same memory can be written.
+ *
+ * If `ZYREX_TRAMPOLINE_DUAL_MAPPING` is defined, every trampoline-region is mapped twice and the
+ * executable view is never writable. Otherwise, the given address is returned unchanged.
+ */
+void* ZyrexTrampolineGetWritableAddress(const void* address);
+
+/**
+ * @brief   Returns the call statistics of all trampolines.
+ *
+ * @param   statistics  Receives the statistics of the trampolines.
+ * @param   capacity    The number of elements in the `statistics` array.
+ * @param   count       Receives the number of trampolines.
+ *
+ * @return  `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE`, if the `statistics` array is too small to
+ *          receive all elements, `ZYAN_STATUS_INVALID_OPERATION`, if `ZYREX_HOOK_STATISTICS`
+ *          is not defined, or another zyan status code.
+ */
+ZyanStatus ZyrexTrampolineQueryStatistics(ZyrexHookStatistics* statistics, ZyanUSize capacity,
+    ZyanUSize* count);
+
+/**
+ * @brief   Checks, if the function at the given `address` can be hooked by hot-patching.
+ *
+ * @param   address The address of the function.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the function is hot-patchable, `ZYAN_STATUS_FALSE` if not or
+ *          another zyan status code if an error occured.
+ *
+ * A function is hot-patchable, if it starts with a 2-byte `mov edi, edi` instruction at an even
+ * address and is preceded by at least 5 bytes of `int3` or `nop` padding.
+ */
+ZyanStatus ZyrexTrampolineIsHotPatchable(const void* address);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -106,6 +106,29 @@ ZYAN_INLINE void ZyrexWriteRelativeJump(void* address, ZyanUPointer destination)
         (ZyanUPointer)address, destination);
 }
 
+/**
+ * @brief   Checks, if the given `destination` is reachable by a relative jump instruction at the
+ *          given `address`.
+ *
+ * @param   address     The jump address.
+ * @param   destination The absolute destination address of the jump.
+ *
+ * @return  `ZYAN_TRUE`, if the destination is in range, or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexIsRelativeJumpInRange(ZyanUPointer address, ZyanUPointer destination)
+{
+#if defined(ZYAN_X64)
+    const ZyanI64 offset = (ZyanI64)(destination - address - ZYREX_SIZEOF_RELATIVE_JUMP);
+    return (offset >= -(ZyanI64)ZYREX_RANGEOF_RELATIVE_JUMP - 1) &&
+        (offset <= (ZyanI64)ZYREX_RANGEOF_RELATIVE_JUMP);
+#else
+    // The offset wraps around the 32-bit address space
+    ZYAN_UNUSED(address);
+    ZYAN_UNUSED(destination);
+    return ZYAN_TRUE;
+#endif
+}
+
 /**
  * @brief	Writes an absolute indirect jump instruction at the given `address`.
  *
@@ -125,6 +148,22 @@ ZYAN_INLINE void ZyrexWriteAbsoluteJump(void* address, ZyanUPointer destination)
 #endif
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Code patching                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically writes the given `data` to the given `address`.
+ *
+ * @param   address The target address.
+ * @param   data    A pointer to the data to write.
+ * @param   size    The size of the data. The memory range must not cross an 8-byte boundary.
+ *
+ * The bytes are merged into the surrounding aligned 8-byte value, which is written using a
+ * locked compare-exchange instruction. The memory at the target address must be writable.
+ */
+void ZyrexWriteAtomic64(void* address, const void* data, ZyanUSize size);
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Instruction decoding                                                                           */
 /* ---------------------------------------------------------------------------------------------- */
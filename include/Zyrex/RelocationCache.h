@@ -0,0 +1,112 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_RELOCATION_CACHE_H
+#define ZYREX_RELOCATION_CACHE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <ZyrexExportConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexRelocationCache` struct.
+ *
+ * This is an opaque type. All fields are private.
+ */
+typedef struct ZyrexRelocationCache_ ZyrexRelocationCache;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * @brief   Opens the relocation cache file for the given module.
+ *
+ * @param   path        The path of the cache file.
+ * @param   module_base The base address of the module.
+ * @param   module_size The size of the module image.
+ * @param   module_key  A value that identifies the exact build of the module (e.g. a hash of the
+ *                      image or the timestamp from the PE header).
+ * @param   cache       Receives the relocation cache.
+ *
+ * @return  A zyan status code.
+ *
+ * The cache file is mapped into memory and used by all subsequently created inline hooks for
+ * functions inside the module. If a cached entry exists for the hooked function, the relocated
+ * instructions are rebased to the new trampoline instead of decoding and relocating the
+ * original instructions again. Cached entries are only used, if the original instruction bytes
+ * still match.
+ *
+ * A cache file that does not exist or was created for a different `module_key`, architecture or
+ * file format version is treated as empty. Newly relocated functions are added to the cache and
+ * can be written back to the file by calling `ZyrexRelocationCacheSave`.
+ *
+ * This function must not be called while a transaction is in progress.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRelocationCacheOpen(const char* path, const void* module_base,
+    ZyanUSize module_size, ZyanU64 module_key, ZyrexRelocationCache** cache);
+
+/**
+ * @brief   Writes all entries of the given relocation cache to the cache file.
+ *
+ * @param   cache   The relocation cache.
+ *
+ * @return  A zyan status code.
+ *
+ * This function must not be called while a transaction is in progress.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRelocationCacheSave(ZyrexRelocationCache* cache);
+
+/**
+ * @brief   Closes the given relocation cache.
+ *
+ * @param   cache   The relocation cache.
+ *
+ * @return  A zyan status code.
+ *
+ * Entries that have been added since the last call to `ZyrexRelocationCacheSave` are discarded.
+ * Hooks created with the help of the cache are not affected.
+ *
+ * This function must not be called while a transaction is in progress.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRelocationCacheClose(ZyrexRelocationCache* cache);
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_RELOCATION_CACHE_H */
@@ -0,0 +1,120 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_THREAD_MASK_H
+#define ZYREX_THREAD_MASK_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <ZyrexExportConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Initializes the thread mask system.
+ *
+ * @return  A zyan status code.
+ *
+ * This function must be called before installing any hooks. The callback stubs of trampolines
+ * that are created before are not able to bypass the callback.
+ *
+ * The thread mask is only available, if `ZYREX_HOOK_THREAD_MASK` is defined. On unsupported
+ * platforms, this function succeeds, but all other thread mask functions fail with
+ * `ZYAN_STATUS_INVALID_OPERATION`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexThreadMaskSystemInitialize(void);
+
+/**
+ * @brief   Finalizes the thread mask system.
+ *
+ * @return  A zyan status code.
+ *
+ * This function must not be called while any hooks are installed.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexThreadMaskSystemShutdown(void);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread mask                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Enables or disables all hooks for the calling thread.
+ *
+ * @param   enabled Set `ZYAN_TRUE` to enable the hooks or `ZYAN_FALSE` to disable them.
+ *
+ * @return  A zyan status code.
+ *
+ * Calls of a thread that disabled a hook are redirected straight to the trampoline by the
+ * callback stub, without ever entering the callback function. The per-hook settings of the
+ * thread are retained and apply again, after all hooks have been enabled.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexThreadMaskSetGlobal(ZyanBool enabled);
+
+/**
+ * @brief   Enables or disables the hook that is identified by the given `trampoline` for the
+ *          calling thread.
+ *
+ * @param   trampoline  The `trampoline` that identifies the hook.
+ * @param   enabled     Set `ZYAN_TRUE` to enable the hook or `ZYAN_FALSE` to disable it.
+ *
+ * @return  A zyan status code.
+ *
+ * Only the first `ZYREX_BARRIER_DENSE_HANDLE_COUNT` trampolines can be disabled individually.
+ * `ZYAN_STATUS_OUT_OF_RANGE` is returned for all other trampolines.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexThreadMaskSetHook(const void* trampoline, ZyanBool enabled);
+
+/**
+ * @brief   Checks, if the hook that is identified by the given `trampoline` is enabled for the
+ *          calling thread.
+ *
+ * @param   trampoline  The `trampoline` that identifies the hook.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the hook is enabled, `ZYAN_STATUS_FALSE`, if not, or a generic
+ *          zyan status code, if an error occured.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexThreadMaskIsHookEnabled(const void* trampoline);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_THREAD_MASK_H */
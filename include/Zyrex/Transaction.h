@@ -40,6 +40,37 @@ extern "C" {
 /* Enums and types                                                                                */
 /* ============================================================================================== */
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction flags                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTransactionFlags` enum.
+ */
+typedef enum ZyrexTransactionFlags_
+{
+    /**
+     * @brief   No flags.
+     */
+    ZYREX_TRANSACTION_FLAG_NONE             = 0x00000000,
+    /**
+     * @brief   Writes patches using a single atomic instruction, if the alignment of the patch
+     *          site allows it.
+     *
+     * The relative jump of an inline hook is written with a locked 8-byte compare-exchange, if
+     * the 5 patched bytes do not cross an 8-byte boundary and the first instruction of the
+     * target function is at least 5 bytes long. In this case, no thread can execute an
+     * instruction inside the patched bytes. Hot-patch hooks are always written atomically.
+     * Threads are neither suspended nor migrated for these operations.
+     *
+     * `ZyrexUpdateAllThreads` defers the suspension of threads to the commit and only suspends
+     * threads, if at least one of the pending operations can not be written atomically. This
+     * applies to misaligned patch sites, to target functions with shorter first instructions and
+     * to all remove operations, as their trampolines are released during the commit.
+     */
+    ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES    = 0x00000001
+} ZyrexTransactionFlags;
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook type                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
@@ -74,9 +105,58 @@ typedef enum ZyrexHookType_
      *
      * This hook
      */
-    ZYREX_HOOK_TYPE_CONTEXT
+    ZYREX_HOOK_TYPE_CONTEXT,
+    /**
+     * @brief   Import table hook.
+     *
+     * The import table hook exchanges the import address table entries (and the export address
+     * table entry) of the loaded modules that refer to the target function. No code is patched
+     * or relocated and no trampoline is needed, which is why calls to the callback and to the
+     * original function only cost a single indirect call.
+     *
+     * This hook type is only supported on Windows (PE) and Linux (ELF).
+     */
+    ZYREX_HOOK_TYPE_IMPORT_TABLE
 } ZyrexHookType;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Inline hook mode                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexInlineHookMode` enum.
+ */
+typedef enum ZyrexInlineHookMode_
+{
+    /**
+     * @brief   Overwrites the first instructions of the target function with a relative jump.
+     *
+     * The overwritten instructions are relocated to the trampoline. All threads that might
+     * execute the target function have to be updated (see `ZyrexUpdateAllThreads`) in order to
+     * safely install or remove the hook.
+     */
+    ZYREX_INLINE_HOOK_MODE_DEFAULT,
+    /**
+     * @brief   Uses the hot-patch point of the target function.
+     *
+     * The target function has to start with a `mov edi, edi` instruction and has to be preceded
+     * by at least 5 bytes of `int3` or `nop` padding (e.g. code compiled with `/hotpatch`). The
+     * relative jump to the callback is written to the padding and the prologue is replaced by a
+     * short backward jump using a single atomic write.
+     *
+     * No instructions are relocated. Threads do not have to be suspended to install the hook, if
+     * the transaction was started with `ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES`. Otherwise, and for
+     * every removal, threads are suspended and threads that already took the short jump are
+     * migrated back to the restored prologue.
+     */
+    ZYREX_INLINE_HOOK_MODE_HOT_PATCH,
+    /**
+     * @brief   Uses the hot-patch point of the target function, if available and falls back to
+     *          `ZYREX_INLINE_HOOK_MODE_DEFAULT` otherwise.
+     */
+    ZYREX_INLINE_HOOK_MODE_PREFER_HOT_PATCH
+} ZyrexInlineHookMode;
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook                                                                                           */
 /* ---------------------------------------------------------------------------------------------- */
@@ -99,6 +179,96 @@ typedef struct ZyrexHook_
     void* address;
 } ZyrexHook;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook specification                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexHookSpec` struct.
+ *
+ * Describes a single hook for the bulk installation functions.
+ */
+typedef struct ZyrexHookSpec_
+{
+    /**
+     * @brief   The address to hook.
+     */
+    void* address;
+    /**
+     * @brief   The callback address.
+     */
+    const void* callback;
+    /**
+     * @brief   Receives the address of the trampoline to the original function, if the
+     *          operation succeeded.
+     */
+    ZyanConstVoidPointer* trampoline;
+} ZyrexHookSpec;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction statistics                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTransactionStatistics` struct.
+ *
+ * All durations are measured in nanoseconds using a monotonic clock. The values are accumulated
+ * over the whole transaction, which includes the thread updates performed before the commit.
+ */
+typedef struct ZyrexTransactionStatistics_
+{
+    /**
+     * @brief   The time spent enumerating the threads of the current process.
+     */
+    ZyanU64 enumerate_time;
+    /**
+     * @brief   The time spent suspending threads.
+     */
+    ZyanU64 suspend_time;
+    /**
+     * @brief   The time spent migrating the suspended threads out of the patched code ranges.
+     */
+    ZyanU64 migrate_time;
+    /**
+     * @brief   The time spent writing the hook jumps and updating the hook chains.
+     */
+    ZyanU64 patch_time;
+    /**
+     * @brief   The time spent changing the protection of the patched memory pages and the
+     *          trampoline-regions.
+     */
+    ZyanU64 protect_time;
+    /**
+     * @brief   The time spent flushing the instruction cache.
+     */
+    ZyanU64 flush_time;
+    /**
+     * @brief   The time spent resuming the suspended threads.
+     */
+    ZyanU64 resume_time;
+    /**
+     * @brief   The time from the suspension of the first thread until all threads have been
+     *          resumed.
+     */
+    ZyanU64 frozen_time;
+    /**
+     * @brief   The number of suspended threads.
+     */
+    ZyanUSize thread_count;
+    /**
+     * @brief   The number of memory pages that have been made writable for patching.
+     */
+    ZyanUSize page_count;
+    /**
+     * @brief   The number of trampoline-regions allocated during the transaction.
+     */
+    ZyanUSize region_count;
+    /**
+     * @brief   The number of threads whose instruction pointer has been migrated.
+     */
+    ZyanUSize migration_count;
+} ZyrexTransactionStatistics;
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook operation                                                                                 */
 /* ---------------------------------------------------------------------------------------------- */
@@ -120,6 +290,15 @@ typedef struct ZyrexHook_
  */
 ZYREX_EXPORT ZyanStatus ZyrexTransactionBegin(void);
 
+/**
+ * @brief   Starts a new transaction using the given `flags`.
+ *
+ * @param   flags   A combination of `ZyrexTransactionFlags` values.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionBeginEx(ZyanU32 flags);
+
 /**
  * @brief   Adds a specific thread to the thread-update list.
  *
@@ -155,12 +334,35 @@ ZYREX_EXPORT ZyanStatus ZyrexTransactionCommit(void);
 /**
  * @brief   Commits the current transaction.
  *
- * @param   failed_operation    Receives a pointer to the operation that failed the transaction.
+ * @param   failed_operation    Receives the address of the hooked function of the operation that
+ *                              failed the transaction, or `ZYAN_NULL`.
  *
  * @return  A zyan status code.
+ *
+ * Every pending operation is either applied completely or not at all. The commit stops at the
+ * first operation that fails and returns its status code. All operations before the failed one
+ * stay applied, while the failed operation and all operations after it are discarded.
+ *
+ * The transaction is closed in both cases.
  */
 ZYREX_EXPORT ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation);
 
+/**
+ * @brief   Commits the current transaction and reports the time spent in each of its phases.
+ *
+ * @param   failed_operation    Receives the address of the hooked function of the operation that
+ *                              failed the transaction, or `ZYAN_NULL`.
+ * @param   statistics          A pointer to the `ZyrexTransactionStatistics` struct that receives
+ *                              the statistics of the transaction, or `ZYAN_NULL`.
+ *
+ * @return  A zyan status code.
+ *
+ * The `statistics` are only filled, if the function succeeded. Failed operations are handled the
+ * same way as by `ZyrexTransactionCommitEx`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionCommitWithStatistics(const void** failed_operation,
+    ZyrexTransactionStatistics* statistics);
+
 /**
  * @brief   Cancels the current transaction.
  *
@@ -185,6 +387,38 @@ ZYREX_EXPORT ZyanStatus ZyrexTransactionAbort(void);
 ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback,
     ZyanConstVoidPointer* trampoline);
 
+/**
+ * @brief   Installs an inline hook at the given `address` using the given `mode`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   mode        The inline hook mode.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if `ZYREX_INLINE_HOOK_MODE_HOT_PATCH` is requested
+ *          for a function without a hot-patch point, or another zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHookEx(void* address, const void* callback,
+    ZyrexInlineHookMode mode, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs multiple inline hooks at once.
+ *
+ * @param   specs           A pointer to an array of `ZyrexHookSpec` structs.
+ * @param   count           The number of items in the `specs` array.
+ * @param   failed_index    Receives the index of the hook that could not be installed, if the
+ *                          operation failed. This argument is optional and may be `ZYAN_NULL`.
+ *
+ * @return  A zyan status code.
+ *
+ * The hooks are installed in order of their target addresses. Hooks located close to each other
+ * share their trampoline-regions, which are allocated up front. If one of the hooks can not be
+ * installed, none of the hooks in `specs` are installed.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHooks(const ZyrexHookSpec* specs, ZyanUSize count,
+    ZyanUSize* failed_index);
+
 ///**
 // * @brief   Attaches an exception hook.
 // *
@@ -207,7 +441,45 @@ ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHook(void* address, const void* callba
 // */
 //ZYREX_EXPORT ZyanStatus ZyrexAttachContextHook(const void** address, const void* callback);
 
-// TODO: IAT/EAT, VTable, ..
+/**
+ * @brief   Installs an import table hook for the given `function`.
+ *
+ * @param   function    The address of the function to hook.
+ * @param   callback    The callback address.
+ * @param   original    Receives the address of the original function, if the operation
+ *                      succeeded.
+ *
+ * @return  `ZYAN_STATUS_NOT_FOUND`, if no import or export table entry refers to `function`,
+ *          `ZYAN_STATUS_INVALID_OPERATION`, if `function` is already hooked by an import table
+ *          hook or the current platform is neither Windows nor Linux, or another zyan status code.
+ *
+ * All import address table entries of the loaded modules that refer to `function` (the `GOT`
+ * entries on POSIX platforms) are exchanged atomically when the transaction is committed. Threads
+ * do not have to be suspended. Calls that do not use the import tables (e.g. calls from within
+ * the module that exports the function) are not intercepted.
+ *
+ * The commit fails with `ZYAN_STATUS_INVALID_OPERATION` and leaves all table entries untouched,
+ * if one of the entries has been modified by someone else after this function was called.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallImportHook(const void* function, const void* callback,
+    ZyanConstVoidPointer* original);
+
+// TODO: VTable, ..
+
+/**
+ * @brief   Reserves trampoline memory close to the given `address`.
+ *
+ * @param   address The address to reserve the trampoline memory for (e.g. the base address of a
+ *                  module that is going to be hooked).
+ * @param   count   The number of trampoline-regions to reserve.
+ *
+ * @return  A zyan status code.
+ *
+ * Trampolines for hooks installed afterwards are preferably placed in these regions, which
+ * avoids searching for free memory during hook installation. This function has to be called
+ * inside a transaction. The reserved memory is not released, if the transaction is aborted.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexReserveTrampolineMemory(const void* address, ZyanUSize count);
 
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook removal                                                                                   */
@@ -223,6 +495,57 @@ ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHook(void* address, const void* callba
  */
 ZYREX_EXPORT ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* original);
 
+/**
+ * @brief   Removes the import table hook of the given `function`.
+ *
+ * @param   function    The address of the hooked function.
+ *
+ * @return  A zyan status code.
+ *
+ * The commit fails with `ZYAN_STATUS_INVALID_OPERATION` and the hook stays installed, if one of
+ * the table entries has been modified by someone else after the hook was installed.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveImportHook(const void* function);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook chaining                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Adds a callback to the chained inline hook at the given `address`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   next        Receives the address of the next function in the chain. The callback
+ *                      should continue the chain by calling this function instead of the
+ *                      original one. The memory has to stay valid until the callback is removed.
+ *
+ * @return  A zyan status code.
+ *
+ * The first callback installs a regular inline hook at the given `address`. Subsequent callbacks
+ * share the trampoline of this hook and are placed in front of the chain. They are published by
+ * exchanging a single pointer, which neither requires the target function to be patched again
+ * nor threads to be suspended.
+ *
+ * The value pointed to by `next` is updated on commit and whenever the successor of the callback
+ * is removed from the chain.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHookChained(void* address, const void* callback,
+    ZyanConstVoidPointer* next);
+
+/**
+ * @brief   Removes a callback from a chained inline hook.
+ *
+ * @param   next    The pointer passed to `ZyrexInstallInlineHookChained` when the callback was
+ *                  added.
+ *
+ * @return  A zyan status code.
+ *
+ * Removing the last callback of the chain removes the inline hook itself. Threads do not have to
+ * be suspended for removing other callbacks.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveInlineHookChained(ZyanConstVoidPointer* next);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -55,6 +55,14 @@ extern "C" {
  */
 #define ZYREX_VERSION (ZyanU64)0x0001000000000000
 
+/**
+ * @brief   Defines the number of buckets in the latency histogram of each hook.
+ *
+ * Bucket `n` counts the sampled calls that took between `2^n` and `2^(n+1) - 1` timestamp-counter
+ * ticks. The last bucket additionally counts all longer calls.
+ */
+#define ZYREX_HOOK_STATISTICS_HISTOGRAM_SIZE 32
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Helper macros                                                                                  */
 /* ---------------------------------------------------------------------------------------------- */
@@ -89,6 +97,54 @@ extern "C" {
 
 /* ---------------------------------------------------------------------------------------------- */
 
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexMemoryInfo` struct.
+ */
+typedef struct ZyrexMemoryInfo_
+{
+    /**
+     * @brief   The total amount of bytes reserved for trampolines.
+     */
+    ZyanUSize reserved_bytes;
+    /**
+     * @brief   The total amount of bytes committed for trampolines.
+     */
+    ZyanUSize committed_bytes;
+    /**
+     * @brief   The number of currently allocated trampolines.
+     */
+    ZyanUSize number_of_trampolines;
+} ZyrexMemoryInfo;
+
+/**
+ * @brief   Defines the `ZyrexHookStatistics` struct.
+ */
+typedef struct ZyrexHookStatistics_
+{
+    /**
+     * @brief   The address of the hooked function.
+     */
+    const void* address;
+    /**
+     * @brief   The trampoline of the hook.
+     */
+    const void* trampoline;
+    /**
+     * @brief   The number of calls that have been redirected to the hook callback.
+     *
+     * The calls are counted per processor and summed up when the statistics are queried.
+     */
+    ZyanU64 call_count;
+    /**
+     * @brief   The latency histogram of the sampled barrier-protected callback invocations.
+     */
+    ZyanU32 latency_histogram[ZYREX_HOOK_STATISTICS_HISTOGRAM_SIZE];
+} ZyrexHookStatistics;
+
 /* ============================================================================================== */
 /* Exported functions                                                                             */
 /* ============================================================================================== */
@@ -129,6 +185,40 @@ ZYREX_EXPORT ZyanStatus ZyrexShutdown(void);
  */
 ZYREX_EXPORT ZyanU64 ZyrexGetVersion(void);
 
+/**
+ * @brief   Returns information about the memory used by the `Zyrex` hook engine.
+ *
+ * @param   info    Receives the memory information.
+ *
+ * @return  A zyan status code.
+ *
+ * Trampoline memory is reserved in regions and committed page by page on demand. The returned
+ * values are not synchronized with a concurrently running transaction.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexGetMemoryInfo(ZyrexMemoryInfo* info);
+
+/**
+ * @brief   Returns the call statistics of all installed hooks.
+ *
+ * @param   statistics  Receives the statistics of the installed hooks. Can be `ZYAN_NULL`, if
+ *                      `capacity` is `0`.
+ * @param   capacity    The number of elements in the `statistics` array.
+ * @param   count       Receives the number of installed hooks.
+ *
+ * @return  `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE`, if the `statistics` array is too small to
+ *          receive all elements, `ZYAN_STATUS_INVALID_OPERATION`, if the library was built
+ *          without `ZYREX_HOOK_STATISTICS`, or another zyan status code.
+ *
+ * The call counter is incremented by the trampoline every time a call is redirected to the hook
+ * callback. Latency samples are taken between `ZyrexBarrierTryEnter` and `ZyrexBarrierLeave`
+ * for every 16th outermost callback invocation of each thread.
+ * Only the first `ZYREX_BARRIER_DENSE_HANDLE_COUNT` trampolines are instrumented.
+ *
+ * The returned values are not synchronized with a concurrently running transaction.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexQueryHookStatistics(ZyrexHookStatistics* statistics,
+    ZyanUSize capacity, ZyanUSize* count);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -26,17 +26,50 @@
 
 #include <Zycore/API/Thread.h>
 #include <Zycore/LibC.h>
-#include <Zycore/Vector.h>
 #include <Zyrex/Barrier.h>
+#include <Zyrex/Internal/Statistics.h>
+#include <Zyrex/Internal/Trampoline.h>
+
+#if defined(ZYREX_BARRIER_STATIC_TLS) && defined(ZYREX_BARRIER_TRACE)
+#   error "ZYREX_BARRIER_TRACE requires dynamic TLS to release the trace rings of exited threads"
+#endif
 
 /* ============================================================================================== */
-/* Globals                                                                                        */
+/* Constants                                                                                      */
 /* ============================================================================================== */
 
 /**
- * The TLS slot used by the barrier system.
+ * The number of bits used to index the per-thread barrier context table.
  */
-static ZyanThreadTlsIndex g_barrier_tls_index = 0;
+#define ZYREX_BARRIER_TABLE_BITS    7
+
+/**
+ * The number of slots in the per-thread barrier context table.
+ *
+ * Only barriers that are currently entered occupy a slot, which means this value limits the
+ * number of distinct hooks a single thread can be nested in at the same time.
+ */
+#define ZYREX_BARRIER_TABLE_SIZE    (1 << ZYREX_BARRIER_TABLE_BITS)
+
+/**
+ * The mask used to wrap slot indices of the per-thread barrier context table.
+ */
+#define ZYREX_BARRIER_TABLE_MASK    (ZYREX_BARRIER_TABLE_SIZE - 1)
+
+/**
+ * The mask used to wrap record indices of the per-thread trace ring.
+ */
+#define ZYREX_BARRIER_TRACE_RING_MASK   (ZYREX_BARRIER_TRACE_RING_SIZE - 1)
+
+ZYAN_STATIC_ASSERT((ZYREX_BARRIER_TRACE_RING_SIZE & ZYREX_BARRIER_TRACE_RING_MASK) == 0);
+
+/**
+ * The maximum recursion depth that can be stored for a dense barrier handle.
+ */
+#define ZYREX_BARRIER_DENSE_MAX_RECURSION_DEPTH 0xFFFF
+
+ZYAN_STATIC_ASSERT((ZYREX_BARRIER_DENSE_HANDLE_COUNT > 0) &&
+    (ZYREX_BARRIER_DENSE_HANDLE_COUNT % 32 == 0));
 
 /* ============================================================================================== */
 /* Enums and types                                                                                */
@@ -57,16 +90,453 @@ typedef struct ZyrexBarrierContext_
     ZyrexBarrierHandle id;
     /**
      * The current recursion depth.
+     *
+     * A value of `0` marks an unused slot.
      */
     ZyanU32 recursion_depth;
 } ZyrexBarrierContext;
 
+/**
+ * Defines the `ZyrexBarrierDenseEntry` struct.
+ *
+ * Both values are narrowed to 16 bits to keep the per-thread data small.
+ */
+typedef struct ZyrexBarrierDenseEntry_
+{
+    /**
+     * The current recursion depth.
+     */
+    ZyanU16 recursion_depth;
+    /**
+     * The lower 16 bits of the generation of the dense index the entry belongs to.
+     */
+    ZyanU16 generation;
+} ZyrexBarrierDenseEntry;
+
 /* ---------------------------------------------------------------------------------------------- */
+/* Trace ring                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+#ifdef ZYREX_BARRIER_TRACE
+
+/**
+ * Defines the `ZyrexBarrierTraceRing` struct.
+ *
+ * This struct is allocated once per thread and implements a single-producer single-consumer
+ * ring buffer. The owning thread is the only producer and advances `head`, the draining thread is
+ * the only consumer and advances `tail`.
+ */
+typedef struct ZyrexBarrierTraceRing_
+{
+    /**
+     * The next ring in the global ring list.
+     */
+    struct ZyrexBarrierTraceRing_* next;
+    /**
+     * The id of the owning thread.
+     */
+    ZyanThreadId thread_id;
+    /**
+     * A non-zero value signals that the owning thread exited and the ring can be released after
+     * it was drained.
+     */
+    volatile ZyanU64 is_orphaned;
+    /**
+     * The total number of records written by the producer.
+     */
+    volatile ZyanU64 head;
+    /**
+     * The total number of records dropped by the producer.
+     */
+    volatile ZyanU64 dropped;
+    /**
+     * Keeps the consumer index on a separate cache line.
+     */
+    ZyanU8 padding[64];
+    /**
+     * The total number of records read by the consumer.
+     */
+    volatile ZyanU64 tail;
+    /**
+     * The trace records.
+     */
+    ZyrexBarrierTraceRecord records[ZYREX_BARRIER_TRACE_RING_SIZE];
+} ZyrexBarrierTraceRing;
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread data                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Defines the `ZyrexBarrierThreadData` struct.
+ *
+ * This struct is allocated once per thread. Recursion depths for dense handles are stored in a
+ * flat array indexed by the handle value. All other handles are stored in an open-addressed
+ * (linear probing) table of barrier contexts that are currently entered by the thread.
+ */
+typedef struct ZyrexBarrierThreadData_
+{
+    /**
+     * The recursion depth and generation for each dense barrier handle.
+     */
+    ZyrexBarrierDenseEntry entries[ZYREX_BARRIER_DENSE_HANDLE_COUNT];
+
+#ifdef ZYREX_HOOK_STATISTICS
+
+    /**
+     * The lower 32 bits of the timestamp at which the outermost barrier for each dense handle was
+     * entered, or `0`, if the current invocation is not sampled.
+     *
+     * Latencies are measured modulo `2^32` ticks.
+     */
+    ZyanU32 timestamps[ZYREX_BARRIER_DENSE_HANDLE_COUNT];
+    /**
+     * The number of outermost barrier entries, used to determine the sampled invocations.
+     */
+    ZyanU32 sample_counter;
+
+#endif
+
+#ifdef ZYREX_BARRIER_TRACE
+
+    /**
+     * The trace ring of the thread, or `ZYAN_NULL`, if tracing is not available for the thread.
+     */
+    ZyrexBarrierTraceRing* trace_ring;
+    /**
+     * Signals that the allocation of the `trace_ring` has already been attempted.
+     */
+    ZyanBool is_trace_initialized;
+
+#endif
+
+    /**
+     * The number of used slots in the `contexts` table.
+     */
+    ZyanUSize count;
+    /**
+     * The barrier context table.
+     */
+    ZyrexBarrierContext contexts[ZYREX_BARRIER_TABLE_SIZE];
+} ZyrexBarrierThreadData;
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+#ifdef ZYREX_BARRIER_STATIC_TLS
+
+#if defined(ZYAN_MSVC)
+#   define ZYREX_THREAD_LOCAL __declspec(thread)
+#elif defined(ZYAN_GCC) || defined(ZYAN_CLANG)
+#   define ZYREX_THREAD_LOCAL __thread
+#else
+#   define ZYREX_THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * The barrier data of the current thread.
+ *
+ * The data is stored in static TLS which avoids the allocation on the first hooked call of each
+ * thread and the indirection through the dynamic TLS slot.
+ */
+static ZYREX_THREAD_LOCAL ZyrexBarrierThreadData g_barrier_thread_data;
+
+#else
+
+/**
+ * The TLS slot used by the barrier system.
+ */
+static ZyanThreadTlsIndex g_barrier_tls_index = 0;
+
+#endif
+
+#ifdef ZYREX_BARRIER_TRACE
+
+/**
+ * Contains global variables used by the tracing functions.
+ */
+static struct
+{
+    /**
+     * The head of the list of all trace rings.
+     *
+     * Producers only ever push new rings to the head of the list. Rings are removed by the
+     * consumer exclusively.
+     */
+    ZyrexBarrierTraceRing* volatile rings;
+    /**
+     * Signals that a thread is currently draining the trace rings.
+     */
+    volatile ZyanU32 is_draining;
+} g_barrier_trace_data =
+{
+    /* rings       */ ZYAN_NULL,
+    /* is_draining */ 0
+};
+
+#endif
 
 /* ============================================================================================== */
 /* Internal functions                                                                             */
 /* ============================================================================================== */
 
+#ifdef ZYREX_BARRIER_TRACE
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Atomic operations                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Loads the given value with acquire semantics.
+ *
+ * @param   value   A pointer to the value.
+ *
+ * @return  The loaded value.
+ */
+ZYAN_INLINE ZyanU64 ZyrexBarrierLoadAcquire(const volatile ZyanU64* value)
+{
+#if defined(ZYAN_MSVC)
+    // Volatile accesses have acquire/release semantics with the default `/volatile:ms` model
+    const ZyanU64 result = *value;
+    _ReadWriteBarrier();
+    return result;
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * Stores the given value with release semantics.
+ *
+ * @param   destination A pointer to the destination.
+ * @param   value       The value to store.
+ */
+ZYAN_INLINE void ZyrexBarrierStoreRelease(volatile ZyanU64* destination, ZyanU64 value)
+{
+#if defined(ZYAN_MSVC)
+    _ReadWriteBarrier();
+    *destination = value;
+#else
+    __atomic_store_n(destination, value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * Atomically replaces the value at `destination` with `value`, if it equals `comparand`.
+ *
+ * @param   destination A pointer to the destination.
+ * @param   comparand   The expected value.
+ * @param   value       The new value.
+ *
+ * @return  `ZYAN_TRUE`, if the value was replaced or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexBarrierCompareExchangePointer(void* volatile* destination,
+    void* comparand, void* value)
+{
+#if defined(ZYAN_MSVC)
+    return (_InterlockedCompareExchangePointer(destination, value, comparand) == comparand);
+#else
+    return __atomic_compare_exchange_n(destination, &comparand, value, ZYAN_FALSE,
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * Atomically replaces the value at `destination` with `value`.
+ *
+ * @param   destination A pointer to the destination.
+ * @param   value       The new value.
+ *
+ * @return  The previous value.
+ */
+ZYAN_INLINE ZyanU32 ZyrexBarrierExchange32(volatile ZyanU32* destination, ZyanU32 value)
+{
+#if defined(ZYAN_MSVC)
+    return (ZyanU32)_InterlockedExchange((volatile long*)destination, (long)value);
+#else
+    return __atomic_exchange_n(destination, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Tracing                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Allocates the trace ring of the calling thread and publishes it to the global ring list.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct of the calling thread.
+ *
+ * Tracing is permanently disabled for the calling thread, if the allocation fails.
+ */
+static void ZyrexBarrierTraceInitialize(ZyrexBarrierThreadData* data)
+{
+    ZYAN_ASSERT(data);
+    ZYAN_ASSERT(!data->is_trace_initialized);
+
+    data->is_trace_initialized = ZYAN_TRUE;
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexBarrierTraceRing* const ring = ZYAN_MALLOC(sizeof(ZyrexBarrierTraceRing));
+    if (!ring)
+    {
+        return;
+    }
+    ZYAN_MEMSET(ring, 0, sizeof(ZyrexBarrierTraceRing));
+
+    if (!ZYAN_SUCCESS(ZyanThreadGetCurrentThreadId(&ring->thread_id)))
+    {
+        ZYAN_FREE(ring);
+        return;
+    }
+
+    ZyrexBarrierTraceRing* head;
+    do
+    {
+        head = g_barrier_trace_data.rings;
+        ring->next = head;
+    } while (!ZyrexBarrierCompareExchangePointer((void* volatile*)&g_barrier_trace_data.rings,
+        head, ring));
+
+    data->trace_ring = ring;
+}
+
+/**
+ * Appends a record to the trace ring of the calling thread.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct of the calling thread.
+ * @param   handle  The barrier hook handle.
+ * @param   depth   The recursion depth of the invocation.
+ * @param   event   The event type.
+ */
+ZYAN_INLINE void ZyrexBarrierTraceWrite(ZyrexBarrierThreadData* data, ZyrexBarrierHandle handle,
+    ZyanU32 depth, ZyrexBarrierTraceEvent event)
+{
+    ZYAN_ASSERT(data);
+
+    if (!data->is_trace_initialized)
+    {
+        ZyrexBarrierTraceInitialize(data);
+    }
+
+    ZyrexBarrierTraceRing* const ring = data->trace_ring;
+    if (!ring)
+    {
+        return;
+    }
+
+    // The producer is the only writer of `head` and `dropped`
+    const ZyanU64 head = ring->head;
+    if (head - ZyrexBarrierLoadAcquire(&ring->tail) >= ZYREX_BARRIER_TRACE_RING_SIZE)
+    {
+        ZyrexBarrierStoreRelease(&ring->dropped, ring->dropped + 1);
+        return;
+    }
+
+    ZyrexBarrierTraceRecord* const record = &ring->records[head & ZYREX_BARRIER_TRACE_RING_MASK];
+    record->timestamp = ZyrexReadTimestampCounter();
+    record->handle = handle;
+    record->depth = depth;
+    record->event = event;
+
+    ZyrexBarrierStoreRelease(&ring->head, head + 1);
+}
+
+/**
+ * Passes all pending records of the given trace ring to the `callback`.
+ *
+ * @param   ring        A pointer to the `ZyrexBarrierTraceRing` struct.
+ * @param   callback    The callback.
+ * @param   context     The user-defined context.
+ *
+ * @return  `ZYAN_TRUE`, if the ring is empty after draining or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexBarrierTraceDrainRing(ZyrexBarrierTraceRing* ring,
+    ZyrexBarrierTraceCallback callback, void* context)
+{
+    ZYAN_ASSERT(ring);
+    ZYAN_ASSERT(callback);
+
+    const ZyanU64 head = ZyrexBarrierLoadAcquire(&ring->head);
+    const ZyanU64 tail = ring->tail;
+    if (head == tail)
+    {
+        return ZYAN_TRUE;
+    }
+
+    ZyrexBarrierTraceBatch batch;
+    batch.thread_id = ring->thread_id;
+    batch.dropped = ZyrexBarrierLoadAcquire(&ring->dropped);
+
+    // The pending records occupy at most two contiguous spans of the ring
+    ZyanU64 position = tail;
+    while (position != head)
+    {
+        const ZyanUSize index = (ZyanUSize)(position & ZYREX_BARRIER_TRACE_RING_MASK);
+        const ZyanU64 available = head - position;
+        const ZyanU64 contiguous = ZYREX_BARRIER_TRACE_RING_SIZE - index;
+
+        batch.records = &ring->records[index];
+        batch.count = (ZyanUSize)((available < contiguous) ? available : contiguous);
+        callback(&batch, context);
+
+        position += batch.count;
+    }
+
+    ZyrexBarrierStoreRelease(&ring->tail, head);
+
+    return (ZyrexBarrierLoadAcquire(&ring->head) == head);
+}
+
+/**
+ * Removes the given trace ring from the global ring list and releases it.
+ *
+ * @param   ring        A pointer to the `ZyrexBarrierTraceRing` struct.
+ * @param   previous    A pointer to the predecessor of the `ring` or `ZYAN_NULL`, if the `ring`
+ *                      was the head of the list.
+ *
+ * Must only be called by the consumer.
+ */
+static void ZyrexBarrierTraceReleaseRing(ZyrexBarrierTraceRing* ring,
+    ZyrexBarrierTraceRing* previous)
+{
+    ZYAN_ASSERT(ring);
+
+    if (!previous)
+    {
+        if (ZyrexBarrierCompareExchangePointer((void* volatile*)&g_barrier_trace_data.rings, ring,
+            ring->next))
+        {
+            // TODO: Replace with ZyanMemoryFree in the future
+            ZYAN_FREE(ring);
+            return;
+        }
+
+        // New rings have been pushed in the meantime
+        previous = g_barrier_trace_data.rings;
+        while (previous->next != ring)
+        {
+            previous = previous->next;
+        }
+    }
+
+    previous->next = ring->next;
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(ring);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+#endif
+
+#ifndef ZYREX_BARRIER_STATIC_TLS
+
 /* ---------------------------------------------------------------------------------------------- */
 /* TLS cleanup                                                                                    */
 /* ---------------------------------------------------------------------------------------------- */
@@ -76,28 +546,180 @@ typedef struct ZyrexBarrierContext_
  *
  * @param   data    The data currently stored in the TLS slot.
  */
-ZYAN_THREAD_DECLARE_TLS_CALLBACK(ZyrexBarrierTlsCleanup, ZyanVector, data)
+ZYAN_THREAD_DECLARE_TLS_CALLBACK(ZyrexBarrierTlsCleanup, ZyrexBarrierThreadData, data)
 {
     if (!data)
     {
         return;
     }
 
-    ZyanVectorDestroy(data);
+#ifdef ZYREX_BARRIER_TRACE
+    if (data->trace_ring)
+    {
+        // The ring is released by the consumer after the remaining records were drained
+        ZyrexBarrierStoreRelease(&data->trace_ring->is_orphaned, 1);
+    }
+#endif
 
     // TODO: Replace with ZyanMemoryFree in the future
     ZYAN_FREE(data);
 }
 
+#endif
+
 /* ---------------------------------------------------------------------------------------------- */
-/* Barrier context                                                                                */
+/* Thread data                                                                                    */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * Defines a comparison function for the `ZyrexBarrierContext` struct that uses the `id` field to
- * create an absolute order.
+ * Returns the barrier data of the calling thread.
+ *
+ * @param   data    Receives a pointer to the `ZyrexBarrierThreadData` struct of the calling
+ *                  thread.
+ * @param   create  Set `ZYAN_TRUE` to allocate the thread data, if it does not exist yet.
+ *
+ * @return  A zyan status code.
+ *
+ * The thread data is allocated only once per thread. If it does not exist and `create` is
+ * `ZYAN_FALSE`, `data` receives `ZYAN_NULL`.
+ *
+ * If `ZYREX_BARRIER_STATIC_TLS` is defined, the thread data always exists and `create` is
+ * ignored.
  */
-ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexBarrierCompareContext, ZyrexBarrierContext, id)
+static ZyanStatus ZyrexBarrierGetThreadData(ZyrexBarrierThreadData** data, ZyanBool create)
+{
+    ZYAN_ASSERT(data);
+
+#ifdef ZYREX_BARRIER_STATIC_TLS
+
+    ZYAN_UNUSED(create);
+
+    *data = &g_barrier_thread_data;
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void**)data));
+
+    if ((*data != ZYAN_NULL) || !create)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexBarrierThreadData* const value = ZYAN_MALLOC(sizeof(ZyrexBarrierThreadData));
+    if (!value)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMSET(value, 0, sizeof(ZyrexBarrierThreadData));
+
+    const ZyanStatus status = ZyanThreadTlsSetValue(g_barrier_tls_index, value);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_FREE(value);
+        return status;
+    }
+
+    *data = value;
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Barrier context table                                                                          */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Returns the home slot index of the given barrier `handle`.
+ *
+ * @param   handle  The barrier hook handle.
+ *
+ * @return  The home slot index of the given barrier `handle`.
+ */
+ZYAN_INLINE ZyanUSize ZyrexBarrierHash(ZyrexBarrierHandle handle)
+{
+    const ZyanU64 value = (ZyanU64)handle;
+
+    // Fibonacci hashing. The lower bits are discarded as code addresses are usually aligned
+    return (ZyanUSize)((((value >> 4) ^ (value >> 32)) * 0x9E3779B97F4A7C15ULL) >>
+        (64 - ZYREX_BARRIER_TABLE_BITS));
+}
+
+/**
+ * Searches the barrier context table for the given `handle`.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct.
+ * @param   handle  The barrier hook handle.
+ *
+ * @return  A pointer to the barrier context for the given `handle`, if found, or a pointer to the
+ *          unused slot at which the `handle` should be inserted if not.
+ *
+ * The table always contains at least one unused slot, which guarantees termination.
+ */
+ZYAN_INLINE ZyrexBarrierContext* ZyrexBarrierTableLookup(ZyrexBarrierThreadData* data,
+    ZyrexBarrierHandle handle)
+{
+    ZYAN_ASSERT(data);
+    ZYAN_ASSERT(data->count < ZYREX_BARRIER_TABLE_SIZE);
+
+    ZyanUSize index = ZyrexBarrierHash(handle);
+    while (ZYAN_TRUE)
+    {
+        ZyrexBarrierContext* const context = &data->contexts[index];
+        if ((context->recursion_depth == 0) || (context->id == handle))
+        {
+            return context;
+        }
+        index = (index + 1) & ZYREX_BARRIER_TABLE_MASK;
+    }
+}
+
+/**
+ * Removes the given barrier context from the table.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct.
+ * @param   context A pointer to the `ZyrexBarrierContext` to remove.
+ *
+ * Subsequent entries of the same probe sequence are shifted backwards to fill the gap, which
+ * keeps lookups correct without requiring tombstones.
+ */
+static void ZyrexBarrierTableRemove(ZyrexBarrierThreadData* data, ZyrexBarrierContext* context)
+{
+    ZYAN_ASSERT(data);
+    ZYAN_ASSERT(context);
+    ZYAN_ASSERT(data->count > 0);
+
+    ZyanUSize gap = (ZyanUSize)(context - data->contexts);
+    ZyanUSize index = gap;
+    while (ZYAN_TRUE)
+    {
+        index = (index + 1) & ZYREX_BARRIER_TABLE_MASK;
+
+        const ZyrexBarrierContext* const item = &data->contexts[index];
+        if (item->recursion_depth == 0)
+        {
+            break;
+        }
+
+        // Only move the item, if its home slot is not cyclically located in `(gap, index]`
+        const ZyanUSize home = ZyrexBarrierHash(item->id);
+        const ZyanBool is_reachable = (gap <= index)
+            ? ((home > gap) && (home <= index))
+            : ((home > gap) || (home <= index));
+        if (is_reachable)
+        {
+            continue;
+        }
+
+        data->contexts[gap] = *item;
+        gap = index;
+    }
+
+    data->contexts[gap].recursion_depth = 0;
+    --data->count;
+}
 
 /* ---------------------------------------------------------------------------------------------- */
 
@@ -111,12 +733,20 @@ ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexBarrierCompareContext, ZyrexBarrierContex
 
 ZyanStatus ZyrexBarrierSystemInitialize()
 {
+#ifdef ZYREX_BARRIER_STATIC_TLS
+    return ZYAN_STATUS_SUCCESS;
+#else
     return ZyanThreadTlsAlloc(&g_barrier_tls_index, (ZyanThreadTlsCallback)&ZyrexBarrierTlsCleanup);
+#endif
 }
 
 ZyanStatus ZyrexBarrierSystemShutdown()
 {
+#ifdef ZYREX_BARRIER_STATIC_TLS
+    return ZYAN_STATUS_SUCCESS;
+#else
     return ZyanThreadTlsFree(g_barrier_tls_index);
+#endif
 }
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -125,7 +755,33 @@ ZyanStatus ZyrexBarrierSystemShutdown()
 
 ZyrexBarrierHandle ZyrexBarrierGetHandle(const void* trampoline)
 {
-    return (ZyrexBarrierHandle)trampoline;
+    ZyanU32 index;
+    ZyanU32 generation;
+    if ((ZyrexTrampolineGetIndex(trampoline, &index, &generation) != ZYAN_STATUS_TRUE) ||
+        (index >= ZYREX_BARRIER_DENSE_HANDLE_COUNT))
+    {
+        return (ZyrexBarrierHandle)trampoline;
+    }
+
+    ZyrexBarrierThreadData* data;
+    if (!ZYAN_SUCCESS(ZyrexBarrierGetThreadData(&data, ZYAN_TRUE)))
+    {
+        return (ZyrexBarrierHandle)trampoline;
+    }
+
+    // The index might have been used by a hook that got removed while one of its callbacks was
+    // still running in the current thread
+    ZyrexBarrierDenseEntry* const entry = &data->entries[index];
+    if (entry->generation != (ZyanU16)generation)
+    {
+        entry->generation = (ZyanU16)generation;
+        entry->recursion_depth = 0;
+#ifdef ZYREX_HOOK_STATISTICS
+        data->timestamps[index] = 0;
+#endif
+    }
+
+    return (ZyrexBarrierHandle)index;
 }
 
 ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle)
@@ -135,79 +791,122 @@ ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle)
 
 ZyanStatus ZyrexBarrierTryEnterEx(ZyrexBarrierHandle handle, ZyanU32 max_recursion_depth)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexBarrierThreadData* data;
+    ZYAN_CHECK(ZyrexBarrierGetThreadData(&data, ZYAN_TRUE));
 
-    if (vector == ZYAN_NULL)
+    if (handle < ZYREX_BARRIER_DENSE_HANDLE_COUNT)
     {
-        // TODO: Replace with ZyanMemoryAlloc in the future
-        vector = ZYAN_MALLOC(sizeof(ZyanVector));
-        ZYAN_CHECK(ZyanVectorInit(vector, sizeof(ZyrexBarrierContext), 32, ZYAN_NULL));
-        ZYAN_CHECK(ZyanThreadTlsSetValue(g_barrier_tls_index, vector));
-    }
+        ZyanU16* const recursion_depth = &data->entries[handle].recursion_depth;
+        if ((*recursion_depth > max_recursion_depth) ||
+            (*recursion_depth == ZYREX_BARRIER_DENSE_MAX_RECURSION_DEPTH))
+        {
+            return ZYAN_STATUS_FALSE;
+        }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
+#ifdef ZYREX_HOOK_STATISTICS
+        if ((*recursion_depth == 0) &&
+            ((++data->sample_counter & (ZYREX_HOOK_STATISTICS_SAMPLE_RATE - 1)) == 0))
+        {
+            // The lowest bit is set to distinguish the timestamp from the `0` marker
+            data->timestamps[handle] = (ZyanU32)ZyrexReadTimestampCounter() | 1;
+        }
+#endif
+
+        ++*recursion_depth;
+
+#ifdef ZYREX_BARRIER_TRACE
+        ZyrexBarrierTraceWrite(data, handle, *recursion_depth, ZYREX_BARRIER_TRACE_EVENT_ENTER);
+#endif
+
+        return ZYAN_STATUS_TRUE;
+    }
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+    ZyrexBarrierContext* const context = ZyrexBarrierTableLookup(data, handle);
 
-    if (status == ZYAN_STATUS_TRUE)
+    if (context->recursion_depth != 0)
     {
-        ZyrexBarrierContext* const context =
-            (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
         if (context->recursion_depth > max_recursion_depth)
         {
             return ZYAN_STATUS_FALSE;
         }
 
         ++context->recursion_depth;
+
+#ifdef ZYREX_BARRIER_TRACE
+        ZyrexBarrierTraceWrite(data, handle, context->recursion_depth,
+            ZYREX_BARRIER_TRACE_EVENT_ENTER);
+#endif
+
         return ZYAN_STATUS_TRUE;
     }
 
-    context_element.recursion_depth = 1;
-    ZYAN_CHECK(ZyanVectorInsert(vector, found_index, &context_element));
+    // Always keep one slot unused to guarantee termination of the lookup
+    if (data->count == ZYREX_BARRIER_TABLE_SIZE - 1)
+    {
+        return ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
+
+    context->id = handle;
+    context->recursion_depth = 1;
+    ++data->count;
+
+#ifdef ZYREX_BARRIER_TRACE
+    ZyrexBarrierTraceWrite(data, handle, 1, ZYREX_BARRIER_TRACE_EVENT_ENTER);
+#endif
 
     return ZYAN_STATUS_TRUE;
 }
 
 ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexBarrierThreadData* data;
+    ZYAN_CHECK(ZyrexBarrierGetThreadData(&data, ZYAN_FALSE));
 
-    if (vector == ZYAN_NULL)
+    if (data == ZYAN_NULL)
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
+    if (handle < ZYREX_BARRIER_DENSE_HANDLE_COUNT)
+    {
+        ZyanU16* const recursion_depth = &data->entries[handle].recursion_depth;
+        if (*recursion_depth == 0)
+        {
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+#ifdef ZYREX_BARRIER_TRACE
+        ZyrexBarrierTraceWrite(data, handle, *recursion_depth, ZYREX_BARRIER_TRACE_EVENT_LEAVE);
+#endif
 
-    if (status != ZYAN_STATUS_TRUE)
-    {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        --*recursion_depth;
+
+#ifdef ZYREX_HOOK_STATISTICS
+        if ((*recursion_depth == 0) && (data->timestamps[handle] != 0))
+        {
+            ZyrexStatisticsRecordLatency((ZyanU32)handle,
+                (ZyanU32)((ZyanU32)ZyrexReadTimestampCounter() - data->timestamps[handle]));
+            data->timestamps[handle] = 0;
+        }
+#endif
+
+        return ZYAN_STATUS_TRUE;
     }
 
-    ZyrexBarrierContext* const context =
-        (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
+    ZyrexBarrierContext* const context = ZyrexBarrierTableLookup(data, handle);
     if (context->recursion_depth == 0)
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
+#ifdef ZYREX_BARRIER_TRACE
+    ZyrexBarrierTraceWrite(data, handle, context->recursion_depth,
+        ZYREX_BARRIER_TRACE_EVENT_LEAVE);
+#endif
+
     if (--context->recursion_depth == 0)
     {
-        ZYAN_CHECK(ZyanVectorDelete(vector, found_index));
+        ZyrexBarrierTableRemove(data, context);
     }
 
     return ZYAN_STATUS_TRUE;
@@ -219,34 +918,76 @@ ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle)
 
 ZyanStatus ZyrexBarrierGetRecursionDepth(ZyrexBarrierHandle handle, ZyanU32* current_depth)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexBarrierThreadData* data;
+    ZYAN_CHECK(ZyrexBarrierGetThreadData(&data, ZYAN_FALSE));
 
-    if (vector == ZYAN_NULL)
+    if (data == ZYAN_NULL)
     {
         *current_depth = 0;
         return ZYAN_STATUS_FALSE;
     }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
+    if (handle < ZYREX_BARRIER_DENSE_HANDLE_COUNT)
+    {
+        *current_depth = data->entries[handle].recursion_depth;
+        return (*current_depth != 0) ? ZYAN_STATUS_TRUE : ZYAN_STATUS_FALSE;
+    }
+
+    const ZyrexBarrierContext* const context = ZyrexBarrierTableLookup(data, handle);
+
+    *current_depth = context->recursion_depth;
+    return (context->recursion_depth != 0) ? ZYAN_STATUS_TRUE : ZYAN_STATUS_FALSE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Tracing                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+ZyanStatus ZyrexBarrierTraceDrain(ZyrexBarrierTraceCallback callback, void* context)
+{
+#ifdef ZYREX_BARRIER_TRACE
 
-    if (status == ZYAN_STATUS_TRUE)
+    if (!callback)
     {
-        const ZyrexBarrierContext* const context =
-            (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-        *current_depth = context->recursion_depth;
-        return ZYAN_STATUS_TRUE;
+    if (ZyrexBarrierExchange32(&g_barrier_trace_data.is_draining, 1) != 0)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyrexBarrierTraceRing* previous = ZYAN_NULL;
+    ZyrexBarrierTraceRing* ring = g_barrier_trace_data.rings;
+    while (ring)
+    {
+        ZyrexBarrierTraceRing* const next = ring->next;
+
+        // The orphan flag must be read before the final drain to not miss any trailing records
+        const ZyanBool is_orphaned = (ZyrexBarrierLoadAcquire(&ring->is_orphaned) != 0);
+        if (ZyrexBarrierTraceDrainRing(ring, callback, context) && is_orphaned)
+        {
+            ZyrexBarrierTraceReleaseRing(ring, previous);
+        } else
+        {
+            previous = ring;
+        }
+
+        ring = next;
     }
 
-    return ZYAN_STATUS_FALSE;
+    ZyrexBarrierExchange32(&g_barrier_trace_data.is_draining, 0);
+
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    ZYAN_UNUSED(callback);
+    ZYAN_UNUSED(context);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
 }
 
 /* ---------------------------------------------------------------------------------------------- */
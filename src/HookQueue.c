@@ -0,0 +1,404 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/API/Thread.h>
+#include <Zyrex/HookQueue.h>
+#include <Zyrex/Transaction.h>
+#include <Zyrex/Internal/Transaction.h>
+
+#ifdef ZYAN_WINDOWS
+#   include <Windows.h>
+#endif
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global hook queue data.
+ */
+static struct
+{
+    /**
+     * @brief   The most recently submitted request.
+     *
+     * The submitted requests form a lock-free stack, which is reversed by the committer to
+     * restore the submission order.
+     */
+    ZyrexHookRequest* volatile head;
+    /**
+     * @brief   Signals, if a thread is currently committing the queue.
+     */
+    volatile ZyanU32 is_committing;
+    /**
+     * @brief   The `ZyrexTransactionFlags` used to start the transaction of each batch.
+     */
+    volatile ZyanU32 transaction_flags;
+} g_queue_data =
+{
+    ZYAN_NULL, 0, ZYREX_TRANSACTION_FLAG_NONE
+};
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Queue                                                                                          */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Pushes the given `request` to the submission queue.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ */
+static void ZyrexHookQueuePush(ZyrexHookRequest* request)
+{
+    ZYAN_ASSERT(request);
+
+#if defined(ZYAN_MSVC)
+    for (;;)
+    {
+        ZyrexHookRequest* const head = g_queue_data.head;
+        request->next = head;
+        if (InterlockedCompareExchangePointer((volatile PVOID*)&g_queue_data.head, request,
+            head) == head)
+        {
+            break;
+        }
+    }
+#else
+    ZyrexHookRequest* head = __atomic_load_n(&g_queue_data.head, __ATOMIC_RELAXED);
+    do
+    {
+        request->next = head;
+    } while (!__atomic_compare_exchange_n(&g_queue_data.head, &head, request, ZYAN_TRUE,
+        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#endif
+}
+
+/**
+ * @brief   Removes all requests from the submission queue.
+ *
+ * @return  The first request in submission order or `ZYAN_NULL`, if the queue is empty.
+ */
+static ZyrexHookRequest* ZyrexHookQueueTakeAll(void)
+{
+#if defined(ZYAN_MSVC)
+    ZyrexHookRequest* request =
+        InterlockedExchangePointer((volatile PVOID*)&g_queue_data.head, ZYAN_NULL);
+#else
+    ZyrexHookRequest* request = __atomic_exchange_n(&g_queue_data.head, ZYAN_NULL,
+        __ATOMIC_ACQUIRE);
+#endif
+
+    ZyrexHookRequest* first = ZYAN_NULL;
+    while (request)
+    {
+        ZyrexHookRequest* const next = request->next;
+        request->next = first;
+        first = request;
+        request = next;
+    }
+
+    return first;
+}
+
+/**
+ * @brief   Checks, if the submission queue is empty.
+ *
+ * @return  `ZYAN_TRUE`, if the queue is empty, or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexHookQueueIsEmpty(void)
+{
+#if defined(ZYAN_MSVC)
+    return (g_queue_data.head == ZYAN_NULL);
+#else
+    return (__atomic_load_n(&g_queue_data.head, __ATOMIC_ACQUIRE) == ZYAN_NULL);
+#endif
+}
+
+/**
+ * @brief   Tries to become the committer of the queue.
+ *
+ * @return  `ZYAN_TRUE`, if the calling thread is the committer now, or `ZYAN_FALSE`, if another
+ *          thread is committing the queue.
+ */
+static ZyanBool ZyrexHookQueueAcquire(void)
+{
+#if defined(ZYAN_MSVC)
+    return (InterlockedCompareExchange((volatile LONG*)&g_queue_data.is_committing, 1, 0) == 0);
+#else
+    ZyanU32 expected = 0;
+    return __atomic_compare_exchange_n(&g_queue_data.is_committing, &expected, 1, ZYAN_FALSE,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief   Releases the committer role of the calling thread.
+ */
+static void ZyrexHookQueueRelease(void)
+{
+#if defined(ZYAN_MSVC)
+    InterlockedExchange((volatile LONG*)&g_queue_data.is_committing, 0);
+#else
+    __atomic_store_n(&g_queue_data.is_committing, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Requests                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Adds the operation of the given `request` to the current transaction.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexHookRequestApply(const ZyrexHookRequest* request)
+{
+    ZYAN_ASSERT(request);
+
+    switch (request->type)
+    {
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE:
+        return ZyrexInstallInlineHook(request->address, request->callback, request->trampoline);
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE:
+        return ZyrexRemoveInlineHook(request->trampoline);
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE_CHAINED:
+        return ZyrexInstallInlineHookChained(request->address, request->callback,
+            request->trampoline);
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE_CHAINED:
+        return ZyrexRemoveInlineHookChained(request->trampoline);
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_IMPORT:
+        return ZyrexInstallImportHook(request->address, request->callback, request->trampoline);
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_IMPORT:
+        return ZyrexRemoveImportHook(request->address);
+    default:
+        ZYAN_UNREACHABLE;
+    }
+}
+
+/**
+ * @brief   Marks the given `request` as completed and invokes its completion function.
+ *
+ * @param   request A pointer to the `ZyrexHookRequest` struct.
+ *
+ * The request must not be accessed afterwards, as its memory might be released by the waiting
+ * thread.
+ */
+static void ZyrexHookRequestComplete(ZyrexHookRequest* request)
+{
+    ZYAN_ASSERT(request);
+
+    if (request->completion)
+    {
+        request->completion(request);
+    }
+
+#if defined(ZYAN_MSVC)
+    InterlockedExchange8((volatile CHAR*)&request->is_completed, ZYAN_TRUE);
+#else
+    __atomic_store_n(&request->is_completed, ZYAN_TRUE, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief   Applies the given list of requests to the current transaction, commits it and
+ *          completes the requests.
+ *
+ * @param   requests    A pointer to the first `ZyrexHookRequest` struct in submission order.
+ *
+ * @return  A zyan status code.
+ *
+ * The transaction must have been started by the calling thread.
+ */
+static ZyanStatus ZyrexHookQueueCommitBatch(ZyrexHookRequest* requests)
+{
+    // Threads are only suspended once and only if any of the operations requires it
+    ZyanStatus status = ZyrexUpdateAllThreads();
+    if (ZYAN_SUCCESS(status))
+    {
+        for (ZyrexHookRequest* request = requests; request; request = request->next)
+        {
+            request->status = ZyrexHookRequestApply(request);
+        }
+        status = ZyrexTransactionCommit();
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_UNUSED(ZyrexTransactionAbort());
+    }
+
+    ZyrexHookRequest* request = requests;
+    while (request)
+    {
+        ZyrexHookRequest* const next = request->next;
+        if (ZYAN_SUCCESS(request->status))
+        {
+            request->status = status;
+        }
+        ZyrexHookRequestComplete(request);
+        request = next;
+    }
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZyrexHookQueueSubmit(ZyrexHookRequest* request)
+{
+    if (!request)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    switch (request->type)
+    {
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE:
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_INLINE_CHAINED:
+    case ZYREX_HOOK_REQUEST_TYPE_INSTALL_IMPORT:
+        if (!request->address || !request->callback || !request->trampoline)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        break;
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE:
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_INLINE_CHAINED:
+        if (!request->trampoline)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        break;
+    case ZYREX_HOOK_REQUEST_TYPE_REMOVE_IMPORT:
+        if (!request->address)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        break;
+    default:
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    request->status = ZYAN_STATUS_SUCCESS;
+    request->is_completed = ZYAN_FALSE;
+    ZyrexHookQueuePush(request);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexHookQueueSetTransactionFlags(ZyanU32 flags)
+{
+    if (flags & ~(ZyanU32)ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    g_queue_data.transaction_flags = flags;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexHookQueueCommit(void)
+{
+    for (;;)
+    {
+        if (!ZyrexHookQueueAcquire())
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+
+        ZyanStatus status = ZYAN_STATUS_SUCCESS;
+        while (!ZyrexHookQueueIsEmpty())
+        {
+            // The requests stay queued, if the transaction can not be started
+            status = ZyrexTransactionBeginEx(g_queue_data.transaction_flags);
+            if (!ZYAN_SUCCESS(status))
+            {
+                break;
+            }
+            status = ZyrexHookQueueCommitBatch(ZyrexHookQueueTakeAll());
+        }
+
+        ZyrexHookQueueRelease();
+
+        // Requests that were submitted after the last check might have missed the committer
+        if (!ZYAN_SUCCESS(status) || ZyrexHookQueueIsEmpty())
+        {
+            return status;
+        }
+    }
+}
+
+ZyanBool ZyrexHookQueueIsCompleted(const ZyrexHookRequest* request)
+{
+    if (!request)
+    {
+        return ZYAN_FALSE;
+    }
+
+#if defined(ZYAN_MSVC)
+    return request->is_completed;
+#else
+    return __atomic_load_n(&request->is_completed, __ATOMIC_ACQUIRE);
+#endif
+}
+
+ZyanStatus ZyrexHookQueueWait(const ZyrexHookRequest* request)
+{
+    if (!request)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // The queue can not be committed while the transaction of the current thread is in progress
+    if (!ZyrexHookQueueIsCompleted(request) && ZyrexTransactionIsOwnedByCurrentThread())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    while (!ZyrexHookQueueIsCompleted(request))
+    {
+        // Failing to commit is not fatal, as the requests stay queued
+        ZYAN_UNUSED(ZyrexHookQueueCommit());
+        if (!ZyrexHookQueueIsCompleted(request))
+        {
+            ZYAN_UNUSED(ZyanThreadYield());
+        }
+    }
+
+    return request->status;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,540 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zyrex/Internal/ImportTable.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#   include <TlHelp32.h>
+#elif defined(ZYAN_LINUX)
+#   include <link.h>
+#   include <sys/mman.h>
+#elif !defined(ZYAN_POSIX)
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+#ifdef ZYAN_LINUX
+
+/**
+ * @brief   Defines the `ZyrexImportTableSearch` struct.
+ *
+ * Passes the search parameters to the `dl_iterate_phdr` callback.
+ */
+typedef struct ZyrexImportTableSearch_
+{
+    /**
+     * @brief   The address of the function.
+     */
+    const void* function;
+    /**
+     * @brief   The callback address.
+     */
+    const void* callback;
+    /**
+     * @brief   The `ZyanVector<ZyrexImportSlot>` instance that receives the table entries.
+     */
+    ZyanVector* slots;
+    /**
+     * @brief   The status code of the search.
+     */
+    ZyanStatus status;
+} ZyrexImportTableSearch;
+
+#endif
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Adds a table entry to the given `slots` list, if it is not already contained.
+ *
+ * @param   slots       A pointer to the `ZyanVector<ZyrexImportSlot>` instance.
+ * @param   address     The address of the table entry.
+ * @param   size        The size of the table entry.
+ * @param   original    The original value of the table entry.
+ * @param   replacement The value that redirects the table entry to the callback.
+ * @param   protection  The original protection of the memory page that contains the entry.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTablePushSlot(ZyanVector* slots, void* address, ZyanU8 size,
+    ZyanUPointer original, ZyanUPointer replacement, ZyanU32 protection)
+{
+    ZYAN_ASSERT(slots);
+    ZYAN_ASSERT(address);
+
+    // Relocation tables might overlap, which yields the same entry more than once
+    for (ZyanUSize i = 0; i < slots->size; ++i)
+    {
+        const ZyrexImportSlot* const item = ZyanVectorGet(slots, i);
+        ZYAN_ASSERT(item);
+
+        if (item->address == address)
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    const ZyrexImportSlot slot = { address, size, original, replacement, protection };
+    return ZyanVectorPushBack(slots, &slot);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Portable Executable                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Collects all entries of the given import address table that refer to the given
+ *          `function`.
+ *
+ * @param   thunk       A pointer to the first entry of the import address table.
+ * @param   function    The address of the function.
+ * @param   callback    The callback address.
+ * @param   slots       A pointer to the `ZyanVector<ZyrexImportSlot>` instance.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTableCollectThunks(IMAGE_THUNK_DATA* thunk, const void* function,
+    const void* callback, ZyanVector* slots)
+{
+    ZYAN_ASSERT(thunk);
+
+    for (; thunk->u1.Function; ++thunk)
+    {
+        if ((ZyanUPointer)thunk->u1.Function == (ZyanUPointer)function)
+        {
+            ZYAN_CHECK(ZyrexImportTablePushSlot(slots, &thunk->u1.Function, sizeof(void*),
+                (ZyanUPointer)function, (ZyanUPointer)callback, 0));
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Collects all import and export table entries of the module at the given `base`
+ *          address that refer to the given `function`.
+ *
+ * @param   base        The base address of the module.
+ * @param   function    The address of the function.
+ * @param   callback    The callback address.
+ * @param   slots       A pointer to the `ZyanVector<ZyrexImportSlot>` instance.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTableCollectModule(ZyanUPointer base, const void* function,
+    const void* callback, ZyanVector* slots)
+{
+    const IMAGE_DOS_HEADER* const dos_header = (const IMAGE_DOS_HEADER*)base;
+    if (dos_header->e_magic != IMAGE_DOS_SIGNATURE)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+    const IMAGE_NT_HEADERS* const nt_headers =
+        (const IMAGE_NT_HEADERS*)(base + (ZyanUPointer)dos_header->e_lfanew);
+    if ((nt_headers->Signature != IMAGE_NT_SIGNATURE) ||
+        (nt_headers->OptionalHeader.Magic != IMAGE_NT_OPTIONAL_HDR_MAGIC))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const IMAGE_DATA_DIRECTORY* const directories = nt_headers->OptionalHeader.DataDirectory;
+    const DWORD directory_count = nt_headers->OptionalHeader.NumberOfRvaAndSizes;
+
+    // Import address tables
+    if ((directory_count > IMAGE_DIRECTORY_ENTRY_IMPORT) &&
+        directories[IMAGE_DIRECTORY_ENTRY_IMPORT].VirtualAddress)
+    {
+        const IMAGE_IMPORT_DESCRIPTOR* descriptor = (const IMAGE_IMPORT_DESCRIPTOR*)(base +
+            directories[IMAGE_DIRECTORY_ENTRY_IMPORT].VirtualAddress);
+        for (; descriptor->Name; ++descriptor)
+        {
+            ZYAN_CHECK(ZyrexImportTableCollectThunks(
+                (IMAGE_THUNK_DATA*)(base + descriptor->FirstThunk), function, callback, slots));
+        }
+    }
+
+    // Delay-load import address tables (entries are only found after they have been bound)
+    if ((directory_count > IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT) &&
+        directories[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT].VirtualAddress)
+    {
+        const IMAGE_DELAYLOAD_DESCRIPTOR* descriptor = (const IMAGE_DELAYLOAD_DESCRIPTOR*)(base +
+            directories[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT].VirtualAddress);
+        for (; descriptor->DllNameRVA; ++descriptor)
+        {
+            // Descriptors of very old linkers contain absolute addresses
+            if (!descriptor->Attributes.RvaBased)
+            {
+                continue;
+            }
+            ZYAN_CHECK(ZyrexImportTableCollectThunks(
+                (IMAGE_THUNK_DATA*)(base + descriptor->ImportAddressTableRVA), function,
+                callback, slots));
+        }
+    }
+
+    // Export address table. The entries contain module relative addresses, which is why the
+    // callback has to be located above the module base
+    if ((directory_count > IMAGE_DIRECTORY_ENTRY_EXPORT) &&
+        directories[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress &&
+        ((ZyanUPointer)callback > base) && ((ZyanUPointer)callback - base <= 0xFFFFFFFF))
+    {
+        const IMAGE_EXPORT_DIRECTORY* const exports = (const IMAGE_EXPORT_DIRECTORY*)(base +
+            directories[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress);
+        DWORD* const functions = (DWORD*)(base + exports->AddressOfFunctions);
+        for (DWORD i = 0; i < exports->NumberOfFunctions; ++i)
+        {
+            if (functions[i] && (base + functions[i] == (ZyanUPointer)function))
+            {
+                ZYAN_CHECK(ZyrexImportTablePushSlot(slots, &functions[i], sizeof(DWORD),
+                    functions[i], (ZyanUPointer)callback - base, 0));
+            }
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Executable and Linkable Format                                                                 */
+/* ---------------------------------------------------------------------------------------------- */
+
+#ifdef ZYAN_LINUX
+
+/**
+ * @brief   Returns the address of a pointer in the dynamic section of the given object.
+ *
+ * @param   base    The base address of the object.
+ * @param   value   The value of the dynamic section entry.
+ *
+ * @return  The absolute address.
+ *
+ * Some loaders relocate the pointers in the dynamic section in place, while others do not.
+ */
+static ZyanUPointer ZyrexImportTableGetDynamicPointer(ZyanUPointer base, ZyanUPointer value)
+{
+    return (value < base) ? base + value : value;
+}
+
+/**
+ * @brief   Returns the protection of the memory page that contains the given `address`, based on
+ *          the program headers of the given object.
+ *
+ * @param   info    A pointer to the `dl_phdr_info` struct of the object.
+ * @param   address The address.
+ *
+ * @return  The page protection.
+ */
+static ZyanU32 ZyrexImportTableGetProtection(const struct dl_phdr_info* info,
+    ZyanUPointer address)
+{
+    ZYAN_ASSERT(info);
+
+    ZyanU32 protection = PROT_READ | PROT_WRITE;
+    for (ZyanU16 i = 0; i < info->dlpi_phnum; ++i)
+    {
+        const ElfW(Phdr)* const header = &info->dlpi_phdr[i];
+        const ZyanUPointer begin = info->dlpi_addr + header->p_vaddr;
+        if ((address < begin) || (address >= begin + header->p_memsz))
+        {
+            continue;
+        }
+
+        // The relocation read-only segment is protected after the object has been relocated
+        if (header->p_type == PT_GNU_RELRO)
+        {
+            return PROT_READ;
+        }
+        if (header->p_type == PT_LOAD)
+        {
+            protection = ((header->p_flags & PF_R) ? PROT_READ  : 0) |
+                         ((header->p_flags & PF_W) ? PROT_WRITE : 0) |
+                         ((header->p_flags & PF_X) ? PROT_EXEC  : 0);
+        }
+    }
+
+    return protection;
+}
+
+/**
+ * @brief   Collects all `GOT` entries of the given relocation table that refer to the function
+ *          of the given `search`.
+ *
+ * @param   search      A pointer to the `ZyrexImportTableSearch` struct.
+ * @param   info        A pointer to the `dl_phdr_info` struct of the object.
+ * @param   table       The address of the relocation table.
+ * @param   size        The size of the relocation table.
+ * @param   entry_size  The size of a single relocation entry.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTableCollectRelocations(const ZyrexImportTableSearch* search,
+    const struct dl_phdr_info* info, ZyanUPointer table, ZyanUSize size, ZyanUSize entry_size)
+{
+    ZYAN_ASSERT(search);
+    ZYAN_ASSERT(info);
+
+    if (!table || !entry_size)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    for (ZyanUSize offset = 0; offset + entry_size <= size; offset += entry_size)
+    {
+        // `Elf_Rel` and `Elf_Rela` share the same leading fields
+        const ElfW(Rel)* const relocation = (const ElfW(Rel)*)(table + offset);
+#if defined(ZYAN_X64)
+        const ZyanUSize type = ELF64_R_TYPE(relocation->r_info);
+        if ((type != R_X86_64_JUMP_SLOT) && (type != R_X86_64_GLOB_DAT))
+#else
+        const ZyanUSize type = ELF32_R_TYPE(relocation->r_info);
+        if ((type != R_386_JMP_SLOT) && (type != R_386_GLOB_DAT))
+#endif
+        {
+            continue;
+        }
+
+        const ZyanUPointer address = info->dlpi_addr + relocation->r_offset;
+        if (*(const ZyanUPointer*)address != (ZyanUPointer)search->function)
+        {
+            continue;
+        }
+        ZYAN_CHECK(ZyrexImportTablePushSlot(search->slots, (void*)address, sizeof(void*),
+            (ZyanUPointer)search->function, (ZyanUPointer)search->callback,
+            ZyrexImportTableGetProtection(info, address)));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Collects all `GOT` entries of the given object that refer to the function of the
+ *          given search.
+ *
+ * @param   info    A pointer to the `dl_phdr_info` struct of the object.
+ * @param   size    The size of the `dl_phdr_info` struct.
+ * @param   data    A pointer to the `ZyrexImportTableSearch` struct.
+ *
+ * @return  `0` to continue the iteration or `1` to stop it, if an error occured.
+ */
+static int ZyrexImportTableCollectObject(struct dl_phdr_info* info, size_t size, void* data)
+{
+    ZYAN_ASSERT(info);
+    ZYAN_ASSERT(data);
+    ZYAN_UNUSED(size);
+
+    ZyrexImportTableSearch* const search = (ZyrexImportTableSearch*)data;
+    const ZyanUPointer base = info->dlpi_addr;
+
+    const ElfW(Dyn)* dynamic = ZYAN_NULL;
+    for (ZyanU16 i = 0; i < info->dlpi_phnum; ++i)
+    {
+        if (info->dlpi_phdr[i].p_type == PT_DYNAMIC)
+        {
+            dynamic = (const ElfW(Dyn)*)(base + info->dlpi_phdr[i].p_vaddr);
+            break;
+        }
+    }
+    if (!dynamic)
+    {
+        return 0;
+    }
+
+    ZyanUPointer rel = 0;
+    ZyanUSize rel_size = 0;
+    ZyanUSize rel_entry_size = sizeof(ElfW(Rel));
+    ZyanUPointer rela = 0;
+    ZyanUSize rela_size = 0;
+    ZyanUSize rela_entry_size = sizeof(ElfW(Rela));
+    ZyanUPointer jmprel = 0;
+    ZyanUSize jmprel_size = 0;
+    ZyanUSize jmprel_entry_size = sizeof(ElfW(Rela));
+    for (; dynamic->d_tag != DT_NULL; ++dynamic)
+    {
+        switch (dynamic->d_tag)
+        {
+        case DT_REL:
+            rel = ZyrexImportTableGetDynamicPointer(base, dynamic->d_un.d_ptr);
+            break;
+        case DT_RELSZ:
+            rel_size = dynamic->d_un.d_val;
+            break;
+        case DT_RELENT:
+            rel_entry_size = dynamic->d_un.d_val;
+            break;
+        case DT_RELA:
+            rela = ZyrexImportTableGetDynamicPointer(base, dynamic->d_un.d_ptr);
+            break;
+        case DT_RELASZ:
+            rela_size = dynamic->d_un.d_val;
+            break;
+        case DT_RELAENT:
+            rela_entry_size = dynamic->d_un.d_val;
+            break;
+        case DT_JMPREL:
+            jmprel = ZyrexImportTableGetDynamicPointer(base, dynamic->d_un.d_ptr);
+            break;
+        case DT_PLTRELSZ:
+            jmprel_size = dynamic->d_un.d_val;
+            break;
+        case DT_PLTREL:
+            jmprel_entry_size =
+                (dynamic->d_un.d_val == DT_REL) ? sizeof(ElfW(Rel)) : sizeof(ElfW(Rela));
+            break;
+        default:
+            break;
+        }
+    }
+
+    search->status = ZyrexImportTableCollectRelocations(search, info, jmprel, jmprel_size,
+        jmprel_entry_size);
+    if (ZYAN_SUCCESS(search->status))
+    {
+        search->status = ZyrexImportTableCollectRelocations(search, info, rela, rela_size,
+            rela_entry_size);
+    }
+    if (ZYAN_SUCCESS(search->status))
+    {
+        search->status = ZyrexImportTableCollectRelocations(search, info, rel, rel_size,
+            rel_entry_size);
+    }
+
+    return ZYAN_SUCCESS(search->status) ? 0 : 1;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+ZyanStatus ZyrexImportTableCollectSlots(const void* function, const void* callback,
+    ZyanVector* slots)
+{
+    ZYAN_ASSERT(function);
+    ZYAN_ASSERT(callback);
+    ZYAN_ASSERT(slots);
+
+#if defined(ZYAN_WINDOWS)
+
+    HANDLE h_snapshot;
+    do
+    {
+        h_snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, GetCurrentProcessId());
+    } while ((h_snapshot == INVALID_HANDLE_VALUE) && (GetLastError() == ERROR_BAD_LENGTH));
+    if (h_snapshot == INVALID_HANDLE_VALUE)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    MODULEENTRY32W module;
+    ZYAN_MEMSET(&module, 0, sizeof(module));
+    module.dwSize = sizeof(module);
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    if (Module32FirstW(h_snapshot, &module))
+    {
+        do
+        {
+            status = ZyrexImportTableCollectModule((ZyanUPointer)module.modBaseAddr, function,
+                callback, slots);
+        } while (ZYAN_SUCCESS(status) && Module32NextW(h_snapshot, &module));
+    }
+
+    if (!CloseHandle(h_snapshot) && ZYAN_SUCCESS(status))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    return status;
+
+#elif defined(ZYAN_LINUX)
+
+    ZyrexImportTableSearch search;
+    search.function = function;
+    search.callback = callback;
+    search.slots = slots;
+    search.status = ZYAN_STATUS_SUCCESS;
+
+    dl_iterate_phdr(&ZyrexImportTableCollectObject, &search);
+
+    return search.status;
+
+#else
+
+    ZYAN_UNUSED(function);
+    ZYAN_UNUSED(callback);
+    ZYAN_UNUSED(slots);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
+}
+
+ZyanBool ZyrexImportTableExchangeSlot(const ZyrexImportSlot* slot, ZyanUPointer expected,
+    ZyanUPointer desired)
+{
+    ZYAN_ASSERT(slot);
+    ZYAN_ASSERT((slot->size == sizeof(ZyanU32)) || (slot->size == sizeof(ZyanUPointer)));
+
+#if defined(ZYAN_MSVC)
+    if (slot->size == sizeof(ZyanU32))
+    {
+        return (InterlockedCompareExchange((volatile LONG*)slot->address, (LONG)desired,
+            (LONG)expected) == (LONG)expected);
+    }
+    return (InterlockedCompareExchangePointer((volatile PVOID*)slot->address, (PVOID)desired,
+        (PVOID)expected) == (PVOID)expected);
+#else
+    if (slot->size == sizeof(ZyanU32))
+    {
+        ZyanU32 value = (ZyanU32)expected;
+        return __atomic_compare_exchange_n((ZyanU32*)slot->address, &value, (ZyanU32)desired,
+            ZYAN_FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    }
+    ZyanUPointer value = expected;
+    return __atomic_compare_exchange_n((ZyanUPointer*)slot->address, &value, desired, ZYAN_FALSE,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* ============================================================================================== */
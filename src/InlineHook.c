@@ -36,119 +36,116 @@
 /* Runtime thread migration                                                                       */
 /* ---------------------------------------------------------------------------------------------- */
 
-#ifdef ZYAN_WINDOWS
-
-ZyanStatus ZyrexMigrateThread(HANDLE thread_handle, const void* source, ZyanUSize source_length,
-    const void* destination, ZyanUSize destination_length,
-    const ZyrexInstructionTranslationMap* translation_map,
-    ZyrexThreadMigrationDirection direction)
+ZyanBool ZyrexMigrateInstructionPointer(const ZyrexThreadMigrationRange* ranges, ZyanUSize count,
+    ZyanUPointer* ip)
 {
-    ZYAN_UNUSED(destination_length);
-
-    ZYAN_ASSERT(thread_handle);
-    ZYAN_ASSERT(source);
-    ZYAN_ASSERT(source_length);
-    ZYAN_ASSERT(destination);
-    ZYAN_ASSERT(destination_length);
-    ZYAN_ASSERT(translation_map);
-
-    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZYAN_ASSERT(ranges || !count);
+    ZYAN_ASSERT(ip);
 
-    const DWORD suspend_count = SuspendThread(thread_handle);
-    if (suspend_count == (DWORD)(-1))
+    // Find the last range that starts at or below the instruction pointer
+    ZyanUSize lo = 0;
+    ZyanUSize hi = count;
+    while (lo < hi)
     {
-        CloseHandle(thread_handle);
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        const ZyanUSize mid = lo + (hi - lo) / 2;
+        if (ranges[mid].source <= *ip)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
     }
-
-    CONTEXT context = { 0 };
-    //ZYAN_MEMSET(&context, 0, sizeof(context));
-    context.ContextFlags = CONTEXT_CONTROL;
-    if (!GetThreadContext(thread_handle, &context))
+    if (lo == 0)
     {
-        status = ZYAN_STATUS_BAD_SYSTEMCALL;
-        goto CleanupAndResume;
+        return ZYAN_FALSE;
     }
 
-#if defined(ZYAN_X64)
-    const ZyanUPointer current_ip = context.Rip;
-#elif defined(ZYAN_X86)
-    const ZyanUPointer current_ip = context.Eip;
-#else
-#   error "Unsupported architecture detected"
-#endif
-    if ((current_ip < (ZyanUPointer)source) || (current_ip > (ZyanUPointer)source + source_length))
+    const ZyrexThreadMigrationRange* const range = &ranges[lo - 1];
+    if (*ip >= range->source + range->source_length)
     {
-        goto CleanupAndResume;
+        return ZYAN_FALSE;
     }
 
-    const ZyanUPointer source_offset = (ZyanUPointer)source - current_ip;
+    const ZyanUSize offset = (ZyanUSize)(*ip - range->source);
+    const ZyrexInstructionTranslationMap* const translation_map = range->translation_map;
     for (ZyanUSize i = 0; i < translation_map->count; ++i)
     {
-        switch (direction)
+        const ZyrexInstructionTranslationItem* const item = &translation_map->items[i];
+        switch (range->direction)
         {
         case ZYREX_THREAD_MIGRATION_DIRECTION_SRC_DST:
-            if (translation_map->items[i].offset_source == (ZyanU8)source_offset)
+            if (item->offset_source == offset)
             {
-#if defined(ZYAN_X64)
-                context.Rip = (ZyanUPointer)destination + translation_map->items[i].offset_destination;
-#elif defined(ZYAN_X86)
-                context.Eip = (ZyanUPointer)destination + translation_map->items[i].offset_destination;
-#else
-#   error "Unsupported architecture detected"
-#endif
-
-                if (!SetThreadContext(thread_handle, &context))
-                {
-                    status = ZYAN_STATUS_BAD_SYSTEMCALL;
-                }
-
-                goto CleanupAndResume;
+                *ip = range->destination + item->offset_destination;
+                return ZYAN_TRUE;
             }
             break;
         case ZYREX_THREAD_MIGRATION_DIRECTION_DST_SRC:
-            if (translation_map->items[i].offset_destination == (ZyanU8)source_offset)
+            if (item->offset_destination == offset)
             {
+                *ip = range->destination + item->offset_source;
+                return ZYAN_TRUE;
+            }
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    }
+
+    // The instruction pointer is located inside a rewritten instruction sequence that has no
+    // equivalent in the source code
+    return ZYAN_FALSE;
+}
+
+#ifdef ZYAN_WINDOWS
+
+ZyanStatus ZyrexMigrateThread(HANDLE thread_handle, const ZyrexThreadMigrationRange* ranges,
+    ZyanUSize count)
+{
+    ZYAN_ASSERT(thread_handle);
+    ZYAN_ASSERT(ranges || !count);
+
+    if (!count)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    CONTEXT context;
+    ZYAN_MEMSET(&context, 0, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL;
+    if (!GetThreadContext(thread_handle, &context))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
 #if defined(ZYAN_X64)
-                context.Rip = (ZyanUPointer)destination + translation_map->items[i].offset_source;
+    ZyanUPointer ip = context.Rip;
 #elif defined(ZYAN_X86)
-                context.Eip = (ZyanUPointer)destination + translation_map->items[i].offset_source;
+    ZyanUPointer ip = context.Eip;
 #else
 #   error "Unsupported architecture detected"
 #endif
 
-                if (!SetThreadContext(thread_handle, &context))
-                {
-                    status = ZYAN_STATUS_BAD_SYSTEMCALL;
-                }
-
-                goto CleanupAndResume;
-            }
-            break;
-        default:
-            ZYAN_UNREACHABLE;
-        }
+    if (!ZyrexMigrateInstructionPointer(ranges, count, &ip))
+    {
+        return ZYAN_STATUS_FALSE;
     }
 
-    // This should never happen
-    ZYAN_UNREACHABLE;
+#if defined(ZYAN_X64)
+    context.Rip = ip;
+#elif defined(ZYAN_X86)
+    context.Eip = ip;
+#else
+#   error "Unsupported architecture detected"
+#endif
 
-CleanupAndResume:
-    while (ZYAN_TRUE)
+    if (!SetThreadContext(thread_handle, &context))
     {
-        const DWORD value = ResumeThread(thread_handle);
-        if (value == (DWORD)(-1))
-        {
-            CloseHandle(thread_handle);
-            return ZYAN_STATUS_BAD_SYSTEMCALL;
-        }
-        if (value <= suspend_count + 1)
-        {
-            break;
-        }
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
     }
 
-    return status;
+    return ZYAN_STATUS_TRUE;
 }
 
 #endif
@@ -27,7 +27,6 @@
 #include <Zycore/LibC.h>
 #include <Zycore/Status.h>
 #include <Zycore/Types.h>
-#include <Zycore/Vector.h>
 #include <Zydis/Zydis.h>
 #include <Zyrex/Internal/Relocation.h>
 
@@ -35,58 +34,6 @@
 /* Enums and types                                                                                */
 /* ============================================================================================== */
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Analyzed instruction                                                                           */
-/* ---------------------------------------------------------------------------------------------- */
-
-/**
- * @brief   Defines the `ZyrexAnalyzedInstruction` struct.
- */
-typedef struct ZyrexAnalyzedInstruction_
-{
-    /**
-     * @brief   The address of the instruction relative to the start of the source buffer.
-     */
-    ZyanUSize address_offset;
-    /**
-     * @brief   The absolute runtime/memory address of the instruction.
-     */
-    ZyanUPointer address;
-    /**
-     * @brief   The `ZydisDecodedInstruction` struct of the analyzed instruction.
-     */
-    ZydisDecodedInstruction instruction;
-    /**
-     * @brief   Signals, if the instruction refers to a target address using a relative offset.
-     */
-    ZyanBool has_relative_target;
-    /**
-     * @brief   Signals, if the target address referred by the relative offset is not inside the
-     *          analyzed code chunk.
-     */
-    ZyanBool has_external_target;
-    /**
-     * @brief   Signals, if this instruction is targeted by at least one instruction from inside
-     *          the analyzed code chunk.
-     */
-    ZyanBool is_internal_target;
-    /**
-     * @brief   The absolute target address of the instruction calculated from the relative offset,
-     *          if applicable.
-     */
-    ZyanU64 absolute_target_address;
-    /**
-     * @brief   Contains the ids of all instructions inside the analyzed code chunk that are
-     *          targeting this instruction using a relative offset.
-     */
-    ZyanVector/*<ZyanU8>*/ incoming;
-    /**
-     * @brief   The id of an instruction inside the analyzed code chunk which is targeted by
-     *          this instruction using a relative offset, or `-1` if not applicable.
-     */
-    ZyanU8 outgoing;
-} ZyrexAnalyzedInstruction;
-
 /* ---------------------------------------------------------------------------------------------- */
 /* Relocation context                                                                             */
 /* ---------------------------------------------------------------------------------------------- */
@@ -101,10 +48,10 @@ typedef struct ZyrexRelocationContext_
      */
     ZyanUSize bytes_to_reloc;
     /**
-     * @brief   Contains a `ZyrexAnalyzedInstruction` struct for each instruction in the source
-     *          buffer.
+     * @brief   A pointer to the analysis of the source code. Contains a
+     *          `ZyrexAnalyzedInstruction` struct for each instruction in the source buffer.
      */
-    ZyanVector/*<ZyrexAnalyzedInstruction>*/ instructions;
+    const ZyrexCodeAnalysis* analysis;
     /**
      * @brief   A pointer to the source buffer.
      */
@@ -121,10 +68,22 @@ typedef struct ZyrexRelocationContext_
      * @brief   The maximum amount of bytes that can be safely written to the destination buffer.
      */
     ZyanUSize destination_length;
+    /**
+     * @brief   The distance between the destination buffer and the address the relocated code
+     *          is executed at.
+     *
+     * This value is non-zero, if the destination buffer is a writable alias of a dual-mapped
+     * trampoline-region.
+     */
+    ZyanUPointer destination_offset;
     /**
      * @brief   The instruction translation map.
      */
     ZyrexInstructionTranslationMap* translation_map;
+    /**
+     * @brief   Receives the fixups of the relocated code or `ZYAN_NULL`.
+     */
+    ZyrexRelocationFixups* fixups;
     /**
      * @brief   The number of instructions read from the source buffer.
      */
@@ -146,136 +105,68 @@ typedef struct ZyrexRelocationContext_
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
-/* Internal functions                                                                             */
+/* Globals                                                                                        */
 /* ============================================================================================== */
 
-/* ---------------------------------------------------------------------------------------------- */
-/* ZyrexAnalyzedInstruction                                                                       */
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Finalizes the given `ZyrexAnalyzedInstruction` struct.
- *
- * @param   item    A pointer to the `ZyrexAnalyzedInstruction` struct.
+ * @brief   Contains global relocation API data.
  */
-static void ZyrexAnalyzedInstructionDestroy(ZyrexAnalyzedInstruction* item)
+static struct
 {
-    ZYAN_ASSERT(item);
+    /**
+     * @brief   Signals, if the relocation API is initialized.
+     */
+    ZyanBool is_initialized;
+    /**
+     * @brief   The shared instruction decoder.
+     *
+     * The decoder is configured once and never modified afterwards.
+     */
+    ZydisDecoder decoder;
+} g_relocation_data =
+{
+    ZYAN_FALSE
+};
 
-    if (item->is_internal_target)
-    {
-        ZyanVectorDestroy(&item->incoming);   
-    }
-}
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
 
 /* ---------------------------------------------------------------------------------------------- */
 /* Instruction analysis                                                                           */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Analyzes the code in the source buffer and updates the relocation-context.
- *
- * @param   buffer              A pointer to the buffer that contains the code to analyze.
- * @param   length              The length of the buffer.
- * @param   bytes_to_analyze    The minimum number of bytes to analyze. More bytes might get
- *                              accessed on demand to keep individual instructions intact.
- * @param   instructions        Returns a new `ZyanVector` instance which contains all analyzed
- *                              instructions.
- *                              The vector needs to manually get destroyed by calling
- *                              `ZyanVectorDestroy` when no longer needed.
- * @param   bytes_read          Returns the exact amount of bytes read from the buffer.
+ * @brief   Returns the shared instruction decoder.
+ *
+ * @param   decoder Receives a pointer to the shared `ZydisDecoder` instance.
  *
  * @return  A zyan status code.
+ *
+ * The decoder is initialized on the first call and operates in minimal mode, as the relocation
+ * only requires the instruction length, the raw instruction bytes and the relative attributes.
  */
-static ZyanStatus ZyrexAnalyzeCode(const void* buffer, ZyanUSize length, 
-    ZyanUSize bytes_to_analyze, ZyanVector/*<ZyrexAnalyzedInstruction>*/* instructions,
-    ZyanUSize* bytes_read)
+static ZyanStatus ZyrexGetDecoder(const ZydisDecoder** decoder)
 {
-    ZYAN_ASSERT(buffer);
-    ZYAN_ASSERT(length);
-    ZYAN_ASSERT(bytes_to_analyze);
+    ZYAN_ASSERT(decoder);
 
-    ZydisDecoder decoder;
+    if (!g_relocation_data.is_initialized)
+    {
 #if defined(ZYAN_X86)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+        ZYAN_CHECK(ZydisDecoderInit(&g_relocation_data.decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32,
+            ZYDIS_STACK_WIDTH_32));
 #elif defined(ZYAN_X64)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+        ZYAN_CHECK(ZydisDecoderInit(&g_relocation_data.decoder, ZYDIS_MACHINE_MODE_LONG_64,
+            ZYDIS_STACK_WIDTH_64));
 #else
 #   error "Unsupported architecture detected"
 #endif
-
-    ZYAN_CHECK(ZyanVectorInit(instructions, sizeof(ZyrexAnalyzedInstruction), 
-        ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT, 
-        (ZyanMemberProcedure)&ZyrexAnalyzedInstructionDestroy));
-
-    // First pass:
-    //   - Determine exact amount of instructions and instruction bytes
-    //   - Decode all instructions and calculate relative target address for instructions with
-    //     relative offsets
-    //
-    ZyanUSize offset = 0;
-    while (offset < bytes_to_analyze)
-    {
-        ZyrexAnalyzedInstruction item;
-
-        ZYAN_CHECK(ZydisDecoderDecodeInstruction(&decoder, ZYAN_NULL, 
-            (const ZyanU8*)buffer + offset, length - offset, &item.instruction));
-
-        item.address_offset = offset;
-        item.address = (ZyanUPointer)(const ZyanU8*)buffer + offset;
-        item.has_relative_target = (item.instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
-            ? ZYAN_TRUE
-            : ZYAN_FALSE;
-        item.has_external_target = item.has_relative_target;
-        item.absolute_target_address = 0;
-        if (item.has_relative_target)
-        {
-            ZYAN_CHECK(ZyrexCalcAbsoluteAddress(&item.instruction, 
-                (ZyanU64)buffer + offset, &item.absolute_target_address));    
-        }
-        item.is_internal_target = ZYAN_FALSE;
-        item.outgoing = (ZyanU8)(-1);
-        ZYAN_CHECK(ZyanVectorPushBack(instructions, &item));
-
-        offset += item.instruction.length;
+        ZYAN_CHECK(ZydisDecoderEnableMode(&g_relocation_data.decoder, ZYDIS_DECODER_MODE_MINIMAL,
+            ZYAN_TRUE));
+        g_relocation_data.is_initialized = ZYAN_TRUE;
     }
 
-    ZYAN_ASSERT(offset >= bytes_to_analyze);
-    *bytes_read = offset;
-
-    // Second pass:
-    //   - Find internal outgoing target for instructions with relative offsets
-    //   - Find internal incoming targets from instructions with relative offsets
-    //
-    for (ZyanUSize i = 0; i < instructions->size; ++i)
-    {
-        ZyrexAnalyzedInstruction* const current = ZyanVectorGetMutable(instructions, i);
-        ZYAN_ASSERT(current);
-
-        for (ZyanUSize j = 0; j < instructions->size; ++j)
-        {
-            ZyrexAnalyzedInstruction* const item = ZyanVectorGetMutable(instructions, j);
-            ZYAN_ASSERT(item);
-
-            if (item->has_relative_target && (item->absolute_target_address == current->address))
-            {
-                // The `item` instruction targets the `current` instruction
-                item->has_external_target = ZYAN_FALSE;
-                item->outgoing = (ZyanU8)i;
-
-                // The `current` instruction is an internal target of the `item` instruction
-                if (!current->is_internal_target)
-                {
-                    current->is_internal_target = ZYAN_TRUE;
-                    ZYAN_CHECK(ZyanVectorInit(&current->incoming, sizeof(ZyanU8), 2, 
-                        ZYAN_NULL));    
-                }
-                const ZyanU8 value = (ZyanU8)j;
-                ZYAN_CHECK(ZyanVectorPushBack(&current->incoming, &value));
-            }
-        }
-    }
-    
+    *decoder = &g_relocation_data.decoder;
     return ZYAN_STATUS_SUCCESS;
 }
 
@@ -347,6 +238,27 @@ static ZyanBool ZyrexIsRelativeMemoryInstruction(const ZydisDecodedInstruction*
         : ZYAN_FALSE;
 }
 
+/**
+ * @brief   Returns the absolute target address of the given instruction as seen from the
+ *          destination buffer.
+ *
+ * @param   context     A pointer to the `ZyrexRelocationContext` struct.
+ * @param   instruction A pointer to the `ZyrexAnalyzedInstruction` struct.
+ *
+ * @return  The absolute target address shifted by the `destination_offset`.
+ *
+ * Relative offsets are calculated against the destination buffer. Shifting the target by the
+ * same distance as the buffer yields the offsets required at the execution address.
+ */
+ZYAN_INLINE ZyanU64 ZyrexGetExternalTargetAddress(const ZyrexRelocationContext* context,
+    const ZyrexAnalyzedInstruction* instruction)
+{
+    ZYAN_ASSERT(context);
+    ZYAN_ASSERT(instruction);
+
+    return instruction->absolute_target_address + context->destination_offset;
+}
+
 /**
  * @brief   Checks if the given relative branch instruction needs to be rewritten in order to
  *          reach the destination address.
@@ -372,8 +284,8 @@ static ZyanBool ZyrexShouldRewriteBranchInstruction(ZyrexRelocationContext* cont
     {
     case 8:
     {
-        const ZyanI64 distance = (ZyanI64)(instruction->absolute_target_address - source_address - 
-            instruction->instruction.length);
+        const ZyanI64 distance = (ZyanI64)(ZyrexGetExternalTargetAddress(context, instruction) -
+            source_address - instruction->instruction.length);
         if ((distance < ZYAN_INT8_MIN) || (distance > ZYAN_INT8_MAX))
         {
             return ZYAN_TRUE;
@@ -382,8 +294,8 @@ static ZyanBool ZyrexShouldRewriteBranchInstruction(ZyrexRelocationContext* cont
     }
     case 16:
     {
-        const ZyanI64 distance = (ZyanI64)(instruction->absolute_target_address - source_address -
-            instruction->instruction.length);
+        const ZyanI64 distance = (ZyanI64)(ZyrexGetExternalTargetAddress(context, instruction) -
+            source_address - instruction->instruction.length);
         if ((distance < ZYAN_INT16_MIN) || (distance > ZYAN_INT16_MAX))
         {
             return ZYAN_TRUE;
@@ -392,8 +304,8 @@ static ZyanBool ZyrexShouldRewriteBranchInstruction(ZyrexRelocationContext* cont
     }
     case 32:
     {
-        const ZyanI64 distance = (ZyanI64)(instruction->absolute_target_address - source_address -
-            instruction->instruction.length);
+        const ZyanI64 distance = (ZyanI64)(ZyrexGetExternalTargetAddress(context, instruction) -
+            source_address - instruction->instruction.length);
         if ((distance < ZYAN_INT32_MIN) || (distance > ZYAN_INT32_MAX))
         {
             return ZYAN_TRUE;
@@ -463,6 +375,34 @@ static void ZyrexUpdateRelocationContext(ZyrexRelocationContext* context, ZyanUS
     context->bytes_written += length;
 }
 
+/**
+ * @brief   Adds a fixup for a relative offset with an external target to the relocation context.
+ *
+ * @param   context         A pointer to the `ZyrexRelocationContext` struct.
+ * @param   offset_address  The address of the relative offset field.
+ * @param   size            The size of the relative offset field in bytes.
+ * @param   base_address    The address the relative offset is based on.
+ * @param   target_address  The absolute target address.
+ */
+static void ZyrexAddRelocationFixup(ZyrexRelocationContext* context, const void* offset_address,
+    ZyanU8 size, ZyanUPointer base_address, ZyanUPointer target_address)
+{
+    ZYAN_ASSERT(context);
+
+    if (!context->fixups)
+    {
+        return;
+    }
+
+    ZYAN_ASSERT(context->fixups->count < ZYAN_ARRAY_LENGTH(context->fixups->items));
+
+    ZyrexRelocationFixup* const item = &context->fixups->items[context->fixups->count++];
+    item->offset = (ZyanU8)((const ZyanU8*)offset_address - (const ZyanU8*)context->destination);
+    item->size = size;
+    item->base = (ZyanU8)(base_address - (ZyanUPointer)context->destination);
+    item->target_address = target_address;
+}
+
 /**
  * @brief   Relocates a single common instruction (without a relative offset) and updates the
  *          relocation-context.
@@ -568,7 +508,11 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
                 (ZyanU8)context->bytes_written + instruction->instruction.length);
 
             // Generate `JMP` to `1` branch
-            ZyrexWriteRelativeJump(address, (ZyanUPointer)instruction->absolute_target_address);
+            ZyrexWriteRelativeJump(address,
+                (ZyanUPointer)ZyrexGetExternalTargetAddress(context, instruction));
+            ZyrexAddRelocationFixup(context, address + 1, 4,
+                (ZyanUPointer)address + ZYREX_SIZEOF_RELATIVE_JUMP,
+                (ZyanUPointer)instruction->absolute_target_address);
             ZyrexUpdateRelocationContext(context, 2, (ZyanU8)context->bytes_read,
                 (ZyanU8)context->bytes_written + instruction->instruction.length + 2);
 
@@ -623,7 +567,9 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
         // Write relative offset
         *(ZyanI32*)(address) = 
             ZyrexCalculateRelativeOffset(4, (ZyanUPointer)address, 
-                (ZyanUPointer)instruction->absolute_target_address);
+                (ZyanUPointer)ZyrexGetExternalTargetAddress(context, instruction));
+        ZyrexAddRelocationFixup(context, address, 4, (ZyanUPointer)address + 4,
+            (ZyanUPointer)instruction->absolute_target_address);
 
         // Update relocation context
         ZyrexUpdateRelocationContext(context, length, (ZyanU8)context->bytes_read, 
@@ -641,7 +587,7 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
     // Update the relative offset for the new instruction position
     const ZyanI32 value = ZyrexCalculateRelativeOffset(0,
         (ZyanUPointer)context->destination + context->bytes_written,
-        (ZyanUPointer)instruction->absolute_target_address);
+        (ZyanUPointer)ZyrexGetExternalTargetAddress(context, instruction));
 
     switch (instruction->instruction.raw.imm[0].size)
     {
@@ -651,6 +597,9 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
     default:
         ZYAN_UNREACHABLE;
     }
+    ZyrexAddRelocationFixup(context, offset_address, instruction->instruction.raw.imm[0].size / 8,
+        (ZyanUPointer)context->destination + context->bytes_written,
+        (ZyanUPointer)instruction->absolute_target_address);
 
     return ZYAN_STATUS_SUCCESS;
 }
@@ -684,7 +633,7 @@ static ZyanStatus ZyrexRelocateRelativeMemoryInstruction(ZyrexRelocationContext*
         // Update the relative offset for the new instruction position
         const ZyanI32 value = ZyrexCalculateRelativeOffset(0, 
             (ZyanUPointer)context->destination + context->bytes_written, 
-            (ZyanUPointer)instruction->absolute_target_address);
+            (ZyanUPointer)ZyrexGetExternalTargetAddress(context, instruction));
 
         switch (instruction->instruction.raw.disp.size)
         {
@@ -694,6 +643,9 @@ static ZyanStatus ZyrexRelocateRelativeMemoryInstruction(ZyrexRelocationContext*
         default:
             ZYAN_UNREACHABLE;
         }
+        ZyrexAddRelocationFixup(context, offset_address, instruction->instruction.raw.disp.size / 8,
+            (ZyanUPointer)context->destination + context->bytes_written,
+            (ZyanUPointer)instruction->absolute_target_address);
 
         return ZYAN_STATUS_SUCCESS;
     }
@@ -766,7 +718,7 @@ static ZyanStatus ZyrexGetRelocatedInstructionOffset(ZyrexRelocationContext* con
 {
     ZYAN_ASSERT(context);
     ZYAN_ASSERT(offset_destination);
-    ZYAN_ASSERT(context->instructions.size <= context->translation_map->count);
+    ZYAN_ASSERT(context->analysis->instruction_count <= context->translation_map->count);
 
     for (ZyanUSize i = 0; i < context->translation_map->count; ++i)
     {
@@ -797,10 +749,9 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
 {
     ZYAN_ASSERT(context);
 
-    for (ZyanUSize i = 0; i < context->instructions.size; ++i)
+    for (ZyanUSize i = 0; i < context->analysis->instruction_count; ++i)
     {
-        const ZyrexAnalyzedInstruction* const instruction = 
-            ZyanVectorGet(&context->instructions, i);
+        const ZyrexAnalyzedInstruction* const instruction = &context->analysis->instructions[i];
 
         if (!instruction->has_relative_target || instruction->has_external_target)
         {
@@ -834,9 +785,9 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
             &offset_instruction));
 
         // Lookup the offset of the destination instruction in the destination buffer
-        const ZyrexAnalyzedInstruction* const destination = 
-            ZyanVectorGet(&context->instructions, instruction->outgoing);
-        ZYAN_ASSERT(destination);
+        ZYAN_ASSERT(instruction->outgoing < context->analysis->instruction_count);
+        const ZyrexAnalyzedInstruction* const destination =
+            &context->analysis->instructions[instruction->outgoing];
         ZyanU8 offset_destination;
         ZYAN_CHECK(ZyrexGetRelocatedInstructionOffset(context, (ZyanU8)destination->address_offset, 
             &offset_destination));
@@ -864,44 +815,167 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
 /* Functions                                                                                      */
 /* ============================================================================================== */
 
-ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length, 
-    ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
-    ZyanUSize* bytes_written)
+ZyanStatus ZyrexAnalyzeCode(const void* buffer, ZyanUSize length, ZyanUSize bytes_to_analyze,
+    ZyrexCodeAnalysis* analysis)
 {
-    ZYAN_ASSERT(source);
-    ZYAN_ASSERT(source_length);
+    ZYAN_ASSERT(buffer);
+    ZYAN_ASSERT(length);
+    ZYAN_ASSERT(bytes_to_analyze);
+    ZYAN_ASSERT(analysis);
+
+    const ZydisDecoder* decoder;
+    ZYAN_CHECK(ZyrexGetDecoder(&decoder));
+
+    ZyrexAnalyzedInstruction* const instructions = analysis->instructions;
+    analysis->buffer = buffer;
+    analysis->length = length;
+    analysis->bytes_to_analyze = bytes_to_analyze;
+    analysis->has_relative_targets = ZYAN_FALSE;
+    analysis->address_lo = (ZyanUPointer)(-1);
+    analysis->address_hi = 0;
+
+    // First pass:
+    //   - Determine exact amount of instructions and instruction bytes
+    //   - Decode all instructions and calculate relative target address for instructions with
+    //     relative offsets
+    //
+    ZyanU8 n = 0;
+    ZyanUSize offset = 0;
+    while (offset < bytes_to_analyze)
+    {
+        if (n == ZYREX_RELOCATION_MAX_INSTRUCTION_COUNT)
+        {
+            return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+        }
+
+        ZyrexAnalyzedInstruction* const item = &instructions[n];
+
+        ZYAN_CHECK(ZydisDecoderDecodeInstruction(decoder, ZYAN_NULL, 
+            (const ZyanU8*)buffer + offset, length - offset, &item->instruction));
+
+        item->address_offset = offset;
+        item->address = (ZyanUPointer)(const ZyanU8*)buffer + offset;
+        item->has_relative_target = (item->instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
+            ? ZYAN_TRUE
+            : ZYAN_FALSE;
+        item->has_external_target = item->has_relative_target;
+        item->absolute_target_address = 0;
+        if (item->has_relative_target)
+        {
+            ZYAN_CHECK(ZyrexCalcAbsoluteAddress(&item->instruction, 
+                (ZyanU64)buffer + offset, &item->absolute_target_address));    
+
+            analysis->has_relative_targets = ZYAN_TRUE;
+            if (item->absolute_target_address < analysis->address_lo)
+            {
+                analysis->address_lo = (ZyanUPointer)item->absolute_target_address;
+            }
+            if (item->absolute_target_address > analysis->address_hi)
+            {
+                analysis->address_hi = (ZyanUPointer)item->absolute_target_address;
+            }
+        }
+        item->is_internal_target = ZYAN_FALSE;
+        item->incoming = 0;
+        item->outgoing = (ZyanU8)(-1);
+        ++n;
+
+        offset += item->instruction.length;
+    }
+
+    ZYAN_ASSERT(offset >= bytes_to_analyze);
+    analysis->bytes_read = offset;
+    analysis->instruction_count = n;
+
+    // Second pass:
+    //   - Find internal outgoing target for instructions with relative offsets
+    //   - Find internal incoming targets from instructions with relative offsets
+    //
+    // The instructions are sorted by address, which allows to lookup the target instruction by
+    // binary search
+    const ZyanU64 begin = (ZyanU64)(ZyanUPointer)buffer;
+    const ZyanU64 end = begin + offset;
+    for (ZyanU8 i = 0; i < n; ++i)
+    {
+        ZyrexAnalyzedInstruction* const item = &instructions[i];
+        if (!item->has_relative_target || (item->absolute_target_address < begin) ||
+            (item->absolute_target_address >= end))
+        {
+            continue;
+        }
+
+        ZyanU8 lo = 0;
+        ZyanU8 hi = n;
+        while (lo < hi)
+        {
+            const ZyanU8 mid = (ZyanU8)((lo + hi) / 2);
+            if (instructions[mid].address < item->absolute_target_address)
+            {
+                lo = (ZyanU8)(mid + 1);
+            } else
+            {
+                hi = mid;
+            }
+        }
+        if ((lo == n) || (instructions[lo].address != item->absolute_target_address))
+        {
+            // The target address points into the middle of an instruction
+            continue;
+        }
+
+        // The `item` instruction targets the `target` instruction
+        item->has_external_target = ZYAN_FALSE;
+        item->outgoing = lo;
+
+        // The `target` instruction is an internal target of the `item` instruction
+        ZyrexAnalyzedInstruction* const target = &instructions[lo];
+        target->is_internal_target = ZYAN_TRUE;
+        target->incoming |= (ZyanU32)1 << i;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexRelocateCode(const ZyrexCodeAnalysis* analysis, ZyrexTrampolineChunk* trampoline,
+    ZyrexRelocationFixups* fixups, ZyanUSize* bytes_read, ZyanUSize* bytes_written)
+{
+    ZYAN_ASSERT(analysis);
     ZYAN_ASSERT(trampoline);
-    ZYAN_ASSERT(min_bytes_to_reloc);
     ZYAN_ASSERT(bytes_read);
     ZYAN_ASSERT(bytes_written);
 
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(trampoline);
+
     ZyrexRelocationContext context;
-    context.bytes_to_reloc       = 0;
-    context.source               = source;
-    context.source_length        = source_length;
-    context.destination          = &trampoline->code_buffer;
+    context.bytes_to_reloc       = analysis->bytes_read;
+    context.analysis             = analysis;
+    context.source               = analysis->buffer;
+    context.source_length        = analysis->length;
+    context.destination          = &writable->code_buffer;
     context.destination_length   = ZYREX_TRAMPOLINE_MAX_CODE_SIZE + 
                                    ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS;
-    context.translation_map      = &trampoline->translation_map;
+    context.destination_offset   = (ZyanUPointer)writable - (ZyanUPointer)trampoline;
+    context.translation_map      = &ZyrexTrampolineGetChunkInfo(trampoline)->translation_map;
+    context.fixups               = fixups;
     context.instructions_read    = 0;
     context.instructions_written = 0;
     context.bytes_read           = 0;
     context.bytes_written        = 0;
 
-    ZYAN_CHECK(ZyrexAnalyzeCode(source, source_length, min_bytes_to_reloc, &context.instructions, 
-        &context.bytes_to_reloc));
-    ZYAN_ASSERT(context.instructions.data);
+    if (fixups)
+    {
+        fixups->count = 0;
+    }
 
     // Relocate instructions
-    for (ZyanUSize i = 0; i < context.instructions.size; ++i)
+    for (ZyanUSize i = 0; i < analysis->instruction_count; ++i)
     {
         // The code buffer is full
         ZYAN_ASSERT(context.bytes_written < context.destination_length);
         // The translation map is full
         ZYAN_ASSERT(context.instructions_read < ZYAN_ARRAY_LENGTH(context.translation_map->items));
 
-        const ZyrexAnalyzedInstruction* const item = ZyanVectorGet(&context.instructions, i);
-        ZYAN_ASSERT(item);
+        const ZyrexAnalyzedInstruction* const item = &analysis->instructions[i];
 
         if (item->has_relative_target)
         {
@@ -0,0 +1,835 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zycore/Vector.h>
+#include <Zyrex/Internal/RelocationCache.h>
+#include <Zyrex/Internal/Utils.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <fcntl.h>
+#   include <stdio.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation cache                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexRelocationCache` struct.
+ */
+struct ZyrexRelocationCache_
+{
+    /**
+     * @brief   The path of the cache file.
+     */
+    char* path;
+    /**
+     * @brief   The base address of the module.
+     */
+    ZyanUPointer module_base;
+    /**
+     * @brief   The size of the module image.
+     */
+    ZyanUSize module_size;
+    /**
+     * @brief   The user-defined key that identifies the module build.
+     */
+    ZyanU64 module_key;
+    /**
+     * @brief   The mapped view of the cache file or `ZYAN_NULL`, if no valid file is mapped.
+     */
+    void* view;
+    /**
+     * @brief   The size of the mapped view.
+     */
+    ZyanUSize view_size;
+    /**
+     * @brief   The sorted entries of the mapped cache file.
+     */
+    const ZyrexRelocationCacheEntry* entries;
+    /**
+     * @brief   The number of items in the `entries` array.
+     */
+    ZyanUSize entry_count;
+    /**
+     * @brief   Contains a sorted list of all entries that have been added since the cache file
+     *          was mapped.
+     */
+    ZyanVector/*<ZyrexRelocationCacheEntry>*/ pending;
+};
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global relocation cache API data.
+ *
+ * Thread-safety is implicitly guaranteed by the transactional API as only one transaction can be
+ * started at a time.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the relocation cache API is initialized.
+     */
+    ZyanBool is_initialized;
+    /**
+     * @brief   Contains a list of all opened relocation caches.
+     */
+    ZyanVector/*<ZyrexRelocationCache*>*/ caches;
+} g_relocation_cache_data =
+{
+    ZYAN_FALSE, ZYAN_VECTOR_INITIALIZER
+};
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Compares two `ZyrexRelocationCacheEntry` items by their `rva` and
+ *          `bytes_to_analyze` fields.
+ *
+ * @param   left    A pointer to the first entry.
+ * @param   right   A pointer to the second entry.
+ *
+ * @return  Returns `0` if both entries have the same key, a value less than zero if the first
+ *          entry is ordered before the second one, or a value greater than zero if not.
+ */
+static ZyanI32 ZyrexCompareRelocationCacheEntry(const ZyrexRelocationCacheEntry* left,
+    const ZyrexRelocationCacheEntry* right)
+{
+    ZYAN_ASSERT(left);
+    ZYAN_ASSERT(right);
+
+    if (left->rva != right->rva)
+    {
+        return (left->rva < right->rva) ? -1 : 1;
+    }
+    if (left->bytes_to_analyze != right->bytes_to_analyze)
+    {
+        return (left->bytes_to_analyze < right->bytes_to_analyze) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Returns the relocation cache of the module that contains the given `address`.
+ *
+ * @param   address The address.
+ *
+ * @return  A pointer to the `ZyrexRelocationCache` struct or `ZYAN_NULL`, if no cache is opened
+ *          for the module.
+ */
+static ZyrexRelocationCache* ZyrexRelocationCacheFind(ZyanUPointer address)
+{
+    if (!g_relocation_cache_data.is_initialized)
+    {
+        return ZYAN_NULL;
+    }
+
+    for (ZyanUSize i = 0; i < g_relocation_cache_data.caches.size; ++i)
+    {
+        ZyrexRelocationCache* const cache =
+            *(ZyrexRelocationCache**)ZyanVectorGet(&g_relocation_cache_data.caches, i);
+        if ((address >= cache->module_base) &&
+            (address - cache->module_base < cache->module_size))
+        {
+            return cache;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/**
+ * @brief   Checks, if the given cache entry is consistent.
+ *
+ * @param   entry   A pointer to the `ZyrexRelocationCacheEntry` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the entry is consistent or `ZYAN_FALSE`, if not.
+ *
+ * Entries are read from a file and are not trusted to be well-formed.
+ */
+static ZyanBool ZyrexRelocationCacheIsEntryValid(const ZyrexRelocationCacheEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+
+    if ((entry->original_code_size == 0) ||
+        (entry->original_code_size > ZYAN_ARRAY_LENGTH(entry->original_code)) ||
+        (entry->original_code_size < entry->bytes_to_analyze) ||
+        (entry->code_size > ZYAN_ARRAY_LENGTH(entry->code) - ZYREX_SIZEOF_ABSOLUTE_JUMP) ||
+        (entry->translation_count > ZYAN_ARRAY_LENGTH(entry->translations)) ||
+        (entry->fixup_count > ZYAN_ARRAY_LENGTH(entry->fixups)))
+    {
+        return ZYAN_FALSE;
+    }
+
+    for (ZyanUSize i = 0; i < entry->fixup_count; ++i)
+    {
+        const ZyrexRelocationCacheFixup* const fixup = &entry->fixups[i];
+        if ((fixup->offset + 4 > entry->code_size) || (fixup->base > entry->code_size))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    return ZYAN_TRUE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Cache file                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Maps the cache file of the given relocation cache into memory.
+ *
+ * @param   cache   A pointer to the `ZyrexRelocationCache` struct.
+ *
+ * The cache is treated as empty, if the file does not exist, can not be mapped or does not match
+ * the module key, the architecture or the file format version.
+ */
+static void ZyrexRelocationCacheMap(ZyrexRelocationCache* cache)
+{
+    ZYAN_ASSERT(cache);
+    ZYAN_ASSERT(!cache->view);
+
+    cache->entries = ZYAN_NULL;
+    cache->entry_count = 0;
+
+#if defined(ZYAN_WINDOWS)
+
+    const HANDLE file = CreateFileA(cache->path, GENERIC_READ, FILE_SHARE_READ, ZYAN_NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, ZYAN_NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (size.QuadPart < sizeof(ZyrexRelocationCacheHeader)) ||
+        ((ZyanU64)size.QuadPart > ZYAN_USIZE_MAX))
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    const HANDLE mapping = CreateFileMappingA(file, ZYAN_NULL, PAGE_READONLY, 0, 0, ZYAN_NULL);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return;
+    }
+
+    // The view keeps the file mapping alive
+    void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+    {
+        return;
+    }
+    const ZyanUSize view_size = (ZyanUSize)size.QuadPart;
+
+#elif defined(ZYAN_POSIX)
+
+    const int file = open(cache->path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) || (info.st_size < (off_t)sizeof(ZyrexRelocationCacheHeader)))
+    {
+        close(file);
+        return;
+    }
+
+    // The mapping stays valid after closing the file descriptor
+    const ZyanUSize view_size = (ZyanUSize)info.st_size;
+    void* const view = mmap(ZYAN_NULL, view_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED)
+    {
+        return;
+    }
+
+#endif
+
+    cache->view = view;
+    cache->view_size = view_size;
+
+    const ZyrexRelocationCacheHeader* const header = (const ZyrexRelocationCacheHeader*)view;
+    if ((header->signature != ZYREX_RELOCATION_CACHE_SIGNATURE) ||
+        (header->version != ZYREX_RELOCATION_CACHE_VERSION) ||
+        (header->address_width != sizeof(void*) * 8) ||
+        (header->entry_size != sizeof(ZyrexRelocationCacheEntry)) ||
+        (header->module_key != cache->module_key) ||
+        (header->entry_count > (view_size - sizeof(ZyrexRelocationCacheHeader)) /
+            sizeof(ZyrexRelocationCacheEntry)))
+    {
+        return;
+    }
+
+    cache->entries = (const ZyrexRelocationCacheEntry*)(header + 1);
+    cache->entry_count = header->entry_count;
+}
+
+/**
+ * @brief   Unmaps the cache file of the given relocation cache.
+ *
+ * @param   cache   A pointer to the `ZyrexRelocationCache` struct.
+ */
+static void ZyrexRelocationCacheUnmap(ZyrexRelocationCache* cache)
+{
+    ZYAN_ASSERT(cache);
+
+    if (cache->view)
+    {
+#if defined(ZYAN_WINDOWS)
+        UnmapViewOfFile(cache->view);
+#elif defined(ZYAN_POSIX)
+        munmap(cache->view, cache->view_size);
+#endif
+    }
+
+    cache->view = ZYAN_NULL;
+    cache->view_size = 0;
+    cache->entries = ZYAN_NULL;
+    cache->entry_count = 0;
+}
+
+/**
+ * @brief   Atomically replaces the file at the given `path` with the given data.
+ *
+ * @param   path    The path of the file.
+ * @param   data    A pointer to the data.
+ * @param   size    The size of the data.
+ *
+ * @return  A zyan status code.
+ *
+ * The data is written to a temporary file first, which then replaces the original file. Other
+ * processes that currently have the original file mapped are not affected.
+ */
+static ZyanStatus ZyrexRelocationCacheWriteFile(const char* path, const void* data,
+    ZyanUSize size)
+{
+    ZYAN_ASSERT(path);
+    ZYAN_ASSERT(data);
+
+    const ZyanUSize length = ZYAN_STRLEN(path);
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    char* const temp_path = ZYAN_MALLOC(length + 5);
+    if (!temp_path)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMCPY(temp_path, path, length);
+    ZYAN_MEMCPY(temp_path + length, ".tmp", 5);
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    const ZyanU8* buffer = (const ZyanU8*)data;
+
+#if defined(ZYAN_WINDOWS)
+
+    const HANDLE file = CreateFileA(temp_path, GENERIC_WRITE, 0, ZYAN_NULL, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL, ZYAN_NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        ZYAN_FREE(temp_path);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    while (size > 0)
+    {
+        const DWORD chunk = (size > 0x40000000) ? 0x40000000 : (DWORD)size;
+        DWORD bytes_written;
+        if (!WriteFile(file, buffer, chunk, &bytes_written, ZYAN_NULL) || (bytes_written == 0))
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            break;
+        }
+        buffer += bytes_written;
+        size -= bytes_written;
+    }
+
+    CloseHandle(file);
+    if (ZYAN_SUCCESS(status) && !MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING))
+    {
+        status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        DeleteFileA(temp_path);
+    }
+
+#elif defined(ZYAN_POSIX)
+
+    const int file = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        ZYAN_FREE(temp_path);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    while (size > 0)
+    {
+        const ssize_t bytes_written = write(file, buffer, size);
+        if (bytes_written <= 0)
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            break;
+        }
+        buffer += bytes_written;
+        size -= (ZyanUSize)bytes_written;
+    }
+
+    if (close(file) && ZYAN_SUCCESS(status))
+    {
+        status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (ZYAN_SUCCESS(status) && rename(temp_path, path))
+    {
+        status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        unlink(temp_path);
+    }
+
+#endif
+
+    ZYAN_FREE(temp_path);
+    return status;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Internal                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexRelocationCacheLookup(const void* address, ZyanUSize length,
+    ZyanUSize bytes_to_analyze, ZyrexRelocationCacheEntry* entry)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(entry);
+
+    const ZyrexRelocationCache* const cache = ZyrexRelocationCacheFind((ZyanUPointer)address);
+    if (!cache || (bytes_to_analyze > ZYAN_UINT8_MAX))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyanUPointer rva = (ZyanUPointer)address - cache->module_base;
+    if (rva > ZYAN_UINT32_MAX)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    ZyrexRelocationCacheEntry key;
+    key.rva = (ZyanU32)rva;
+    key.bytes_to_analyze = (ZyanU8)bytes_to_analyze;
+
+    // Entries added since the file was mapped take precedence over the entries from the file
+    const ZyrexRelocationCacheEntry* item = ZYAN_NULL;
+    ZyanUSize index;
+    ZyanStatus status = ZyanVectorBinarySearch(&cache->pending, &key, &index,
+        (ZyanComparison)&ZyrexCompareRelocationCacheEntry);
+    ZYAN_CHECK(status);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        item = (const ZyrexRelocationCacheEntry*)ZyanVectorGet(&cache->pending, index);
+    } else
+    {
+        ZyanUSize lo = 0;
+        ZyanUSize hi = cache->entry_count;
+        while (lo < hi)
+        {
+            const ZyanUSize mid = lo + (hi - lo) / 2;
+            const ZyanI32 result = ZyrexCompareRelocationCacheEntry(&cache->entries[mid], &key);
+            if (result == 0)
+            {
+                item = &cache->entries[mid];
+                break;
+            }
+            if (result < 0)
+            {
+                lo = mid + 1;
+            } else
+            {
+                hi = mid;
+            }
+        }
+    }
+
+    if (!item)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    ZYAN_MEMCPY(entry, item, sizeof(ZyrexRelocationCacheEntry));
+
+    if (!ZyrexRelocationCacheIsEntryValid(entry) || (entry->original_code_size > length) ||
+        ZYAN_MEMCMP(address, entry->original_code, entry->original_code_size))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+void ZyrexRelocationCacheGetTargetRange(const ZyrexRelocationCacheEntry* entry,
+    const void* address, ZyanUPointer* lo, ZyanUPointer* hi)
+{
+    ZYAN_ASSERT(entry);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(lo);
+    ZYAN_ASSERT(hi);
+
+    *lo = (ZyanUPointer)address;
+    *hi = (ZyanUPointer)address;
+
+    for (ZyanUSize i = 0; i < entry->fixup_count; ++i)
+    {
+        const ZyanUPointer target =
+            (ZyanUPointer)address + (ZyanUPointer)entry->fixups[i].target_offset;
+        if (target < *lo)
+        {
+            *lo = target;
+        }
+        if (target > *hi)
+        {
+            *hi = target;
+        }
+    }
+}
+
+ZyanStatus ZyrexRelocationCacheApply(const ZyrexRelocationCacheEntry* entry, const void* address,
+    ZyrexTrampolineChunk* trampoline, ZyanUSize* bytes_read, ZyanUSize* bytes_written)
+{
+    ZYAN_ASSERT(entry);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(bytes_read);
+    ZYAN_ASSERT(bytes_written);
+
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(trampoline);
+    ZYAN_MEMCPY(writable->code_buffer, entry->code, entry->code_size);
+
+    // Rebase all relative offsets with external targets to the new trampoline address
+    for (ZyanUSize i = 0; i < entry->fixup_count; ++i)
+    {
+        const ZyrexRelocationCacheFixup* const fixup = &entry->fixups[i];
+        const ZyanUPointer base = (ZyanUPointer)&trampoline->code_buffer[fixup->base];
+        const ZyanUPointer target = (ZyanUPointer)address + (ZyanUPointer)fixup->target_offset;
+
+#ifdef ZYAN_X64
+        const ZyanI64 distance = (ZyanI64)(target - base);
+        if ((distance < ZYAN_INT32_MIN) || (distance > ZYAN_INT32_MAX))
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+#endif
+
+        *(ZyanI32*)&writable->code_buffer[fixup->offset] =
+            ZyrexCalculateRelativeOffset(0, base, target);
+    }
+
+    ZyrexInstructionTranslationMap* const translation_map =
+        &ZyrexTrampolineGetChunkInfo(trampoline)->translation_map;
+    translation_map->count = entry->translation_count;
+    for (ZyanUSize i = 0; i < entry->translation_count; ++i)
+    {
+        ZyrexInstructionTranslationItem* const item = &translation_map->items[i];
+        item->type = ZYREX_TRANSLATION_TYPE_DEFAULT;
+        item->offset_source = entry->translations[i].offset_source;
+        item->offset_destination = entry->translations[i].offset_destination;
+        item->target_address = 0;
+    }
+
+    *bytes_read = entry->original_code_size;
+    *bytes_written = entry->code_size;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexRelocationCacheInsert(const ZyrexCodeAnalysis* analysis,
+    const ZyrexTrampolineChunk* trampoline, const ZyrexRelocationFixups* fixups)
+{
+    ZYAN_ASSERT(analysis);
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(fixups);
+
+    const ZyanUPointer address = (ZyanUPointer)analysis->buffer;
+    const ZyrexTrampolineChunkInfo* const info = ZyrexTrampolineGetChunkInfo(trampoline);
+
+    ZyrexRelocationCache* const cache = ZyrexRelocationCacheFind(address);
+    if (!cache || (address - cache->module_base > ZYAN_UINT32_MAX) ||
+        (analysis->bytes_to_analyze > ZYAN_UINT8_MAX))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyrexRelocationCacheEntry entry;
+    ZYAN_MEMSET(&entry, 0, sizeof(entry));
+    entry.rva = (ZyanU32)(address - cache->module_base);
+    entry.bytes_to_analyze = (ZyanU8)analysis->bytes_to_analyze;
+    entry.original_code_size = (ZyanU8)analysis->bytes_read;
+    entry.code_size = info->code_buffer_size;
+    entry.translation_count = info->translation_map.count;
+    entry.fixup_count = fixups->count;
+
+    ZYAN_MEMCPY(entry.original_code, analysis->buffer, analysis->bytes_read);
+    ZYAN_MEMCPY(entry.code, trampoline->code_buffer, info->code_buffer_size);
+
+    for (ZyanUSize i = 0; i < fixups->count; ++i)
+    {
+        const ZyrexRelocationFixup* const item = &fixups->items[i];
+        if (item->size != 4)
+        {
+            // Shorter offsets only fit for the current trampoline address
+            return ZYAN_STATUS_SUCCESS;
+        }
+
+        entry.fixups[i].target_offset = (ZyanI64)(ZyanIPointer)(item->target_address - address);
+        entry.fixups[i].offset = item->offset;
+        entry.fixups[i].base = item->base;
+        ZYAN_MEMSET(&entry.code[item->offset], 0, 4);
+    }
+
+    for (ZyanUSize i = 0; i < info->translation_map.count; ++i)
+    {
+        entry.translations[i].offset_source = info->translation_map.items[i].offset_source;
+        entry.translations[i].offset_destination =
+            info->translation_map.items[i].offset_destination;
+    }
+
+    ZyanUSize index;
+    const ZyanStatus status = ZyanVectorBinarySearch(&cache->pending, &entry, &index,
+        (ZyanComparison)&ZyrexCompareRelocationCacheEntry);
+    ZYAN_CHECK(status);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        ZYAN_MEMCPY(ZyanVectorGetMutable(&cache->pending, index), &entry, sizeof(entry));
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    return ZyanVectorInsert(&cache->pending, index, &entry);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exported                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexRelocationCacheOpen(const char* path, const void* module_base,
+    ZyanUSize module_size, ZyanU64 module_key, ZyrexRelocationCache** cache)
+{
+    if (!path || !module_base || !module_size || !cache)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (!g_relocation_cache_data.is_initialized)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_relocation_cache_data.caches, sizeof(ZyrexRelocationCache*),
+            4, ZYAN_NULL));
+        g_relocation_cache_data.is_initialized = ZYAN_TRUE;
+    }
+
+    if (ZyrexRelocationCacheFind((ZyanUPointer)module_base) ||
+        ZyrexRelocationCacheFind((ZyanUPointer)module_base + module_size - 1))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexRelocationCache* const value = ZYAN_MALLOC(sizeof(ZyrexRelocationCache));
+    if (!value)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMSET(value, 0, sizeof(ZyrexRelocationCache));
+
+    const ZyanUSize length = ZYAN_STRLEN(path);
+    value->path = ZYAN_MALLOC(length + 1);
+    if (!value->path)
+    {
+        ZYAN_FREE(value);
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMCPY(value->path, path, length + 1);
+
+    value->module_base = (ZyanUPointer)module_base;
+    value->module_size = module_size;
+    value->module_key = module_key;
+
+    ZyanStatus status = ZyanVectorInit(&value->pending, sizeof(ZyrexRelocationCacheEntry), 16,
+        ZYAN_NULL);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorPushBack(&g_relocation_cache_data.caches, &value);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyanVectorDestroy(&value->pending));
+        }
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_FREE(value->path);
+        ZYAN_FREE(value);
+        return status;
+    }
+
+    ZyrexRelocationCacheMap(value);
+
+    *cache = value;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexRelocationCacheSave(ZyrexRelocationCache* cache)
+{
+    if (!cache)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanUSize pending_count = cache->pending.size;
+    const ZyanUSize size = sizeof(ZyrexRelocationCacheHeader) +
+        (cache->entry_count + pending_count) * sizeof(ZyrexRelocationCacheEntry);
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyanU8* const buffer = ZYAN_MALLOC(size);
+    if (!buffer)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    // Merge the entries of the file and the pending entries. Pending entries replace file
+    // entries with the same key
+    ZyrexRelocationCacheEntry* const entries =
+        (ZyrexRelocationCacheEntry*)(buffer + sizeof(ZyrexRelocationCacheHeader));
+    ZyanUSize count = 0;
+    ZyanUSize i = 0;
+    ZyanUSize j = 0;
+    while ((i < cache->entry_count) || (j < pending_count))
+    {
+        const ZyrexRelocationCacheEntry* const pending = (j < pending_count)
+            ? (const ZyrexRelocationCacheEntry*)ZyanVectorGet(&cache->pending, j)
+            : ZYAN_NULL;
+        const ZyanI32 result = (i == cache->entry_count)
+            ? 1
+            : (pending ? ZyrexCompareRelocationCacheEntry(&cache->entries[i], pending) : -1);
+
+        if (result < 0)
+        {
+            ZYAN_MEMCPY(&entries[count++], &cache->entries[i++], sizeof(*entries));
+            continue;
+        }
+        if (result == 0)
+        {
+            ++i;
+        }
+        ZYAN_MEMCPY(&entries[count++], pending, sizeof(*entries));
+        ++j;
+    }
+
+    ZyrexRelocationCacheHeader* const header = (ZyrexRelocationCacheHeader*)buffer;
+    header->signature = ZYREX_RELOCATION_CACHE_SIGNATURE;
+    header->version = ZYREX_RELOCATION_CACHE_VERSION;
+    header->address_width = sizeof(void*) * 8;
+    header->reserved = 0;
+    header->entry_size = sizeof(ZyrexRelocationCacheEntry);
+    header->entry_count = (ZyanU32)count;
+    header->module_key = cache->module_key;
+
+    // The file can not be replaced while it is still mapped on some platforms
+    ZyrexRelocationCacheUnmap(cache);
+
+    const ZyanStatus status = ZyrexRelocationCacheWriteFile(cache->path, buffer,
+        sizeof(ZyrexRelocationCacheHeader) + count * sizeof(ZyrexRelocationCacheEntry));
+    ZYAN_FREE(buffer);
+
+    if (ZYAN_SUCCESS(status))
+    {
+        ZYAN_UNUSED(ZyanVectorClear(&cache->pending));
+    }
+    ZyrexRelocationCacheMap(cache);
+
+    return status;
+}
+
+ZyanStatus ZyrexRelocationCacheClose(ZyrexRelocationCache* cache)
+{
+    if (!cache)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (ZyanUSize i = 0; i < g_relocation_cache_data.caches.size; ++i)
+    {
+        if (*(ZyrexRelocationCache**)ZyanVectorGet(&g_relocation_cache_data.caches, i) == cache)
+        {
+            ZYAN_CHECK(ZyanVectorDelete(&g_relocation_cache_data.caches, i));
+            break;
+        }
+    }
+
+    ZyrexRelocationCacheUnmap(cache);
+    ZYAN_UNUSED(ZyanVectorDestroy(&cache->pending));
+    ZYAN_FREE(cache->path);
+    ZYAN_FREE(cache);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
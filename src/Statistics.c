@@ -0,0 +1,190 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zyrex/Internal/Statistics.h>
+
+#if !defined(ZYAN_MSVC)
+#   include <cpuid.h>
+#endif
+
+#ifdef ZYREX_HOOK_STATISTICS
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global hook statistics data.
+ *
+ * The entries and counters are stored in writable memory, as the trampoline-regions are only
+ * executable outside of transactions.
+ */
+static struct
+{
+    /**
+     * @brief   The call counter shards, indexed by the dense index of the trampoline chunks.
+     *
+     * The counters are kept apart from the `entries`, so that the latency histograms never share
+     * a cache-line with a counter.
+     */
+    ZyrexStatisticsCounter
+        counters[ZYREX_HOOK_STATISTICS_MAX_ENTRIES][ZYREX_HOOK_STATISTICS_COUNTER_SHARDS];
+    /**
+     * @brief   The statistics entries, indexed by the dense index of the trampoline chunks.
+     */
+    ZyrexStatisticsEntry entries[ZYREX_HOOK_STATISTICS_MAX_ENTRIES];
+} g_statistics_data;
+
+ZYAN_STATIC_ASSERT(sizeof(ZyrexStatisticsCounter) == (1 << ZYREX_HOOK_STATISTICS_COUNTER_SHIFT));
+ZYAN_STATIC_ASSERT((ZYREX_HOOK_STATISTICS_COUNTER_SHARDS &
+    (ZYREX_HOOK_STATISTICS_COUNTER_SHARDS - 1)) == 0);
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the histogram bucket for the given number of `ticks`.
+ *
+ * @param   ticks   The number of timestamp-counter ticks.
+ *
+ * @return  The index of the histogram bucket.
+ */
+static ZyanUSize ZyrexStatisticsGetBucket(ZyanU64 ticks)
+{
+    ZyanUSize bucket = 0;
+    while ((ticks >>= 1) && (bucket < ZYREX_HOOK_STATISTICS_HISTOGRAM_SIZE - 1))
+    {
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+ZyrexStatisticsEntry* ZyrexStatisticsGetEntry(ZyanU32 index)
+{
+    if (index >= ZYREX_HOOK_STATISTICS_MAX_ENTRIES)
+    {
+        return ZYAN_NULL;
+    }
+
+    return &g_statistics_data.entries[index];
+}
+
+ZyrexStatisticsCounter* ZyrexStatisticsGetCounters(ZyanU32 index)
+{
+    if (index >= ZYREX_HOOK_STATISTICS_MAX_ENTRIES)
+    {
+        return ZYAN_NULL;
+    }
+
+    return g_statistics_data.counters[index];
+}
+
+ZyanU64 ZyrexStatisticsGetCallCount(ZyanU32 index)
+{
+    const ZyrexStatisticsCounter* const counters = ZyrexStatisticsGetCounters(index);
+    if (!counters)
+    {
+        return 0;
+    }
+
+    ZyanU64 result = 0;
+    for (ZyanUSize i = 0; i < ZYREX_HOOK_STATISTICS_COUNTER_SHARDS; ++i)
+    {
+        result += counters[i].value;
+    }
+
+    return result;
+}
+
+ZyanBool ZyrexStatisticsIsProcessorIdSupported(void)
+{
+    // CPUID.80000001h:EDX.RDTSCP[bit 27]
+#if defined(ZYAN_MSVC)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if ((unsigned int)info[0] < 0x80000001)
+    {
+        return ZYAN_FALSE;
+    }
+    __cpuid(info, 0x80000001);
+    const unsigned int edx = (unsigned int)info[3];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx))
+    {
+        return ZYAN_FALSE;
+    }
+#endif
+
+    return (edx & (1u << 27)) ? ZYAN_TRUE : ZYAN_FALSE;
+}
+
+void ZyrexStatisticsResetEntry(ZyanU32 index)
+{
+    ZyrexStatisticsEntry* const entry = ZyrexStatisticsGetEntry(index);
+    if (!entry)
+    {
+        return;
+    }
+
+    ZYAN_MEMSET((void*)entry, 0, sizeof(*entry));
+    ZYAN_MEMSET((void*)g_statistics_data.counters[index], 0,
+        sizeof(g_statistics_data.counters[index]));
+}
+
+void ZyrexStatisticsRecordLatency(ZyanU32 index, ZyanU64 ticks)
+{
+    ZyrexStatisticsEntry* const entry = ZyrexStatisticsGetEntry(index);
+    if (!entry)
+    {
+        return;
+    }
+
+    volatile ZyanU32* const bucket = &entry->latency_histogram[ZyrexStatisticsGetBucket(ticks)];
+
+#if defined(ZYAN_MSVC)
+    _InterlockedIncrement((volatile long*)bucket);
+#else
+    __atomic_fetch_add(bucket, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/* ============================================================================================== */
+
+#endif
@@ -0,0 +1,634 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/API/Synchronization.h>
+#include <Zycore/API/Thread.h>
+#include <Zycore/LibC.h>
+#include <Zyrex/ThreadMask.h>
+#include <Zyrex/Internal/ThreadMask.h>
+#include <Zyrex/Internal/Trampoline.h>
+
+#ifdef ZYAN_WINDOWS
+#   include <Windows.h>
+#endif
+
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+#if defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   Defines the number of TLS slots that are stored inline in the thread environment
+ *          block.
+ */
+#define ZYREX_THREAD_MASK_TEB_SLOT_COUNT    64
+
+/**
+ * @brief   Defines the offset of the inline TLS slots in the thread environment block.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_THREAD_MASK_TEB_SLOT_OFFSET 0x1480
+#else
+#   define ZYREX_THREAD_MASK_TEB_SLOT_OFFSET 0x0E10
+#endif
+
+#endif
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global thread mask data.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the thread mask system has been initialized.
+     */
+    ZyanBool is_initialized;
+    /**
+     * @brief   The TLS slot that owns the thread mask of each thread and releases it, when the
+     *          thread exits.
+     */
+    ZyanThreadTlsIndex tls_index;
+#if defined(ZYAN_WINDOWS)
+    /**
+     * @brief   The TLS slot that is read by the callback stubs.
+     */
+    DWORD slot_index;
+#endif
+    /**
+     * @brief   The segment relative offset of the TLS slot that is read by the callback stubs.
+     */
+    ZyanU32 slot_offset;
+    /**
+     * @brief   Signals, if the `lock` critical section is initialized.
+     *
+     * The critical section is kept alive for the lifetime of the process, as exiting threads
+     * might still unlink their thread mask after the system has been shut down.
+     */
+    ZyanBool is_lock_initialized;
+    /**
+     * @brief   Synchronizes modifications of the `masks` list.
+     */
+    ZyanCriticalSection lock;
+    /**
+     * @brief   The head of the list of all thread masks.
+     */
+    ZyrexThreadMask* masks;
+} g_thread_mask_data;
+
+#if defined(ZYAN_LINUX)
+
+/**
+ * @brief   The thread mask of the current thread, as read by the callback stubs.
+ *
+ * The initial-exec TLS model guarantees a constant offset from the thread pointer for all
+ * threads.
+ */
+static __thread ZyrexThreadMask* g_thread_mask __attribute__((tls_model("initial-exec")));
+
+#endif
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* TLS slot                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the thread mask of the current thread.
+ *
+ * @return  A pointer to the `ZyrexThreadMask` struct of the current thread or `ZYAN_NULL`, if
+ *          the thread did never disable a hook.
+ */
+static ZyrexThreadMask* ZyrexThreadMaskGetSlotValue(void)
+{
+#if defined(ZYAN_WINDOWS)
+    return TlsGetValue(g_thread_mask_data.slot_index);
+#else
+    return g_thread_mask;
+#endif
+}
+
+/**
+ * @brief   Sets the thread mask of the current thread.
+ *
+ * @param   mask    A pointer to the `ZyrexThreadMask` struct or `ZYAN_NULL`.
+ */
+static void ZyrexThreadMaskSetSlotValue(ZyrexThreadMask* mask)
+{
+#if defined(ZYAN_WINDOWS)
+    TlsSetValue(g_thread_mask_data.slot_index, mask);
+#else
+    g_thread_mask = mask;
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Atomic operations                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically sets the given `bits` in the value at `destination`.
+ *
+ * @param   destination A pointer to the destination.
+ * @param   bits        The bits to set.
+ */
+ZYAN_INLINE void ZyrexThreadMaskSetBits(ZyanU32* destination, ZyanU32 bits)
+{
+#if defined(ZYAN_MSVC)
+    InterlockedOr((volatile LONG*)destination, (LONG)bits);
+#else
+    __atomic_fetch_or(destination, bits, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief   Atomically clears the given `bits` in the value at `destination`.
+ *
+ * @param   destination A pointer to the destination.
+ * @param   bits        The bits to clear.
+ */
+ZYAN_INLINE void ZyrexThreadMaskClearBits(ZyanU32* destination, ZyanU32 bits)
+{
+#if defined(ZYAN_MSVC)
+    InterlockedAnd((volatile LONG*)destination, (LONG)~bits);
+#else
+    __atomic_fetch_and(destination, ~bits, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread mask list                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Inserts the given thread mask into the global thread mask list.
+ *
+ * @param   mask    A pointer to the `ZyrexThreadMask` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexThreadMaskLink(ZyrexThreadMask* mask)
+{
+    ZYAN_ASSERT(mask);
+    ZYAN_ASSERT(g_thread_mask_data.is_lock_initialized);
+
+    ZYAN_CHECK(ZyanCriticalSectionEnter(&g_thread_mask_data.lock));
+
+    mask->previous = ZYAN_NULL;
+    mask->next = g_thread_mask_data.masks;
+    if (mask->next)
+    {
+        mask->next->previous = mask;
+    }
+    g_thread_mask_data.masks = mask;
+
+    return ZyanCriticalSectionLeave(&g_thread_mask_data.lock);
+}
+
+/**
+ * @brief   Removes the given thread mask from the global thread mask list.
+ *
+ * @param   mask    A pointer to the `ZyrexThreadMask` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexThreadMaskUnlink(ZyrexThreadMask* mask)
+{
+    ZYAN_ASSERT(mask);
+    ZYAN_ASSERT(g_thread_mask_data.is_lock_initialized);
+
+    ZYAN_CHECK(ZyanCriticalSectionEnter(&g_thread_mask_data.lock));
+
+    if (mask->next)
+    {
+        mask->next->previous = mask->previous;
+    }
+    if (mask->previous)
+    {
+        mask->previous->next = mask->next;
+    } else
+    {
+        g_thread_mask_data.masks = mask->next;
+    }
+
+    return ZyanCriticalSectionLeave(&g_thread_mask_data.lock);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* TLS cleanup                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   This function is invoked every time a thread exists.
+ *
+ * @param   data    The data currently stored in the TLS slot.
+ */
+ZYAN_THREAD_DECLARE_TLS_CALLBACK(ZyrexThreadMaskTlsCleanup, ZyrexThreadMask, data)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    // Calls during the remaining thread shutdown are no longer bypassed
+    ZyrexThreadMaskSetSlotValue(ZYAN_NULL);
+
+    // A mask that is still linked might be accessed by `ZyrexThreadMaskReleaseIndex` and is
+    // leaked instead
+    if (!ZYAN_SUCCESS(ZyrexThreadMaskUnlink(data)))
+    {
+        return;
+    }
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(data);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread mask                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the thread mask of the current thread.
+ *
+ * @param   mask    Receives a pointer to the `ZyrexThreadMask` struct of the current thread.
+ * @param   create  Set `ZYAN_TRUE` to allocate the thread mask, if it does not exist yet.
+ *
+ * @return  A zyan status code.
+ *
+ * If the thread mask does not exist and `create` is `ZYAN_FALSE`, `mask` receives `ZYAN_NULL`.
+ */
+static ZyanStatus ZyrexThreadMaskGet(ZyrexThreadMask** mask, ZyanBool create)
+{
+    ZYAN_ASSERT(mask);
+
+    if (!g_thread_mask_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    *mask = ZyrexThreadMaskGetSlotValue();
+    if (*mask || !create)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexThreadMask* const value = ZYAN_MALLOC(sizeof(ZyrexThreadMask));
+    if (!value)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMSET(value, 0, sizeof(ZyrexThreadMask));
+
+    ZyanStatus status = ZyrexThreadMaskLink(value);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_FREE(value);
+        return status;
+    }
+
+    status = ZyanThreadTlsSetValue(g_thread_mask_data.tls_index, value);
+    if (!ZYAN_SUCCESS(status))
+    {
+        if (ZYAN_SUCCESS(ZyrexThreadMaskUnlink(value)))
+        {
+            ZYAN_FREE(value);
+        }
+        return status;
+    }
+    ZyrexThreadMaskSetSlotValue(value);
+
+    *mask = value;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Returns the dense index of the given `trampoline`.
+ *
+ * @param   trampoline  The `trampoline` that identifies the hook.
+ * @param   index       Receives the dense index of the trampoline chunk.
+ * @param   generation  Receives the generation of the dense index.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexThreadMaskGetIndex(const void* trampoline, ZyanU32* index,
+    ZyanU32* generation)
+{
+    ZYAN_ASSERT(index);
+    ZYAN_ASSERT(generation);
+
+    if (!trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanStatus status = ZyrexTrampolineGetIndex(trampoline, index, generation);
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+    ZYAN_CHECK(status);
+
+    if (*index >= ZYREX_THREAD_MASK_MAX_ENTRIES)
+    {
+        return ZYAN_STATUS_OUT_OF_RANGE;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+ZyanStatus ZyrexThreadMaskGetSlotOffset(ZyanU32* offset)
+{
+    ZYAN_ASSERT(offset);
+
+    if (!g_thread_mask_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    *offset = g_thread_mask_data.slot_offset;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexThreadMaskReleaseIndex(ZyanU32 index)
+{
+    if (!g_thread_mask_data.is_lock_initialized || (index >= ZYREX_THREAD_MASK_MAX_ENTRIES))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZYAN_CHECK(ZyanCriticalSectionEnter(&g_thread_mask_data.lock));
+
+    const ZyanU32 bit = (ZyanU32)1 << (index % 32);
+    for (ZyrexThreadMask* mask = g_thread_mask_data.masks; mask; mask = mask->next)
+    {
+        ZyrexThreadMaskClearBits(&mask->disabled_hooks[index / 32], bit);
+    }
+
+    return ZyanCriticalSectionLeave(&g_thread_mask_data.lock);
+}
+
+/* ============================================================================================== */
+
+#endif
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexThreadMaskSystemInitialize(void)
+{
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+    if (g_thread_mask_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    if (!g_thread_mask_data.is_lock_initialized)
+    {
+        ZYAN_CHECK(ZyanCriticalSectionInitialize(&g_thread_mask_data.lock));
+        g_thread_mask_data.is_lock_initialized = ZYAN_TRUE;
+    }
+
+#if defined(ZYAN_WINDOWS)
+
+    // The callback stub can only read the TLS slots that are stored inline in the TEB
+    const DWORD slot_index = TlsAlloc();
+    if (slot_index == TLS_OUT_OF_INDEXES)
+    {
+        return ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
+    if (slot_index >= ZYREX_THREAD_MASK_TEB_SLOT_COUNT)
+    {
+        TlsFree(slot_index);
+        return ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
+
+    const ZyanStatus status = ZyanThreadTlsAlloc(&g_thread_mask_data.tls_index,
+        (ZyanThreadTlsCallback)&ZyrexThreadMaskTlsCleanup);
+    if (!ZYAN_SUCCESS(status))
+    {
+        TlsFree(slot_index);
+        return status;
+    }
+
+    g_thread_mask_data.slot_index = slot_index;
+    g_thread_mask_data.slot_offset =
+        ZYREX_THREAD_MASK_TEB_SLOT_OFFSET + slot_index * sizeof(void*);
+
+#elif defined(ZYAN_LINUX)
+
+    ZYAN_CHECK(ZyanThreadTlsAlloc(&g_thread_mask_data.tls_index,
+        (ZyanThreadTlsCallback)&ZyrexThreadMaskTlsCleanup));
+
+    // The first word of the thread control block points to the thread control block itself
+    ZyanUPointer thread_pointer;
+#if defined(ZYAN_X64)
+    __asm__ ("mov %%fs:0, %0" : "=r" (thread_pointer));
+#else
+    __asm__ ("mov %%gs:0, %0" : "=r" (thread_pointer));
+#endif
+    g_thread_mask_data.slot_offset = (ZyanU32)((ZyanUPointer)&g_thread_mask - thread_pointer);
+
+#else
+
+    // The thread mask is not supported on this platform
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+
+    g_thread_mask_data.is_initialized = ZYAN_TRUE;
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+ZyanStatus ZyrexThreadMaskSystemShutdown(void)
+{
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+    if (!g_thread_mask_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    // Only the mask of the calling thread can be released here
+    ZyrexThreadMask* const mask = ZyrexThreadMaskGetSlotValue();
+    ZyrexThreadMaskTlsCleanup(mask);
+
+    g_thread_mask_data.is_initialized = ZYAN_FALSE;
+
+#if defined(ZYAN_WINDOWS)
+    TlsFree(g_thread_mask_data.slot_index);
+#endif
+
+    return ZyanThreadTlsFree(g_thread_mask_data.tls_index);
+
+#else
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread mask                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexThreadMaskSetGlobal(ZyanBool enabled)
+{
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+    ZyrexThreadMask* mask;
+    ZYAN_CHECK(ZyrexThreadMaskGet(&mask, !enabled));
+    if (mask)
+    {
+        mask->is_disabled = enabled ? 0 : 1;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    ZYAN_UNUSED(enabled);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
+}
+
+ZyanStatus ZyrexThreadMaskSetHook(const void* trampoline, ZyanBool enabled)
+{
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+    ZyanU32 index;
+    ZyanU32 generation;
+    ZYAN_CHECK(ZyrexThreadMaskGetIndex(trampoline, &index, &generation));
+
+    ZyrexThreadMask* mask;
+    ZYAN_CHECK(ZyrexThreadMaskGet(&mask, !enabled));
+    if (!mask)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanU32 bit = (ZyanU32)1 << (index % 32);
+    if (enabled)
+    {
+        ZyrexThreadMaskClearBits(&mask->disabled_hooks[index / 32], bit);
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanBool was_disabled = (mask->disabled_hooks[index / 32] & bit) ? ZYAN_TRUE : ZYAN_FALSE;
+    ZyrexThreadMaskSetBits(&mask->disabled_hooks[index / 32], bit);
+
+    // The trampoline might have been released concurrently, after its index was resolved. If
+    // the released index was cleared before the bit got set, the bit must not survive a reuse
+    ZyanU32 current_index;
+    ZyanU32 current_generation;
+    if ((ZyrexTrampolineGetIndex(trampoline, &current_index, &current_generation) !=
+            ZYAN_STATUS_TRUE) ||
+        (current_index != index) || (current_generation != generation))
+    {
+        if (!was_disabled)
+        {
+            ZyrexThreadMaskClearBits(&mask->disabled_hooks[index / 32], bit);
+        }
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    ZYAN_UNUSED(trampoline);
+    ZYAN_UNUSED(enabled);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
+}
+
+ZyanStatus ZyrexThreadMaskIsHookEnabled(const void* trampoline)
+{
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+    ZyanU32 index;
+    ZyanU32 generation;
+    ZYAN_CHECK(ZyrexThreadMaskGetIndex(trampoline, &index, &generation));
+
+    ZyrexThreadMask* mask;
+    ZYAN_CHECK(ZyrexThreadMaskGet(&mask, ZYAN_FALSE));
+    if (!mask)
+    {
+        return ZYAN_STATUS_TRUE;
+    }
+
+    if (mask->is_disabled ||
+        (mask->disabled_hooks[index / 32] & ((ZyanU32)1 << (index % 32))))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    return ZYAN_STATUS_TRUE;
+
+#else
+
+    ZYAN_UNUSED(trampoline);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
@@ -24,6 +24,8 @@
 
 ***************************************************************************************************/
 
+#include <stddef.h>
+#include <Zycore/Comparison.h>
 #include <Zycore/Defines.h>
 #include <Zycore/LibC.h>
 #include <Zycore/Vector.h>
@@ -31,17 +33,90 @@
 #include <Zycore/API/Process.h>
 #include <Zydis/Zydis.h>
 #include <Zyrex/Internal/Relocation.h>
+#include <Zyrex/Internal/RelocationCache.h>
+#include <Zyrex/Internal/Statistics.h>
+#include <Zyrex/Internal/ThreadMask.h>
 #include <Zyrex/Internal/Trampoline.h>
 
 #if   defined(ZYAN_WINDOWS)
 #   include <Windows.h>
+#   include <intrin.h>
 #elif defined(ZYAN_POSIX)
+#   include <errno.h>
+#   include <fcntl.h>
 #   include <unistd.h>
 #   include <sys/mman.h>
+#   if defined(ZYREX_TRAMPOLINE_DUAL_MAPPING) && defined(ZYAN_LINUX)
+#       include <sys/syscall.h>
+#   endif
 #else
 #   error "Unsupported platform detected"
 #endif
 
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum size of a trampoline-region that can be used to store
+ *          trampoline-chunks.
+ *
+ * This value matches the allocation-granularity on Windows, which is the largest region size
+ * used on any supported platform.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_SIZE    0x10000
+
+/**
+ * @brief   Defines the maximum amount of chunks per trampoline-region.
+ *
+ * This value limits the size of the occupancy bitmap in the trampoline-region header.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS \
+    (ZYREX_TRAMPOLINE_REGION_MAX_SIZE / ZYREX_TRAMPOLINE_CHUNK_SIZE)
+
+/**
+ * @brief   Defines the number of `ZyanU32` elements in the occupancy bitmap of a
+ *          trampoline-region.
+ */
+#define ZYREX_TRAMPOLINE_REGION_BITMAP_SIZE (ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS / 32)
+
+/**
+ * @brief   Defines the maximum amount of memory pages per trampoline-region that can be used to
+ *          store trampoline-chunks.
+ *
+ * This value limits the size of the committed-pages bitmap in the trampoline-region header.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_PAGES   32
+
+/**
+ * @brief   Defines the lowest and the highest user-mode address that is considered for
+ *          trampoline-regions.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_TRAMPOLINE_ADDRESS_MIN     0x0000000000010000ULL
+#   define ZYREX_TRAMPOLINE_ADDRESS_MAX     0x00007FFFFFFFF000ULL
+#else
+#   define ZYREX_TRAMPOLINE_ADDRESS_MIN     0x00010000UL
+#   define ZYREX_TRAMPOLINE_ADDRESS_MAX     0xBFFFF000UL
+#endif
+
+/**
+ * @brief   Defines the `mmap` flag that places the mapping exactly at the hint address without
+ *          replacing existing mappings.
+ *
+ * Kernels older than Linux 4.17 ignore the flag and treat the address as a hint, which is
+ * detected by comparing the returned address.
+ */
+#if defined(ZYAN_POSIX)
+#   if defined(MAP_FIXED_NOREPLACE)
+#       define ZYREX_MAP_FIXED_NOREPLACE    MAP_FIXED_NOREPLACE
+#   elif defined(ZYAN_LINUX)
+#       define ZYREX_MAP_FIXED_NOREPLACE    0x100000
+#   else
+#       define ZYREX_MAP_FIXED_NOREPLACE    0
+#   endif
+#endif
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
@@ -53,7 +128,8 @@
 /**
  * @brief   Defines the `ZyrexTrampolineRegion` union.
  *
- * Note that the header shares memory with the first chunk in the trampoline-region.
+ * Note that the header shares memory with the first `ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS`
+ * chunks in the trampoline-region.
  */
 typedef union ZyrexTrampolineRegion_
 {
@@ -70,6 +146,42 @@ typedef union ZyrexTrampolineRegion_
          * @rief    The number of unused trampoline-chunks.
          */
         ZyanUSize number_of_unused_chunks;
+        /**
+         * @brief   The occupancy bitmap of the trampoline-chunks.
+         *
+         * A set bit marks an unused chunk. The bits of the leading chunks are never set as they
+         * share memory with the region-header.
+         */
+        ZyanU32 unused_chunks[ZYREX_TRAMPOLINE_REGION_BITMAP_SIZE];
+        /**
+         * @brief   The committed memory pages of the trampoline-region.
+         *
+         * A set bit marks a committed page. The first page is always committed as it contains
+         * the region-header.
+         */
+        ZyanU32 committed_pages;
+        /**
+         * @brief   Signals, if the trampoline-region is currently writable.
+         *
+         * Writable regions are part of the `dirty_regions` list and get re-protected at the end
+         * of the current transaction. For dual-mapped regions, this flag only signals a pending
+         * instruction cache flush.
+         */
+        ZyanBool is_writable;
+        /**
+         * @brief   The distance between the writable view and the executable view of the
+         *          trampoline-region.
+         *
+         * This value is `0`, if the trampoline-region is not dual-mapped (see
+         * `ZYREX_TRAMPOLINE_DUAL_MAPPING`).
+         */
+        ZyanUPointer writable_offset;
+        /**
+         * @brief   The bookkeeping data of the trampoline-chunks.
+         *
+         * The array is indexed by chunk number and resides in non-executable heap memory.
+         */
+        ZyrexTrampolineChunkInfo* chunk_info;
     } header;
     /**
      * @brief   The trampoline-chunks.
@@ -77,7 +189,93 @@ typedef union ZyrexTrampolineRegion_
     ZyrexTrampolineChunk chunks[1];
 } ZyrexTrampolineRegion;
 
-ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineRegion) == sizeof(ZyrexTrampolineChunk));
+ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineChunk) == ZYREX_TRAMPOLINE_CHUNK_SIZE);
+ZYAN_STATIC_ASSERT(ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS % 32 == 0);
+
+// The jump to the callback function is exchanged atomically and must not cross an 8-byte boundary
+ZYAN_STATIC_ASSERT((offsetof(ZyrexTrampolineChunk, callback_jump) +
+    ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE) % 8 + ZYREX_SIZEOF_ABSOLUTE_JUMP <= 8);
+ZYAN_STATIC_ASSERT((offsetof(ZyrexTrampolineChunk, callback_jump) +
+    ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE + ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE) % 8 +
+    ZYREX_SIZEOF_ABSOLUTE_JUMP <= 8);
+
+/**
+ * @brief   Defines the number of leading chunks in a trampoline-region that share memory with
+ *          the region-header.
+ */
+#define ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS \
+    ((sizeof(ZyrexTrampolineRegion) + sizeof(ZyrexTrampolineChunk) - 1) / \
+        sizeof(ZyrexTrampolineChunk))
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Address range                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexAddressRange` struct.
+ */
+typedef struct ZyrexAddressRange_
+{
+    /**
+     * @brief   The begin address of the range.
+     */
+    ZyanUPointer begin;
+    /**
+     * @brief   The end address of the range (exclusive).
+     */
+    ZyanUPointer end;
+} ZyrexAddressRange;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Region table                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTrampolineRegionTable` struct.
+ *
+ * The table is an open-addressed hash set of the base addresses of all trampoline-regions. It is
+ * read without any synchronization (see `ZyrexTrampolineRegionTableContains`). Slots are only
+ * ever filled, and a full table is replaced by a larger copy instead of being resized in place.
+ */
+typedef struct ZyrexTrampolineRegionTable_
+{
+    /**
+     * @brief   The table that got replaced by this one or `ZYAN_NULL`.
+     *
+     * Replaced tables are never freed, as concurrent lookups might still be reading them.
+     */
+    struct ZyrexTrampolineRegionTable_* previous;
+    /**
+     * @brief   The number of used slots.
+     */
+    ZyanUSize size;
+    /**
+     * @brief   The number of slots. This value is always a power of two.
+     */
+    ZyanUSize capacity;
+    /**
+     * @brief   The amount of bits to shift the hash value by, to obtain a slot number.
+     */
+    ZyanU8 shift;
+    /**
+     * @brief   The base addresses of the trampoline-regions. Unused slots are set to `0`.
+     */
+    volatile ZyanUPointer slots[1];
+} ZyrexTrampolineRegionTable;
+
+/**
+ * @brief   Defines the initial number of slots in the region table.
+ */
+#define ZYREX_TRAMPOLINE_REGION_TABLE_INITIAL_CAPACITY  16
+
+/**
+ * @brief   Defines the multiplier of the fibonacci hash that maps region addresses to slots.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_TRAMPOLINE_REGION_TABLE_MULTIPLIER     0x9E3779B97F4A7C15
+#else
+#   define ZYREX_TRAMPOLINE_REGION_TABLE_MULTIPLIER     0x9E3779B9
+#endif
 
 /* ---------------------------------------------------------------------------------------------- */
 
@@ -89,7 +287,8 @@ ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineRegion) == sizeof(ZyrexTrampolineChunk)
  * @brief   Contains global trampoline API data.
  *
  * Thread-safety is implicitly guaranteed by the transactional API as only one transaction can be
- * started at a time.
+ * started at a time. Lookups from other threads (see `ZyrexTrampolineGetIndex`) only use the
+ * lock-free `region_table`.
  */
 static struct
 {
@@ -104,17 +303,74 @@ static struct
      * the page-size on most other platforms.
      */
     ZyanUSize region_size;
+    /**
+     * @brief   The size of a single memory page.
+     */
+    ZyanUSize page_size;
     /**
      * @brief   The maximum amount of chunks per trampoline-region.
      */
     ZyanUSize chunks_per_region;
+    /**
+     * @brief   The total amount of reserved bytes of all trampoline-regions.
+     */
+    ZyanUSize reserved_bytes;
+    /**
+     * @brief   The total amount of committed bytes of all trampoline-regions.
+     */
+    ZyanUSize committed_bytes;
+    /**
+     * @brief   The number of trampoline-regions allocated since the initialization.
+     */
+    ZyanUSize region_allocations;
     /**
      * @brief   Contains a list of all allocated trampoline-regions.
      */
     ZyanVector regions;
+    /**
+     * @brief   Signals, if the `free_ranges` list has been built.
+     */
+    ZyanBool is_free_ranges_valid;
+    /**
+     * @brief   Contains a sorted list of free address ranges, that are aligned to the region
+     *          size.
+     *
+     * The list is built once by sweeping the address space and updated on every allocation.
+     * Ranges allocated by other code are removed lazily, as soon as an allocation attempt fails.
+     */
+    ZyanVector/*<ZyrexAddressRange>*/ free_ranges;
+    /**
+     * @brief   Maps the dense index of each trampoline chunk to the chunk itself.
+     *
+     * Entries of unused indices are set to `ZYAN_NULL`.
+     */
+    ZyanVector/*<ZyrexTrampolineChunk*>*/ chunks;
+    /**
+     * @brief   Contains all unused indices in the `chunks` list.
+     */
+    ZyanVector/*<ZyanU32>*/ free_indices;
+    /**
+     * @brief   The generation that was assigned to the most recently handed out index.
+     */
+    ZyanU32 index_generation;
+    /**
+     * @brief   Contains all trampoline-regions that have been made writable since the last call
+     *          to `ZyrexTrampolineProtectRegions`.
+     */
+    ZyanVector/*<ZyrexTrampolineRegion*>*/ dirty_regions;
+    /**
+     * @brief   The current region table or `ZYAN_NULL`, if no trampoline-region was inserted
+     *          yet.
+     *
+     * The table is published with release semantics, after all other fields required by lookups
+     * have been initialized. Trampoline-regions are never released once they got published, so
+     * that lookups can safely read the region-header of every region they find in the table.
+     */
+    ZyrexTrampolineRegionTable* volatile region_table;
 } g_trampoline_data =
 {
-    ZYAN_FALSE, 0, 0, ZYAN_VECTOR_INITIALIZER
+    ZYAN_FALSE, 0, 0, 0, 0, 0, 0, ZYAN_VECTOR_INITIALIZER, ZYAN_FALSE, ZYAN_VECTOR_INITIALIZER,
+    ZYAN_VECTOR_INITIALIZER, ZYAN_VECTOR_INITIALIZER, 0, ZYAN_VECTOR_INITIALIZER, ZYAN_NULL
 };
 
 /* ============================================================================================== */
@@ -184,126 +440,350 @@ static ZyanStatus ZyrexGetSizeOfReadableMemoryRegion(const void* address, ZyanUS
 
 /* ---------------------------------------------------------------------------------------------- */
 
-#ifdef ZYAN_X64
+/**
+ * @brief   Returns the index of the least significant set bit in the given `value`.
+ *
+ * @param   value   The value to scan. Must not be `0`.
+ *
+ * @return  The index of the least significant set bit.
+ */
+ZYAN_INLINE ZyanU32 ZyrexBitScanForward(ZyanU32 value)
+{
+    ZYAN_ASSERT(value);
+
+#if defined(ZYAN_MSVC)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (ZyanU32)index;
+#else
+    return (ZyanU32)__builtin_ctz(value);
+#endif
+}
 
 /**
- * @brief   Decodes the assembly code in the given `buffer` and returns the lowest and highest
- *          absolute target addresses of all relative branch instructions and `EIP/RIP`-relative
- *          memory operands.
+ * @brief   Returns the number of set bits in the given `value`.
  *
- * @param   buffer              The buffer to decode.
- * @param   size                The size of the buffer.
- * @param   min_bytes_to_decode The minimum amount of bytes to decode.
- * @param   address_lo          Receives the lowest absolute target address.
- * @param   address_hi          Receives the highest absolute target address.
+ * @param   value   The value.
  *
- * @return  `ZYAN_STATUS_TRUE` if at least one instruction with an relative address was found,
- *          `ZYAN_STATUS_FALSE` if not, or a generic zyan status code if an error occured.
+ * @return  The number of set bits.
+ */
+ZYAN_INLINE ZyanU32 ZyrexPopCount(ZyanU32 value)
+{
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Region table                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Loads the current region table with acquire semantics.
+ *
+ * @return  A pointer to the current `ZyrexTrampolineRegionTable` or `ZYAN_NULL`.
  */
-static ZyanStatus ZyrexGetAddressRangeOfRelativeInstructions(const void* buffer, ZyanUSize size,
-    ZyanUSize min_bytes_to_decode, ZyanUPointer* address_lo, ZyanUPointer* address_hi)
+ZYAN_INLINE ZyrexTrampolineRegionTable* ZyrexTrampolineRegionTableLoad(void)
 {
-    ZyanStatus result = ZYAN_STATUS_FALSE;
+#if defined(ZYAN_MSVC)
+    // Volatile accesses have acquire/release semantics with the default `/volatile:ms` model
+    ZyrexTrampolineRegionTable* const result = g_trampoline_data.region_table;
+    _ReadWriteBarrier();
+    return result;
+#else
+    return __atomic_load_n(&g_trampoline_data.region_table, __ATOMIC_ACQUIRE);
+#endif
+}
 
-    ZydisDecoder decoder;
-#if defined(ZYAN_X86)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-#elif defined(ZYAN_X64)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+/**
+ * @brief   Loads the given slot of a region table with acquire semantics.
+ *
+ * @param   table   A pointer to the `ZyrexTrampolineRegionTable` struct.
+ * @param   slot    The slot number.
+ *
+ * @return  The base address stored in the slot or `0`, if the slot is unused.
+ */
+ZYAN_INLINE ZyanUPointer ZyrexTrampolineRegionTableLoadSlot(
+    const ZyrexTrampolineRegionTable* table, ZyanUSize slot)
+{
+#if defined(ZYAN_MSVC)
+    const ZyanUPointer result = table->slots[slot];
+    _ReadWriteBarrier();
+    return result;
 #else
-#   error "Unsupported architecture detected"
+    return __atomic_load_n(&table->slots[slot], __ATOMIC_ACQUIRE);
 #endif
+}
+
+/**
+ * @brief   Returns the first slot to probe for the given trampoline-region address.
+ *
+ * @param   table   A pointer to the `ZyrexTrampolineRegionTable` struct.
+ * @param   address The base address of the trampoline-region.
+ *
+ * @return  The slot number.
+ */
+ZYAN_INLINE ZyanUSize ZyrexTrampolineRegionTableGetSlot(const ZyrexTrampolineRegionTable* table,
+    ZyanUPointer address)
+{
+    return (ZyanUSize)((ZyanUPointer)(address * ZYREX_TRAMPOLINE_REGION_TABLE_MULTIPLIER) >>
+        table->shift);
+}
+
+/**
+ * @brief   Stores the given trampoline-region address in the first free slot of a region table.
+ *
+ * @param   table   A pointer to the `ZyrexTrampolineRegionTable` struct.
+ * @param   address The base address of the trampoline-region.
+ *
+ * The slot is written with release semantics. The table must have at least one free slot.
+ */
+static void ZyrexTrampolineRegionTableStore(ZyrexTrampolineRegionTable* table,
+    ZyanUPointer address)
+{
+    ZYAN_ASSERT(table);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(table->size < table->capacity);
 
-    ZyanUPointer lo = (ZyanUPointer)(-1);
-    ZyanUPointer hi = 0;
-    ZydisDecodedInstruction instruction;
-    ZyanUSize offset = 0;
-    while (offset < min_bytes_to_decode)
+    ZyanUSize slot = ZyrexTrampolineRegionTableGetSlot(table, address);
+    while (table->slots[slot])
     {
-        const ZyanStatus status = ZydisDecoderDecodeInstruction(&decoder, ZYAN_NULL, 
-            (ZyanU8*)buffer + offset, size - offset, &instruction);
+        ZYAN_ASSERT(table->slots[slot] != address);
+        slot = (slot + 1) & (table->capacity - 1);
+    }
 
-        ZYAN_CHECK(status);
+#if defined(ZYAN_MSVC)
+    _ReadWriteBarrier();
+    table->slots[slot] = address;
+#else
+    __atomic_store_n(&table->slots[slot], address, __ATOMIC_RELEASE);
+#endif
+    ++table->size;
+}
 
-        if (!(instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE))
+/**
+ * @brief   Makes sure, that the region table has room for one more trampoline-region.
+ *
+ * @return  A zyan status code.
+ *
+ * If the load factor would exceed `1/2`, a copy of the table with twice the capacity is built
+ * and published. The replaced table stays valid for concurrent lookups.
+ */
+static ZyanStatus ZyrexTrampolineRegionTableReserve(void)
+{
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    ZyrexTrampolineRegionTable* const table = g_trampoline_data.region_table;
+    if (table && ((table->size + 1) * 2 <= table->capacity))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanUSize capacity =
+        table ? table->capacity * 2 : ZYREX_TRAMPOLINE_REGION_TABLE_INITIAL_CAPACITY;
+    const ZyanUSize size = offsetof(ZyrexTrampolineRegionTable, slots) +
+        capacity * sizeof(ZyanUPointer);
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexTrampolineRegionTable* const result = ZYAN_MALLOC(size);
+    if (!result)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMSET(result, 0, size);
+
+    result->previous = table;
+    result->capacity = capacity;
+    result->shift = (ZyanU8)(sizeof(ZyanUPointer) * 8);
+    for (ZyanUSize i = capacity; i > 1; i >>= 1)
+    {
+        --result->shift;
+    }
+
+    if (table)
+    {
+        for (ZyanUSize i = 0; i < table->capacity; ++i)
         {
-            offset += instruction.length;
-            continue;
+            if (table->slots[i])
+            {
+                ZyrexTrampolineRegionTableStore(result, table->slots[i]);
+            }
         }
-        result = ZYAN_STATUS_TRUE;
+    }
+
+#if defined(ZYAN_MSVC)
+    _ReadWriteBarrier();
+    g_trampoline_data.region_table = result;
+#else
+    __atomic_store_n(&g_trampoline_data.region_table, result, __ATOMIC_RELEASE);
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
 
-        ZyanU64 result_address;
-        ZYAN_CHECK(ZyrexCalcAbsoluteAddress(&instruction, (ZyanU64)buffer + offset,
-            &result_address));
+/**
+ * @brief   Checks, if the given address is the base address of a trampoline-region.
+ *
+ * @param   table   A pointer to the `ZyrexTrampolineRegionTable` struct.
+ * @param   address The address to check.
+ *
+ * @return  `ZYAN_TRUE`, if the address identifies a trampoline-region or `ZYAN_FALSE`, if not.
+ *
+ * This function does not use any locks and can be called from any thread.
+ */
+ZYAN_INLINE ZyanBool ZyrexTrampolineRegionTableContains(const ZyrexTrampolineRegionTable* table,
+    ZyanUPointer address)
+{
+    ZYAN_ASSERT(table);
 
-        if (result_address < lo)
+    ZyanUSize slot = ZyrexTrampolineRegionTableGetSlot(table, address);
+    while (ZYAN_TRUE)
+    {
+        const ZyanUPointer value = ZyrexTrampolineRegionTableLoadSlot(table, slot);
+        if (value == address)
         {
-            lo = result_address;
+            return ZYAN_TRUE;
         }
-        if (result_address > hi)
+        if (!value)
         {
-            hi = result_address;
+            return ZYAN_FALSE;
         }
-
-        offset += instruction.length;
-    }
-
-    if (result == ZYAN_STATUS_TRUE)
-    {
-        *address_lo = lo;
-        *address_hi = hi;
+        slot = (slot + 1) & (table->capacity - 1);
     }
-
-    return result;
 }
 
-#endif
+/* ---------------------------------------------------------------------------------------------- */
 
 /* ---------------------------------------------------------------------------------------------- */
 /* Trampoline region                                                                              */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Checks, if the given region is in a +/-2GiB range to both passed address values.
+ * @brief   Calculates the range of chunk indices in the given region that lie in a +/-2GiB range
+ *          to both passed address values.
  *
- * @param   region_address      The base address of the trampoline region to check.
- * @param   address_lo          The memory address lower bound to be used as condition.
- * @param   address_hi          The memory address upper bound to be used as condition.
+ * @param   region_address  The base address of the trampoline region to check.
+ * @param   address_lo      The memory address lower bound to be used as condition.
+ * @param   address_hi      The memory address upper bound to be used as condition.
+ * @param   first           Receives the index of the first chunk in range.
+ * @param   last            Receives the index of the last chunk in range.
  *
- * @return  `ZYAN_STATUS_TRUE` if both address values are in range,
- *          `ZYAN_STATUS_FALSE` if only one address value is in range, or
- *          `ZYAN_STATUS_OUT_OF_RANGE`, if both address values are out of range.
+ * @return  `ZYAN_TRUE` if at least one chunk of the region is in range, `ZYAN_FALSE` if not.
+ *
+ * The distance to both address values is monotone inside a region, which allows to calculate
+ * the range once instead of checking every chunk individually.
  */
-static ZyanBool ZyrexTrampolineRegionInRange(ZyanUPointer region_address,
-    ZyanUPointer address_lo, ZyanUPointer address_hi)
+static ZyanBool ZyrexTrampolineRegionGetChunkRange(ZyanUPointer region_address,
+    ZyanUPointer address_lo, ZyanUPointer address_hi, ZyanUSize* first, ZyanUSize* last)
 {
     ZYAN_ASSERT(g_trampoline_data.is_initialized);
     ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO(region_address, g_trampoline_data.region_size));
+    ZYAN_ASSERT(address_lo <= address_hi);
+    ZYAN_ASSERT(first);
+    ZYAN_ASSERT(last);
+
+    const ZyanI64 chunk_size = (ZyanI64)sizeof(ZyrexTrampolineChunk);
 
-    // Skip the first chunk as it shares memory with the region-header
-    const ZyanIPointer region_base = region_address + sizeof(ZyrexTrampolineChunk);
+    // A chunk is in range, if `address_hi` can reach the chunk base and the chunk end is
+    // reachable from `address_lo`
+    const ZyanI64 base_min = (ZyanI64)address_hi - ZYREX_RANGEOF_RELATIVE_JUMP;
+    const ZyanI64 base_max = (ZyanI64)address_lo + ZYREX_RANGEOF_RELATIVE_JUMP - chunk_size;
 
-    const ZyanIPointer distance_lo =
-        region_base - (ZyanIPointer)address_lo + (ZyanIPointer)address_lo < region_base
-            ? sizeof(ZyrexTrampolineChunk)
-            : sizeof(ZyrexTrampolineChunk) * (g_trampoline_data.chunks_per_region - 1);
-    if ((ZYAN_ABS(distance_lo) > ZYREX_RANGEOF_RELATIVE_JUMP))
+    const ZyanI64 offset_min = base_min - (ZyanI64)region_address;
+    const ZyanI64 offset_max = base_max - (ZyanI64)region_address;
+    if (offset_max < 0)
     {
         return ZYAN_FALSE;
     }
 
-    const ZyanIPointer distance_hi =
-        region_base - (ZyanIPointer)address_hi + (ZyanIPointer)address_hi < region_base
-            ? sizeof(ZyrexTrampolineChunk)
-            : sizeof(ZyrexTrampolineChunk) * (g_trampoline_data.chunks_per_region - 1);
-    if ((ZYAN_ABS(distance_hi) > ZYREX_RANGEOF_RELATIVE_JUMP))
+    // Skip the leading chunks as they share memory with the region-header
+    ZyanI64 lo = (offset_min <= 0) ? 0 : (offset_min + chunk_size - 1) / chunk_size;
+    ZyanI64 hi = offset_max / chunk_size;
+    if (lo < (ZyanI64)ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS)
+    {
+        lo = (ZyanI64)ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS;
+    }
+    if (hi > (ZyanI64)g_trampoline_data.chunks_per_region - 1)
+    {
+        hi = (ZyanI64)g_trampoline_data.chunks_per_region - 1;
+    }
+    if (lo > hi)
     {
         return ZYAN_FALSE;
     }
 
+    *first = (ZyanUSize)lo;
+    *last  = (ZyanUSize)hi;
     return ZYAN_TRUE;
 }
 
+/**
+ * @brief   Checks, if at least one chunk of the given region is in a +/-2GiB range to both passed
+ *          address values.
+ *
+ * @param   region_address      The base address of the trampoline region to check.
+ * @param   address_lo          The memory address lower bound to be used as condition.
+ * @param   address_hi          The memory address upper bound to be used as condition.
+ *
+ * @return  `ZYAN_TRUE` if the region is in range, `ZYAN_FALSE` if not.
+ */
+static ZyanBool ZyrexTrampolineRegionInRange(ZyanUPointer region_address,
+    ZyanUPointer address_lo, ZyanUPointer address_hi)
+{
+    ZyanUSize first;
+    ZyanUSize last;
+    return ZyrexTrampolineRegionGetChunkRange(region_address, address_lo, address_hi, &first,
+        &last);
+}
+
+/**
+ * @brief   Returns the writable view of the given trampoline-region.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * @return  A pointer to the writable view of the trampoline-region.
+ *
+ * The region-header has to be modified through the returned pointer, as the executable view of
+ * dual-mapped regions is never writable.
+ */
+ZYAN_INLINE ZyrexTrampolineRegion* ZyrexTrampolineRegionGetWritable(
+    const ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+
+    return (ZyrexTrampolineRegion*)((ZyanUPointer)region + region->header.writable_offset);
+}
+
+/**
+ * @brief   Marks the chunk with the given index as used or unused in the occupancy bitmap of
+ *          the given region.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the chunk.
+ * @param   is_used `ZYAN_TRUE` to mark the chunk as used or `ZYAN_FALSE` to mark it as unused.
+ */
+ZYAN_INLINE void ZyrexTrampolineRegionMarkChunk(ZyrexTrampolineRegion* region, ZyanUSize index,
+    ZyanBool is_used)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT((index >= ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS) &&
+        (index < g_trampoline_data.chunks_per_region));
+
+    ZyrexTrampolineRegion* const writable = ZyrexTrampolineRegionGetWritable(region);
+    const ZyanU32 mask = (ZyanU32)1 << (index % 32);
+    if (is_used)
+    {
+        ZYAN_ASSERT(region->header.unused_chunks[index / 32] & mask);
+        writable->header.unused_chunks[index / 32] &= ~mask;
+    } else
+    {
+        ZYAN_ASSERT(!(region->header.unused_chunks[index / 32] & mask));
+        writable->header.unused_chunks[index / 32] |= mask;
+    }
+}
+
 /**
  * @brief   Searches the given trampoline-region for an unused `ZyrexTrampolineChunk` item that
  *          lies in a +/-2GiB range to both given addresses.
@@ -312,6 +792,8 @@ static ZyanBool ZyrexTrampolineRegionInRange(ZyanUPointer region_address,
  * @param   address_lo  The memory address lower bound to be used as search condition.
  * @param   address_hi  The memory address upper bound to be used as search condition.
  * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ *
+ * This function only accesses the region-header and does not touch the memory of any chunk.
  */
 static ZyanBool ZyrexTrampolineRegionFindChunkInRegion(ZyrexTrampolineRegion* region,
     ZyanUPointer address_lo, ZyanUPointer address_hi, ZyrexTrampolineChunk** chunk)
@@ -325,42 +807,84 @@ static ZyanBool ZyrexTrampolineRegionFindChunkInRegion(ZyrexTrampolineRegion* re
         return ZYAN_FALSE;
     }
 
-    if (!ZyrexTrampolineRegionInRange((ZyanUPointer)region, address_lo, address_hi))
+    ZyanUSize first;
+    ZyanUSize last;
+    if (!ZyrexTrampolineRegionGetChunkRange((ZyanUPointer)region, address_lo, address_hi, &first,
+        &last))
     {
         return ZYAN_FALSE;
     }
 
-    // Skip the first chunk as it shares memory with the region-header
-    for (ZyanUSize i = 1; i < g_trampoline_data.chunks_per_region; ++i)
+    for (ZyanUSize i = first / 32; i <= last / 32; ++i)
     {
-        if (region->chunks[i].is_used)
+        ZyanU32 bits = region->header.unused_chunks[i];
+        if (i == first / 32)
         {
-            continue;
+            bits &= ~(ZyanU32)0 << (first % 32);
         }
-
-        const ZyanIPointer chunk_base = (ZyanIPointer)&region->chunks[i];
-
-        const ZyanIPointer distance_lo_chunk = chunk_base - (ZyanIPointer)address_lo +
-            (((ZyanIPointer)address_lo < chunk_base) ? sizeof(ZyrexTrampolineChunk) : 0);
-        if ((ZYAN_ABS(distance_lo_chunk) > ZYREX_RANGEOF_RELATIVE_JUMP))
+        if ((i == last / 32) && ((last % 32) != 31))
         {
-            continue;
+            bits &= ((ZyanU32)1 << (last % 32 + 1)) - 1;
         }
-
-        const ZyanIPointer distance_hi_chunk = chunk_base - (ZyanIPointer)address_hi +
-            (((ZyanIPointer)address_hi < chunk_base) ? sizeof(ZyrexTrampolineChunk) : 0);
-        if ((ZYAN_ABS(distance_hi_chunk) > ZYREX_RANGEOF_RELATIVE_JUMP))
+        if (!bits)
         {
             continue;
         }
 
-        *chunk = &region->chunks[i];
+        *chunk = &region->chunks[i * 32 + ZyrexBitScanForward(bits)];
         return ZYAN_TRUE;
     }
 
     return ZYAN_FALSE;
 }
 
+/**
+ * @brief   Returns the number of unused `ZyrexTrampolineChunk` items in the given trampoline-region
+ *          that lie in a +/-2GiB range to both given addresses.
+ *
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   address_lo  The memory address lower bound.
+ * @param   address_hi  The memory address upper bound.
+ *
+ * @return  The number of unused chunks in range.
+ */
+static ZyanUSize ZyrexTrampolineRegionCountChunksInRegion(const ZyrexTrampolineRegion* region,
+    ZyanUPointer address_lo, ZyanUPointer address_hi)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    if (region->header.number_of_unused_chunks == 0)
+    {
+        return 0;
+    }
+
+    ZyanUSize first;
+    ZyanUSize last;
+    if (!ZyrexTrampolineRegionGetChunkRange((ZyanUPointer)region, address_lo, address_hi, &first,
+        &last))
+    {
+        return 0;
+    }
+
+    ZyanUSize count = 0;
+    for (ZyanUSize i = first / 32; i <= last / 32; ++i)
+    {
+        ZyanU32 bits = region->header.unused_chunks[i];
+        if (i == first / 32)
+        {
+            bits &= ~(ZyanU32)0 << (first % 32);
+        }
+        if ((i == last / 32) && ((last % 32) != 31))
+        {
+            bits &= ((ZyanU32)1 << (last % 32 + 1)) - 1;
+        }
+        count += ZyrexPopCount(bits);
+    }
+
+    return count;
+}
+
 /**
  * @brief   Searches the global trampoline-region list for an unused `ZyrexTrampolineChunk` item
  *          that lies in a +/-2GiB range to both given addresses.
@@ -445,6 +969,9 @@ RegionNotFound:
  * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
  *
  * @return  A zyan status code.
+ *
+ * The region is published to the region table as the last step, which can not fail. Once
+ * published, the region must not be released anymore.
  */
 static ZyanStatus ZyrexTrampolineRegionInsert(ZyrexTrampolineRegion* region)
 {
@@ -459,338 +986,1945 @@ static ZyanStatus ZyrexTrampolineRegionInsert(ZyrexTrampolineRegion* region)
     ZYAN_CHECK(status);
 
     ZYAN_ASSERT(status == ZYAN_STATUS_FALSE);
-    return ZyanVectorInsert(&g_trampoline_data.regions, found_index, &region);
+
+    ZYAN_CHECK(ZyrexTrampolineRegionTableReserve());
+    ZYAN_CHECK(ZyanVectorInsert(&g_trampoline_data.regions, found_index, &region));
+    ZyrexTrampolineRegionTableStore(g_trampoline_data.region_table, (ZyanUPointer)region);
+
+    return ZYAN_STATUS_SUCCESS;
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+
 /**
- * @brief   Removes the given `ZyrexTrampolineRegion` item from the global trampoline-region list.
- *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
+ * @brief   Returns the range of memory pages occupied by the trampoline-chunk with the given
+ *          index.
  *
- * @return  A zyan status code.
+ * @param   index   The index of the chunk.
+ * @param   first   Receives the index of the first page.
+ * @param   last    Receives the index of the last page.
  */
-static ZyanStatus ZyrexTrampolineRegionRemove(ZyrexTrampolineRegion* region)
+ZYAN_INLINE void ZyrexTrampolineRegionGetChunkPages(ZyanUSize index, ZyanUSize* first,
+    ZyanUSize* last)
 {
-    ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
-
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region, &found_index,
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
+    ZYAN_ASSERT(first);
+    ZYAN_ASSERT(last);
 
-    ZYAN_ASSERT(status == ZYAN_STATUS_TRUE);
-    return ZyanVectorDelete(&g_trampoline_data.regions, found_index);
+    *first = (index * sizeof(ZyrexTrampolineChunk)) / g_trampoline_data.page_size;
+    *last  = ((index + 1) * sizeof(ZyrexTrampolineChunk) - 1) / g_trampoline_data.page_size;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Changes the memory protection of the passed trampoline-region to `RX`.
+ * @brief   Checks, if all memory pages occupied by the trampoline-chunk with the given index
+ *          are committed.
  *
  * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the chunk.
  *
- * @return  A zyan status code.
+ * @return  `ZYAN_TRUE` if all pages of the chunk are committed, `ZYAN_FALSE` if not.
+ *
+ * This function only accesses the region-header.
  */
-static ZyanStatus ZyrexTrampolineRegionProtect(ZyrexTrampolineRegion* region)
+ZYAN_INLINE ZyanBool ZyrexTrampolineRegionIsChunkCommitted(const ZyrexTrampolineRegion* region,
+    ZyanUSize index)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
 
-    return ZyanMemoryVirtualProtect(region, sizeof(ZyrexTrampolineChunk), 
-        ZYAN_PAGE_EXECUTE_READ);
+    ZyanUSize first;
+    ZyanUSize last;
+    ZyrexTrampolineRegionGetChunkPages(index, &first, &last);
+
+    const ZyanU32 mask = (ZyanU32)(((ZyanU64)1 << (last + 1)) - ((ZyanU64)1 << first));
+    return ((region->header.committed_pages & mask) == mask) ? ZYAN_TRUE : ZYAN_FALSE;
 }
 
 /**
- * @brief   Changes the memory protection of the passed trampoline-region to `RWX`.
+ * @brief   Commits all memory pages occupied by the trampoline-chunk with the given index.
  *
  * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the chunk.
  *
  * @return  A zyan status code.
+ *
+ * Pages committed by this function will have `RWX` memory protection.
  */
-static ZyanStatus ZyrexTrampolineRegionUnprotect(ZyrexTrampolineRegion* region)
+static ZyanStatus ZyrexTrampolineRegionCommitChunk(ZyrexTrampolineRegion* region,
+    ZyanUSize index)
 {
     ZYAN_ASSERT(region);
     ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
 
-    return ZyanMemoryVirtualProtect(region, sizeof(ZyrexTrampolineChunk),
-        ZYAN_PAGE_EXECUTE_READWRITE);
+    ZyanUSize first;
+    ZyanUSize last;
+    ZyrexTrampolineRegionGetChunkPages(index, &first, &last);
+
+    for (ZyanUSize i = first; i <= last; ++i)
+    {
+        if (region->header.committed_pages & ((ZyanU32)1 << i))
+        {
+            continue;
+        }
+
+        void* const address = (ZyanU8*)region + i * g_trampoline_data.page_size;
+#if defined(ZYAN_WINDOWS)
+        if (!VirtualAlloc(address, g_trampoline_data.page_size, MEM_COMMIT,
+            PAGE_EXECUTE_READWRITE))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+#elif defined(ZYAN_POSIX)
+        if (mprotect(address, g_trampoline_data.page_size, PROT_READ | PROT_WRITE | PROT_EXEC))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+#endif
+
+        ZyrexTrampolineRegionGetWritable(region)->header.committed_pages |= (ZyanU32)1 << i;
+        g_trampoline_data.committed_bytes += g_trampoline_data.page_size;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
 }
 
 /**
- * Allocates memory for a new trampoline region in a +/-2GiB range of both passed address values
- * and initializes it.
+ * @brief   Decommits all memory pages occupied by the trampoline-chunk with the given index that
+ *          are not shared with any other used chunk.
  *
- * @param   address_lo  The memory address lower bound.
- * @param   address_hi  The memory address upper bound.
- * @param   region      Receives a pointer to the new `ZyrexTrampolineRegion` struct.
- *
- * Regions allocated by this function will have `RWX` memory protection.
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the chunk. The chunk must already be marked as unused.
  *
  * @return  A zyan status code.
+ *
+ * The pages of dual-mapped regions stay committed until the region is released.
  */
-static ZyanStatus ZyrexTrampolineRegionAllocate(ZyanUPointer address_lo, ZyanUPointer address_hi,
-    ZyrexTrampolineRegion** region)
+static ZyanStatus ZyrexTrampolineRegionDecommitChunk(ZyrexTrampolineRegion* region,
+    ZyanUSize index)
 {
     ZYAN_ASSERT(region);
     ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-#ifdef ZYAN_WINDOWS
-
-    SYSTEM_INFO system_info;
-    GetSystemInfo(&system_info);
+#ifdef ZYREX_TRAMPOLINE_DUAL_MAPPING
 
-    const ZyanUSize region_size = g_trampoline_data.region_size;
-    const ZyanUPointer mid = (address_lo + address_hi) / 2;
-    const ZyanU8* alloc_address_lo =
-        (const ZyanU8*)ZYAN_ALIGN_DOWN(mid, (ZyanUPointer)region_size);
-    const ZyanU8* alloc_address_hi =
-        (const ZyanU8*)ZYAN_ALIGN_UP(mid, (ZyanUPointer)region_size);
+    ZYAN_UNUSED(index);
+    return ZYAN_STATUS_SUCCESS;
 
-    MEMORY_BASIC_INFORMATION memory_info;
+#else
 
-#endif
+    ZyanUSize first;
+    ZyanUSize last;
+    ZyrexTrampolineRegionGetChunkPages(index, &first, &last);
 
-    while (ZYAN_TRUE)
+    // The first page contains the region-header
+    if (first == 0)
     {
-#ifdef ZYAN_WINDOWS
+        first = 1;
+    }
 
-        // Skip reserved address regions
-        if (alloc_address_lo < (ZyanU8*)system_info.lpMinimumApplicationAddress)
-        {
-            alloc_address_lo = (const ZyanU8*)system_info.lpMinimumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_UP((ZyanUPointer)alloc_address_lo, region_size));
-        }
-        if (alloc_address_lo > (ZyanU8*)system_info.lpMaximumApplicationAddress)
-        {
-            alloc_address_lo = (const ZyanU8*)system_info.lpMaximumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_DOWN((ZyanUPointer)alloc_address_lo, region_size));
-        }
-        if (alloc_address_hi < (ZyanU8*)system_info.lpMinimumApplicationAddress)
+    for (ZyanUSize i = first; i <= last; ++i)
+    {
+        if (!(region->header.committed_pages & ((ZyanU32)1 << i)))
         {
-            alloc_address_hi = (const ZyanU8*)system_info.lpMinimumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_UP((ZyanUPointer)alloc_address_lo, region_size));
+            continue;
         }
-        if (alloc_address_hi > (ZyanU8*)system_info.lpMaximumApplicationAddress)
+
+        // Check all chunks that overlap with the current page
+        const ZyanUSize page_begin = i * g_trampoline_data.page_size;
+        const ZyanUSize page_end = page_begin + g_trampoline_data.page_size;
+        const ZyanUSize chunk_lo = page_begin / sizeof(ZyrexTrampolineChunk);
+        ZyanUSize chunk_hi = (page_end - 1) / sizeof(ZyrexTrampolineChunk);
+        if (chunk_hi >= g_trampoline_data.chunks_per_region)
         {
-            alloc_address_hi = (const ZyanU8*)system_info.lpMaximumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_DOWN((ZyanUPointer)alloc_address_lo, region_size));
+            chunk_hi = g_trampoline_data.chunks_per_region - 1;
         }
 
-//#endif
-
-        // TODO: Only `RESERVE` the memory region and `COMMIT` pages on demand to reduce memory
-        // TODO: imprint
-
-        ZyanU8 c = 0;
-
-        if (ZyrexTrampolineRegionInRange((ZyanUPointer)alloc_address_lo, address_lo, address_hi))
+        ZyanBool is_used = ZYAN_FALSE;
+        for (ZyanUSize j = chunk_lo; j <= chunk_hi; ++j)
         {
-            ZYAN_MEMSET(&memory_info, 0, sizeof(memory_info));
-            if (!VirtualQuery(alloc_address_lo, &memory_info, sizeof(memory_info)))
-            {
-                return ZYAN_STATUS_BAD_SYSTEMCALL;
-            }
-            if ((memory_info.State == MEM_FREE) && (memory_info.RegionSize >= region_size))
+            if (!(region->header.unused_chunks[j / 32] & ((ZyanU32)1 << (j % 32))))
             {
-                *region = VirtualAlloc((void*)alloc_address_lo, region_size,
-                    MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
-                if (*region)
-                {
-                    goto InitializeRegion;
-                }
+                is_used = ZYAN_TRUE;
+                break;
             }
-            alloc_address_lo = (const ZyanU8*)((ZyanUPointer)memory_info.BaseAddress - region_size);
-            ++c;
         }
-
-        if (ZyrexTrampolineRegionInRange((ZyanUPointer)alloc_address_hi, address_lo, address_hi))
+        if (is_used)
         {
-            memset(&memory_info, 0, sizeof(memory_info));
-            if (!VirtualQuery(alloc_address_hi, &memory_info, sizeof(memory_info)))
-            {
-                return ZYAN_STATUS_BAD_SYSTEMCALL;
-            }
-            if ((memory_info.State == MEM_FREE) && (memory_info.RegionSize >= region_size))
-            {
-                *region = VirtualAlloc((void*)alloc_address_hi, region_size,
-                    MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
-                if (*region)
-                {
-                    goto InitializeRegion;
-                }
-            }
-            alloc_address_hi = (const ZyanU8*)((ZyanUPointer)memory_info.BaseAddress + region_size);
-            ++c;
+            continue;
         }
 
-        if (c == 0)
+        void* const address = (ZyanU8*)region + page_begin;
+#if defined(ZYAN_WINDOWS)
+        if (!VirtualFree(address, g_trampoline_data.page_size, MEM_DECOMMIT))
         {
-            return ZYAN_STATUS_OUT_OF_RANGE;
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+#elif defined(ZYAN_POSIX)
+        if (madvise(address, g_trampoline_data.page_size, MADV_DONTNEED) ||
+            mprotect(address, g_trampoline_data.page_size, PROT_NONE))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
         }
-#else
-        ZYAN_UNUSED(address_lo);
-        ZYAN_UNUSED(address_hi);
 #endif
+
+        region->header.committed_pages &= ~((ZyanU32)1 << i);
+        g_trampoline_data.committed_bytes -= g_trampoline_data.page_size;
     }
 
-    // ZYAN_UNREACHABLE;
+    return ZYAN_STATUS_SUCCESS;
 
-#ifdef ZYAN_WINDOWS
-InitializeRegion:
-    (*region)->header.signature = ZYREX_TRAMPOLINE_REGION_SIGNATURE;
-    (*region)->header.number_of_unused_chunks = g_trampoline_data.chunks_per_region - 1;
 #endif
-
-    return ZYAN_STATUS_SUCCESS;
 }
 
+#ifndef ZYREX_TRAMPOLINE_DUAL_MAPPING
+
 /**
- * @brief   Frees the memory of the given trampoline region.
+ * @brief   Changes the memory protection of all committed pages of the passed trampoline-region.
  *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   protection  The new page protection.
  *
  * @return  A zyan status code.
  */
-static ZyanStatus ZyrexTrampolineRegionFree(ZyrexTrampolineRegion* region)
+static ZyanStatus ZyrexTrampolineRegionSetProtection(ZyrexTrampolineRegion* region,
+    ZyanMemoryPageProtection protection)
 {
     ZYAN_ASSERT(region);
     ZYAN_ASSERT(g_trampoline_data.is_initialized);
     ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
 
-    return ZyanMemoryVirtualFree(region, g_trampoline_data.region_size);
+    // Uncommitted pages can not be protected, so every run of committed pages is processed
+    // individually
+    const ZyanU32 pages = region->header.committed_pages;
+    ZyanUSize i = 0;
+    while (i < ZYREX_TRAMPOLINE_REGION_MAX_PAGES)
+    {
+        if (!(pages & ((ZyanU32)1 << i)))
+        {
+            ++i;
+            continue;
+        }
+
+        const ZyanUSize first = i;
+        while ((i < ZYREX_TRAMPOLINE_REGION_MAX_PAGES) && (pages & ((ZyanU32)1 << i)))
+        {
+            ++i;
+        }
+
+        ZYAN_CHECK(ZyanMemoryVirtualProtect((ZyanU8*)region + first * g_trampoline_data.page_size,
+            (i - first) * g_trampoline_data.page_size, protection));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Trampoline chunk                                                                               */
-/* ---------------------------------------------------------------------------------------------- */
+#endif
 
 /**
- * @brief   Initializes a new trampoline chunk and relocates the instructions from the original
- *          function.
+ * @brief   Changes the memory protection of the passed trampoline-region to `RX`.
  *
- * @param   chunk               A pointer to the `ZyrexTrampolineChunk` struct.
- * @param   address             The address of the function to create the trampoline for.
- * @param   callback            The address of the callback function the hook will redirect to.
- * @param   min_bytes_to_reloc  Specifies the minimum amount of  bytes that need to be relocated
- *                              to the trampoline (usually equals the size of the branch
- *                              instruction used for hooking).
- *                              This function might copy more bytes on demand to keep individual
- *                              instructions intact.
- * @param   max_bytes_to_read   The maximum amount of bytes that can be safely read from the given
- *                              `address`.
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
  *
  * @return  A zyan status code.
  */
-static ZyanStatus ZyrexTrampolineChunkInit(ZyrexTrampolineChunk* chunk, const void* address,
-    const void* callback, ZyanUSize min_bytes_to_reloc, ZyanUSize max_bytes_to_read)
+static ZyanStatus ZyrexTrampolineRegionProtect(ZyrexTrampolineRegion* region)
 {
-    ZYAN_ASSERT(chunk);
-    ZYAN_ASSERT(address);
-    ZYAN_ASSERT(callback);
-    ZYAN_ASSERT(min_bytes_to_reloc <= max_bytes_to_read);
+#ifdef ZYREX_TRAMPOLINE_DUAL_MAPPING
+    // The executable view never changes its protection
+    ZYAN_UNUSED(region);
+    return ZYAN_STATUS_SUCCESS;
+#else
+    return ZyrexTrampolineRegionSetProtection(region, ZYAN_PAGE_EXECUTE_READ);
+#endif
+}
 
-    chunk->is_used = ZYAN_TRUE;
-    chunk->callback_address = (ZyanUPointer)callback;
+/**
+ * @brief   Changes the memory protection of the passed trampoline-region to `RWX`.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The region stays writable until the next call to `ZyrexTrampolineProtectRegions`. Subsequent
+ * calls for the same region do not change the memory protection again.
+ *
+ * Dual-mapped regions are always writable through their writable view. This function only
+ * schedules the instruction cache flush for them.
+ */
+static ZyanStatus ZyrexTrampolineRegionUnprotect(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
 
-#if defined(ZYAN_X64)
-    
-    ZyrexWriteAbsoluteJump(&chunk->callback_jump, (ZyanUPointer)&chunk->callback_address);
-    ZYAN_CHECK(ZyanProcessFlushInstructionCache(&chunk->callback_jump, 
-        ZYREX_SIZEOF_ABSOLUTE_JUMP));
+    if (region->header.is_writable)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
 
+#ifndef ZYREX_TRAMPOLINE_DUAL_MAPPING
+    ZYAN_CHECK(ZyrexTrampolineRegionSetProtection(region, ZYAN_PAGE_EXECUTE_READWRITE));
 #endif
+    ZYAN_CHECK(ZyanVectorPushBack(&g_trampoline_data.dirty_regions, &region));
+    ZyrexTrampolineRegionGetWritable(region)->header.is_writable = ZYAN_TRUE;
 
-    ZyanUSize bytes_read;
-    ZyanUSize bytes_written;
-
-    // Relocate instructions
-    ZYAN_CHECK(ZyrexRelocateCode(address, max_bytes_to_read, chunk, min_bytes_to_reloc, 
-        &bytes_read, &bytes_written));
-
-    ZYAN_ASSERT(bytes_read <= ZYAN_ARRAY_LENGTH(chunk->original_code));
-    ZYAN_ASSERT(bytes_written <= ZYAN_ARRAY_LENGTH(chunk->code_buffer));
+    return ZYAN_STATUS_SUCCESS;
+}
 
-    // Write backjump
-    ZyrexWriteAbsoluteJump(&chunk->code_buffer[bytes_written],
-        (ZyanUPointer)&chunk->backjump_address);
-    chunk->code_buffer_size = (ZyanU8)bytes_written;
-    chunk->backjump_address = (ZyanUPointer)address + bytes_read;
+/**
+ * @brief   Removes the passed trampoline-region from the `dirty_regions` list, if present.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionForget(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
 
-    // Fill remaining space with `INT 3` instructions
-    const ZyanUSize bytes_remaining = sizeof(chunk->code_buffer) - bytes_written;
-    if (bytes_remaining > 0)
+    if (!region->header.is_writable)
     {
-        ZYAN_MEMSET(&chunk->code_buffer[bytes_written + ZYREX_SIZEOF_ABSOLUTE_JUMP], 0xCC,
-            bytes_remaining - ZYREX_SIZEOF_ABSOLUTE_JUMP);
+        return ZYAN_STATUS_SUCCESS;
     }
 
-    ZYAN_CHECK(ZyanProcessFlushInstructionCache(&chunk->code_buffer, 
-        ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS));
+    for (ZyanUSize i = 0; i < g_trampoline_data.dirty_regions.size; ++i)
+    {
+        ZyrexTrampolineRegion* const* const item =
+            ZyanVectorGet(&g_trampoline_data.dirty_regions, i);
+        ZYAN_ASSERT(item);
 
-    // Backup original instructions 
-    chunk->original_code_size = (ZyanU8)bytes_read;
-    ZYAN_MEMCPY(chunk->original_code, address, bytes_read);
+        if (*item == region)
+        {
+            ZyrexTrampolineRegionGetWritable(region)->header.is_writable = ZYAN_FALSE;
+            return ZyanVectorDelete(&g_trampoline_data.dirty_regions, i);
+        }
+    }
 
-    return ZYAN_STATUS_SUCCESS;
+    ZYAN_UNREACHABLE;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
-
-/* ============================================================================================== */
-/* Public functions                                                                               */
-/* ============================================================================================== */
-
-/* ---------------------------------------------------------------------------------------------- */
-/* Creation and destruction                                                                       */
+/* Free address ranges                                                                            */
 /* ---------------------------------------------------------------------------------------------- */
 
-ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
-    ZyanUSize min_bytes_to_reloc, ZyrexTrampolineChunk** trampoline)
+/**
+ * @brief   Compares two `ZyrexAddressRange` items by their begin address.
+ */
+ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareAddressRange, ZyrexAddressRange, begin)
+
+/**
+ * @brief   Inserts the given address range into the free address range list and merges it with
+ *          adjacent items.
+ *
+ * @param   begin   The begin address of the range. Must be aligned to the region size.
+ * @param   end     The end address of the range (exclusive). Must be aligned to the region size.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexFreeRangesInsert(ZyanUPointer begin, ZyanUPointer end)
 {
-    if (!address || !callback || (min_bytes_to_reloc < 1) || !trampoline)
-    {
-        return ZYAN_STATUS_INVALID_ARGUMENT;
-    }
+    ZYAN_ASSERT(begin < end);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-    // Check if the memory region of the target function has enough space for the hook code
-    ZyanUSize source_size = ZYREX_TRAMPOLINE_MAX_CODE_SIZE;
-#ifdef ZYAN_WINDOWS
-    ZYAN_CHECK(ZyrexGetSizeOfReadableMemoryRegion(address, &source_size));
-    if (source_size < min_bytes_to_reloc)
+    ZyanVector* const ranges = &g_trampoline_data.free_ranges;
+
+    ZyrexAddressRange range = { begin, end };
+    ZyanUSize index;
+    ZYAN_CHECK(ZyanVectorBinarySearch(ranges, &range, &index,
+        (ZyanComparison)&ZyrexCompareAddressRange));
+
+    if (index > 0)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        ZyrexAddressRange* const prev = ZyanVectorGetMutable(ranges, index - 1);
+        ZYAN_ASSERT(prev && (prev->end <= begin));
+        if (prev->end == begin)
+        {
+            range.begin = prev->begin;
+            ZYAN_CHECK(ZyanVectorDelete(ranges, --index));
+        }
     }
-#endif
-
-    if (!g_trampoline_data.is_initialized)
+    if (index < ranges->size)
     {
-        ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.regions, sizeof(ZyrexTrampolineRegion*), 8, 
-            ZYAN_NULL));
-
-        g_trampoline_data.region_size = ZyanMemoryGetSystemAllocationGranularity();
-        g_trampoline_data.chunks_per_region =
-            g_trampoline_data.region_size / sizeof(ZyrexTrampolineChunk);
-
-        g_trampoline_data.is_initialized = ZYAN_TRUE;
+        const ZyrexAddressRange* const next = ZyanVectorGet(ranges, index);
+        ZYAN_ASSERT(next && (next->begin >= end));
+        if (next->begin == end)
+        {
+            range.end = next->end;
+            ZYAN_CHECK(ZyanVectorDelete(ranges, index));
+        }
     }
 
-#ifdef ZYAN_X64
-
-    // Gather memory address lower and upper bounds in order to find a suitable memory region for
-    // the trampoline
-    ZyanUPointer lo = (ZyanUPointer)(-1);
-    ZyanUPointer hi = 0;
-    ZYAN_CHECK(ZyrexGetAddressRangeOfRelativeInstructions(address, source_size,
-        ZYREX_SIZEOF_RELATIVE_JUMP, &lo, &hi));
+    return ZyanVectorInsert(ranges, index, &range);
+}
+
+/**
+ * @brief   Removes the given address range from the free address range list.
+ *
+ * @param   begin   The begin address of the range. Must be aligned to the region size.
+ * @param   end     The end address of the range (exclusive). Must be aligned to the region size.
+ *
+ * @return  A zyan status code.
+ *
+ * Parts of the given range that are not contained in the list are ignored.
+ */
+static ZyanStatus ZyrexFreeRangesRemove(ZyanUPointer begin, ZyanUPointer end)
+{
+    ZYAN_ASSERT(begin < end);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    ZyanVector* const ranges = &g_trampoline_data.free_ranges;
+
+    const ZyrexAddressRange key = { begin, end };
+    ZyanUSize index;
+    ZYAN_CHECK(ZyanVectorBinarySearch(ranges, &key, &index,
+        (ZyanComparison)&ZyrexCompareAddressRange));
+
+    // The previous item might overlap with the range as well
+    if (index > 0)
+    {
+        --index;
+    }
+
+    while (index < ranges->size)
+    {
+        ZyrexAddressRange* const item = ZyanVectorGetMutable(ranges, index);
+        ZYAN_ASSERT(item);
+
+        if (item->begin >= end)
+        {
+            break;
+        }
+        if (item->end <= begin)
+        {
+            ++index;
+            continue;
+        }
+
+        const ZyrexAddressRange lower = { item->begin, begin };
+        const ZyrexAddressRange upper = { end, item->end };
+        ZYAN_CHECK(ZyanVectorDelete(ranges, index));
+        if (upper.begin < upper.end)
+        {
+            ZYAN_CHECK(ZyanVectorInsert(ranges, index, &upper));
+        }
+        if (lower.begin < lower.end)
+        {
+            ZYAN_CHECK(ZyanVectorInsert(ranges, index++, &lower));
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Appends the given unused address range to the free address range list.
+ *
+ * @param   begin   The begin address of the range.
+ * @param   end     The end address of the range (exclusive).
+ *
+ * @return  A zyan status code.
+ *
+ * The range is shrinked to the region size alignment and only added, if it is large enough to
+ * hold at least one trampoline region. Ranges have to be passed in ascending order.
+ */
+static ZyanStatus ZyrexFreeRangesPush(ZyanUPointer begin, ZyanUPointer end)
+{
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    const ZyanUPointer region_mask = ~((ZyanUPointer)g_trampoline_data.region_size - 1);
+
+    if (begin < (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MIN)
+    {
+        begin = (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MIN;
+    }
+    if (end > (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MAX)
+    {
+        end = (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MAX;
+    }
+    if (begin >= end)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    begin = (begin + g_trampoline_data.region_size - 1) & region_mask;
+    end &= region_mask;
+    if (begin >= end)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyrexAddressRange range = { begin, end };
+    return ZyanVectorPushBack(&g_trampoline_data.free_ranges, &range);
+}
+
+#if defined(ZYAN_LINUX)
+
+/**
+ * @brief   Adds the gaps of the address space layout listed in `/proc/self/maps` to the free
+ *          address range list.
+ *
+ * @return  A zyan status code.
+ *
+ * The mappings are listed in ascending order, which allows to derive all gaps in a single pass.
+ * Only the address range in front of each line is parsed, the rest is skipped regardless of its
+ * length.
+ */
+static ZyanStatus ZyrexFreeRangesParseMaps(void)
+{
+    const int fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZyanUPointer previous_end = 0;
+    ZyanUPointer values[2] = { 0, 0 };
+    ZyanUSize field = 0;
+
+    char buffer[4096];
+    while (ZYAN_SUCCESS(status))
+    {
+        const ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            break;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        for (ssize_t i = 0; (i < count) && ZYAN_SUCCESS(status); ++i)
+        {
+            const char c = buffer[i];
+            if (c == '\n')
+            {
+                status = ZyrexFreeRangesPush(previous_end, values[0]);
+                if (values[1] > previous_end)
+                {
+                    previous_end = values[1];
+                }
+                values[0] = 0;
+                values[1] = 0;
+                field = 0;
+                continue;
+            }
+
+            // Lines start with `begin-end` in hexadecimal notation
+            if (field > 1)
+            {
+                continue;
+            }
+            ZyanUPointer digit = 16;
+            if ((c >= '0') && (c <= '9'))
+            {
+                digit = (ZyanUPointer)(c - '0');
+            }
+            if ((c >= 'a') && (c <= 'f'))
+            {
+                digit = (ZyanUPointer)(c - 'a' + 10);
+            }
+            if (digit == 16)
+            {
+                ++field;
+                continue;
+            }
+            values[field] = (values[field] << 4) | digit;
+        }
+    }
+
+    close(fd);
+    ZYAN_CHECK(status);
+
+    return ZyrexFreeRangesPush(previous_end, (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MAX);
+}
+
+#endif
+
+/**
+ * @brief   Builds the free address range list by sweeping the address space of the current
+ *          process once.
+ *
+ * @return  A zyan status code.
+ *
+ * Only ranges that are large enough to hold at least one trampoline region are added to the
+ * list. Ranges are aligned to the region size.
+ */
+static ZyanStatus ZyrexFreeRangesBuild(void)
+{
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    ZYAN_CHECK(ZyanVectorClear(&g_trampoline_data.free_ranges));
+
+#if defined(ZYAN_WINDOWS)
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    const ZyanU8* address = (const ZyanU8*)system_info.lpMinimumApplicationAddress;
+    MEMORY_BASIC_INFORMATION memory_info;
+    while (address < (const ZyanU8*)system_info.lpMaximumApplicationAddress)
+    {
+        ZYAN_MEMSET(&memory_info, 0, sizeof(memory_info));
+        if (!VirtualQuery(address, &memory_info, sizeof(memory_info)))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+
+        const ZyanUPointer base = (ZyanUPointer)memory_info.BaseAddress;
+        address = (const ZyanU8*)(base + memory_info.RegionSize);
+
+        if (memory_info.State != MEM_FREE)
+        {
+            continue;
+        }
+
+        ZYAN_CHECK(ZyrexFreeRangesPush(base, base + memory_info.RegionSize));
+    }
+
+#elif defined(ZYAN_LINUX)
+
+    ZYAN_CHECK(ZyrexFreeRangesParseMaps());
+
+#elif defined(ZYAN_POSIX)
+
+    // There is no portable way to query the address space layout. The whole user-mode address
+    // range is assumed to be free and occupied parts are removed lazily, when allocation fails
+    ZYAN_CHECK(ZyrexFreeRangesPush((ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MIN,
+        (ZyanUPointer)ZYREX_TRAMPOLINE_ADDRESS_MAX));
+
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Searches the free address range list for the region base address in a +/-2GiB range
+ *          of both passed address values that is closest to their midpoint.
+ *
+ * @param   address_lo  The memory address lower bound.
+ * @param   address_hi  The memory address upper bound.
+ * @param   address     Receives the region base address.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if a suitable address was found, `ZYAN_STATUS_FALSE` if not, or a
+ *          generic zyan status code if an error occured.
+ */
+static ZyanStatus ZyrexFreeRangesFind(ZyanUPointer address_lo, ZyanUPointer address_hi,
+    ZyanUPointer* address)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    const ZyanVector* const ranges = &g_trampoline_data.free_ranges;
+    const ZyanUPointer region_size = g_trampoline_data.region_size;
+    const ZyanUPointer mid = ((address_lo + address_hi) / 2) & ~(region_size - 1);
+
+    const ZyrexAddressRange key = { mid, mid };
+    ZyanUSize index;
+    ZYAN_CHECK(ZyanVectorBinarySearch(ranges, &key, &index,
+        (ZyanComparison)&ZyrexCompareAddressRange));
+
+    // Ranges are sorted and disjoint, which means the closest candidate below (and above) the
+    // midpoint is located in the neighboring range. The distance to the more distant address
+    // value grows monotonically when moving away from the midpoint, so if this candidate is not
+    // in range, no other one in the same direction is
+    ZyanBool is_found_lo = ZYAN_FALSE;
+    ZyanBool is_found_hi = ZYAN_FALSE;
+    ZyanUPointer candidate_lo = 0;
+    ZyanUPointer candidate_hi = 0;
+
+    if (index > 0)
+    {
+        const ZyrexAddressRange* const range = ZyanVectorGet(ranges, index - 1);
+        ZYAN_ASSERT(range && (range->begin < mid));
+
+        candidate_lo = range->end - region_size;
+        if (candidate_lo > mid)
+        {
+            candidate_lo = mid;
+        }
+        is_found_lo = ZyrexTrampolineRegionInRange(candidate_lo, address_lo, address_hi);
+    }
+    if (index < ranges->size)
+    {
+        const ZyrexAddressRange* const range = ZyanVectorGet(ranges, index);
+        ZYAN_ASSERT(range && (range->begin >= mid));
+
+        candidate_hi = range->begin;
+        is_found_hi = ZyrexTrampolineRegionInRange(candidate_hi, address_lo, address_hi);
+    }
+
+    if (!is_found_lo && !is_found_hi)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+    if (is_found_lo && (!is_found_hi || (mid - candidate_lo <= candidate_hi - mid)))
+    {
+        *address = candidate_lo;
+    } else
+    {
+        *address = candidate_hi;
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline region allocation                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+#ifdef ZYREX_TRAMPOLINE_DUAL_MAPPING
+
+/**
+ * @brief   Maps a new shared memory section twice, once with `RX` protection at the given
+ *          address and once with `RW` protection at an arbitrary address.
+ *
+ * @param   address     The base address of the executable view.
+ * @param   executable  Receives the base address of the executable view.
+ * @param   writable    Receives the base address of the writable view.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the section was mapped, `ZYAN_STATUS_FALSE` if the address
+ *          range is not available, or a generic zyan status code if an error occured.
+ *
+ * The whole section is committed right away. Physical memory is still only assigned on first
+ * access.
+ */
+static ZyanStatus ZyrexTrampolineRegionMapViews(ZyanUPointer address, void** executable,
+    void** writable)
+{
+    ZYAN_ASSERT(executable);
+    ZYAN_ASSERT(writable);
+
+    const ZyanUSize region_size = g_trampoline_data.region_size;
+
+#if defined(ZYAN_WINDOWS)
+
+    const HANDLE section = CreateFileMappingW(INVALID_HANDLE_VALUE, ZYAN_NULL,
+        PAGE_EXECUTE_READWRITE | SEC_COMMIT, (DWORD)((ZyanU64)region_size >> 32),
+        (DWORD)region_size, ZYAN_NULL);
+    if (!section)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    // The views keep the section alive after closing the handle
+    *executable = MapViewOfFileEx(section, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, region_size,
+        (void*)address);
+    if (!*executable)
+    {
+        CloseHandle(section);
+        return ZYAN_STATUS_FALSE;
+    }
+    *writable = MapViewOfFile(section, FILE_MAP_WRITE, 0, 0, region_size);
+    CloseHandle(section);
+    if (!*writable)
+    {
+        UnmapViewOfFile(*executable);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+#elif defined(ZYAN_LINUX)
+
+    const int fd = (int)syscall(SYS_memfd_create, "zyrex", 0);
+    if (fd < 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (ftruncate(fd, (off_t)region_size))
+    {
+        close(fd);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    // The mappings keep the memory file alive after closing the descriptor
+    *executable = mmap((void*)address, region_size, PROT_READ | PROT_EXEC,
+        MAP_SHARED | ZYREX_MAP_FIXED_NOREPLACE, fd, 0);
+    if (*executable == MAP_FAILED)
+    {
+        close(fd);
+        return (errno == EEXIST) ? ZYAN_STATUS_FALSE : ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (*executable != (void*)address)
+    {
+        munmap(*executable, region_size);
+        close(fd);
+        return ZYAN_STATUS_FALSE;
+    }
+    *writable = mmap(ZYAN_NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (*writable == MAP_FAILED)
+    {
+        munmap(*executable, region_size);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+#else
+#   error "Dual-mapped trampoline regions are not supported on this platform"
+#endif
+
+    return ZYAN_STATUS_TRUE;
+}
+
+#endif
+
+/**
+ * @brief   Releases the memory of a trampoline region.
+ *
+ * @param   memory          The base address of the trampoline region.
+ * @param   writable_offset The distance between the writable view and the executable view of
+ *                          the trampoline-region.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionReleaseMemory(void* memory, ZyanUPointer writable_offset)
+{
+    ZYAN_ASSERT(memory);
+
+#ifdef ZYREX_TRAMPOLINE_DUAL_MAPPING
+
+    void* const writable = (void*)((ZyanUPointer)memory + writable_offset);
+
+#   if defined(ZYAN_WINDOWS)
+    if (!UnmapViewOfFile(writable) || !UnmapViewOfFile(memory))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#   else
+    if (munmap(writable, g_trampoline_data.region_size) ||
+        munmap(memory, g_trampoline_data.region_size))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#   endif
+
+    return ZYAN_STATUS_SUCCESS;
+
+#else
+
+    ZYAN_ASSERT(!writable_offset);
+    ZYAN_UNUSED(writable_offset);
+    return ZyanMemoryVirtualFree(memory, g_trampoline_data.region_size);
+
+#endif
+}
+
+/**
+ * @brief   Reserves the memory for a new trampoline region at the given address and initializes
+ *          the region-header.
+ *
+ * @param   address The region base address.
+ * @param   region  Receives a pointer to the new `ZyrexTrampolineRegion` struct.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the region was allocated, `ZYAN_STATUS_FALSE` if the address
+ *          range is not available, or a generic zyan status code if an error occured.
+ *
+ * The memory of the region is only reserved and the first page, which contains the
+ * region-header, is committed. All other pages are committed on demand. Committed pages will
+ * have `RWX` memory protection until the next call to `ZyrexTrampolineProtectRegions`.
+ *
+ * If `ZYREX_TRAMPOLINE_DUAL_MAPPING` is defined, the region is fully committed and mapped twice
+ * instead. The returned executable view is `RX` and all modifications are written through the
+ * `RW` view.
+ */
+static ZyanStatus ZyrexTrampolineRegionReserveAt(ZyanUPointer address,
+    ZyrexTrampolineRegion** region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO(address, g_trampoline_data.region_size));
+
+    const ZyanUSize region_size = g_trampoline_data.region_size;
+
+#if defined(ZYREX_TRAMPOLINE_DUAL_MAPPING)
+
+    void* memory;
+    void* writable;
+    const ZyanStatus map_status = ZyrexTrampolineRegionMapViews(address, &memory, &writable);
+    if (map_status != ZYAN_STATUS_TRUE)
+    {
+        return map_status;
+    }
+    const ZyanUPointer writable_offset = (ZyanUPointer)writable - (ZyanUPointer)memory;
+
+    // The writable view is placed by the system and might occupy a part of a free address range
+    if (g_trampoline_data.is_free_ranges_valid)
+    {
+        const ZyanUPointer region_mask = ~((ZyanUPointer)region_size - 1);
+        const ZyanUPointer begin = (ZyanUPointer)writable & region_mask;
+        const ZyanUPointer end = ((ZyanUPointer)writable + 2 * region_size - 1) & region_mask;
+        const ZyanStatus status = ZyrexFreeRangesRemove(begin, end);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionReleaseMemory(memory, writable_offset));
+            return status;
+        }
+    }
+
+    ZyanUSize number_of_pages = region_size / g_trampoline_data.page_size;
+    if (number_of_pages > ZYREX_TRAMPOLINE_REGION_MAX_PAGES)
+    {
+        number_of_pages = ZYREX_TRAMPOLINE_REGION_MAX_PAGES;
+    }
+    const ZyanU32 committed_pages = (ZyanU32)(((ZyanU64)1 << number_of_pages) - 1);
+
+#elif defined(ZYAN_WINDOWS)
+
+    void* const memory = VirtualAlloc((void*)address, region_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (!memory)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+    if (!VirtualAlloc(memory, g_trampoline_data.page_size, MEM_COMMIT, PAGE_EXECUTE_READWRITE))
+    {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    void* const writable = memory;
+    const ZyanUPointer writable_offset = 0;
+    const ZyanU32 committed_pages = 1;
+
+#elif defined(ZYAN_POSIX)
+
+    void* const memory = mmap((void*)address, region_size, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | ZYREX_MAP_FIXED_NOREPLACE, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return (errno == EEXIST) ? ZYAN_STATUS_FALSE : ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    if (memory != (void*)address)
+    {
+        munmap(memory, region_size);
+        return ZYAN_STATUS_FALSE;
+    }
+    if (mprotect(memory, g_trampoline_data.page_size, PROT_READ | PROT_WRITE | PROT_EXEC))
+    {
+        munmap(memory, region_size);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    void* const writable = memory;
+    const ZyanUPointer writable_offset = 0;
+    const ZyanU32 committed_pages = 1;
+
+#endif
+
+    // The bookkeeping data of the chunks is kept out of the executable region memory
+    const ZyanUSize info_size =
+        g_trampoline_data.chunks_per_region * sizeof(ZyrexTrampolineChunkInfo);
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyrexTrampolineChunkInfo* const chunk_info = ZYAN_MALLOC(info_size);
+    if (!chunk_info)
+    {
+        ZYAN_UNUSED(ZyrexTrampolineRegionReleaseMemory(memory, writable_offset));
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMSET(chunk_info, 0, info_size);
+
+    // The region is writable right after allocation and has to be re-protected at the end of
+    // the current transaction
+    const ZyanStatus status = ZyanVectorPushBack(&g_trampoline_data.dirty_regions, &memory);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_FREE(chunk_info);
+        ZYAN_UNUSED(ZyrexTrampolineRegionReleaseMemory(memory, writable_offset));
+        return status;
+    }
+
+    g_trampoline_data.reserved_bytes += region_size;
+    g_trampoline_data.committed_bytes +=
+        ZyrexPopCount(committed_pages) * g_trampoline_data.page_size;
+
+    ZyrexTrampolineRegion* const value = (ZyrexTrampolineRegion*)writable;
+    value->header.signature = ZYREX_TRAMPOLINE_REGION_SIGNATURE;
+    value->header.number_of_unused_chunks =
+        g_trampoline_data.chunks_per_region - ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS;
+    value->header.committed_pages = committed_pages;
+    value->header.is_writable = ZYAN_TRUE;
+    value->header.writable_offset = writable_offset;
+    value->header.chunk_info = chunk_info;
+    ZYAN_MEMSET(value->header.unused_chunks, 0, sizeof(value->header.unused_chunks));
+
+    *region = (ZyrexTrampolineRegion*)memory;
+    for (ZyanUSize i = ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS;
+        i < g_trampoline_data.chunks_per_region; ++i)
+    {
+        ZyrexTrampolineRegionMarkChunk(*region, i, ZYAN_FALSE);
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/**
+ * Allocates memory for a new trampoline region in a +/-2GiB range of both passed address values
+ * and initializes it.
+ *
+ * @param   address_lo  The memory address lower bound.
+ * @param   address_hi  The memory address upper bound.
+ * @param   region      Receives a pointer to the new `ZyrexTrampolineRegion` struct.
+ *
+ * The region is placed at the free address closest to the midpoint of both address values. Free
+ * addresses are looked up in the free address range list, which is built once and updated on
+ * every allocation.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionAllocate(ZyanUPointer address_lo, ZyanUPointer address_hi,
+    ZyrexTrampolineRegion** region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    if (!g_trampoline_data.is_free_ranges_valid)
+    {
+        ZYAN_CHECK(ZyrexFreeRangesBuild());
+        g_trampoline_data.is_free_ranges_valid = ZYAN_TRUE;
+    }
+
+    ZyanBool is_rebuilt = ZYAN_FALSE;
+    while (ZYAN_TRUE)
+    {
+        ZyanUPointer address;
+        ZyanStatus status = ZyrexFreeRangesFind(address_lo, address_hi, &address);
+        ZYAN_CHECK(status);
+
+        if (status == ZYAN_STATUS_FALSE)
+        {
+            // Memory might have been released by other code since the last sweep
+            if (is_rebuilt)
+            {
+                return ZYAN_STATUS_OUT_OF_RANGE;
+            }
+            ZYAN_CHECK(ZyrexFreeRangesBuild());
+            is_rebuilt = ZYAN_TRUE;
+            continue;
+        }
+
+        status = ZyrexTrampolineRegionReserveAt(address, region);
+        ZYAN_CHECK(status);
+
+        // Either way, the address range is no longer available. If the allocation failed, the
+        // list is outdated as other code allocated the memory since the last sweep
+        ZYAN_CHECK(ZyrexFreeRangesRemove(address, address + g_trampoline_data.region_size));
+
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            ++g_trampoline_data.region_allocations;
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+}
+
+/**
+ * @brief   Frees the memory of the given trampoline region.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionFree(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+
+    ZYAN_CHECK(ZyrexTrampolineRegionForget(region));
+
+    ZyanUSize committed_pages = 0;
+    for (ZyanU32 pages = region->header.committed_pages; pages; pages &= pages - 1)
+    {
+        ++committed_pages;
+    }
+
+    ZyrexTrampolineChunkInfo* const chunk_info = region->header.chunk_info;
+    ZYAN_CHECK(ZyrexTrampolineRegionReleaseMemory(region, region->header.writable_offset));
+    ZYAN_FREE(chunk_info);
+
+    g_trampoline_data.reserved_bytes -= g_trampoline_data.region_size;
+    g_trampoline_data.committed_bytes -= committed_pages * g_trampoline_data.page_size;
+
+    if (g_trampoline_data.is_free_ranges_valid)
+    {
+        ZYAN_CHECK(ZyrexFreeRangesInsert((ZyanUPointer)region,
+            (ZyanUPointer)region + g_trampoline_data.region_size));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization                                                                                 */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Initializes the global trampoline API data, if not already done.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineInitialize(void)
+{
+    if (g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.regions, sizeof(ZyrexTrampolineRegion*), 8, 
+        ZYAN_NULL));
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.chunks, sizeof(ZyrexTrampolineChunk*), 32,
+        ZYAN_NULL));
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.free_indices, sizeof(ZyanU32), 32,
+        ZYAN_NULL));
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.free_ranges, sizeof(ZyrexAddressRange), 64,
+        ZYAN_NULL));
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.dirty_regions, sizeof(ZyrexTrampolineRegion*),
+        8, ZYAN_NULL));
+    g_trampoline_data.is_free_ranges_valid = ZYAN_FALSE;
+
+    g_trampoline_data.region_size = ZyanMemoryGetSystemAllocationGranularity();
+    g_trampoline_data.page_size = ZyanMemoryGetSystemPageSize();
+
+    ZyanUSize region_size = g_trampoline_data.region_size;
+    if (region_size > ZYREX_TRAMPOLINE_REGION_MAX_PAGES * g_trampoline_data.page_size)
+    {
+        region_size = ZYREX_TRAMPOLINE_REGION_MAX_PAGES * g_trampoline_data.page_size;
+    }
+    g_trampoline_data.chunks_per_region = region_size / sizeof(ZyrexTrampolineChunk);
+    if (g_trampoline_data.chunks_per_region > ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS)
+    {
+        g_trampoline_data.chunks_per_region = ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS;
+    }
+
+    g_trampoline_data.is_initialized = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline chunk lookup                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Resolves the used trampoline chunk that starts at the given address.
+ *
+ * @param   address A pointer to the beginning of a `ZyrexTrampolineChunk` struct.
+ * @param   region  Receives a pointer to the `ZyrexTrampolineRegion` that contains the chunk.
+ * @param   chunk   Receives a pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  `ZYAN_TRUE` if the address identifies a used trampoline chunk, `ZYAN_FALSE` if not.
+ *
+ * The address is rounded down to the region size and looked up in the region table, before any
+ * memory is accessed. The chunk itself is then validated using the `is_used` flag of the chunk
+ * info. This function does not use any locks and can be called from any thread.
+ */
+static ZyanBool ZyrexTrampolineChunkFromAddress(ZyanUPointer address,
+    ZyrexTrampolineRegion** region, ZyrexTrampolineChunk** chunk)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+
+    // The table is published after `region_size` and `chunks_per_region` have been initialized
+    const ZyrexTrampolineRegionTable* const table = ZyrexTrampolineRegionTableLoad();
+    if (!table)
+    {
+        return ZYAN_FALSE;
+    }
+
+    const ZyanUPointer region_address =
+        address & ~((ZyanUPointer)g_trampoline_data.region_size - 1);
+    const ZyanUPointer offset = address - region_address;
+    const ZyanUSize index = offset / sizeof(ZyrexTrampolineChunk);
+
+    // The leading chunks share memory with the region-header
+    if ((offset % sizeof(ZyrexTrampolineChunk)) ||
+        (index < ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS) ||
+        (index >= g_trampoline_data.chunks_per_region))
+    {
+        return ZYAN_FALSE;
+    }
+
+    // Arbitrary addresses might point to unmapped or uncommitted memory
+    if (!ZyrexTrampolineRegionTableContains(table, region_address))
+    {
+        return ZYAN_FALSE;
+    }
+
+    // The memory of unused chunks might not be committed
+    ZyrexTrampolineRegion* const value = (ZyrexTrampolineRegion*)region_address;
+    if ((value->header.signature != ZYREX_TRAMPOLINE_REGION_SIGNATURE) ||
+        !ZyrexTrampolineRegionIsChunkCommitted(value, index) ||
+        !value->header.chunk_info[index].is_used)
+    {
+        return ZYAN_FALSE;
+    }
+
+    *region = value;
+    *chunk = &value->chunks[index];
+    return ZYAN_TRUE;
+}
+
+/**
+ * @brief   Resolves the used trampoline chunk that owns the given trampoline code pointer.
+ *
+ * @param   code    A pointer to the code buffer of a trampoline chunk.
+ * @param   region  Receives a pointer to the `ZyrexTrampolineRegion` that contains the chunk.
+ * @param   chunk   Receives a pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  `ZYAN_TRUE` if the pointer identifies a used trampoline chunk, `ZYAN_FALSE` if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexTrampolineChunkFromCode(const void* code,
+    ZyrexTrampolineRegion** region, ZyrexTrampolineChunk** chunk)
+{
+    const ZyanUPointer address = (ZyanUPointer)code;
+    if (address < offsetof(ZyrexTrampolineChunk, code_buffer))
+    {
+        return ZYAN_FALSE;
+    }
+
+    return ZyrexTrampolineChunkFromAddress(address - offsetof(ZyrexTrampolineChunk, code_buffer),
+        region, chunk);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline chunk index                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Assigns a dense index to the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * Indices of previously released chunks are reused to keep the index range as dense as possible.
+ * Every acquired index receives a new generation, which allows to detect reused indices.
+ */
+static ZyanStatus ZyrexTrampolineIndexAcquire(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    // The generation `0` is never assigned and marks per-thread data that was never used
+    if (++g_trampoline_data.index_generation == 0)
+    {
+        ++g_trampoline_data.index_generation;
+    }
+    ZyrexTrampolineGetChunkInfo(chunk)->generation = g_trampoline_data.index_generation;
+
+    if (g_trampoline_data.free_indices.size > 0)
+    {
+        const ZyanU32* const value = ZyanVectorGet(&g_trampoline_data.free_indices,
+            g_trampoline_data.free_indices.size - 1);
+        ZYAN_ASSERT(value);
+
+        const ZyanU32 index = *value;
+        ZYAN_CHECK(ZyanVectorPopBack(&g_trampoline_data.free_indices));
+
+        ZyrexTrampolineChunk** const element =
+            ZyanVectorGetMutable(&g_trampoline_data.chunks, index);
+        ZYAN_ASSERT(element && !*element);
+        *element = chunk;
+
+        ZyrexTrampolineGetChunkInfo(chunk)->index = index;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZYAN_CHECK(ZyanVectorPushBack(&g_trampoline_data.chunks, &chunk));
+    ZyrexTrampolineGetChunkInfo(chunk)->index = (ZyanU32)(g_trampoline_data.chunks.size - 1);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Releases the dense index of the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineIndexRelease(const ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    const ZyrexTrampolineChunkInfo* const info = ZyrexTrampolineGetChunkInfo(chunk);
+    ZyrexTrampolineChunk** const element =
+        ZyanVectorGetMutable(&g_trampoline_data.chunks, info->index);
+    ZYAN_ASSERT(element && (*element == chunk));
+    *element = ZYAN_NULL;
+
+#ifdef ZYREX_HOOK_THREAD_MASK
+    // Threads that disabled the previous owner of the index must not bypass the next one
+    ZYAN_CHECK(ZyrexThreadMaskReleaseIndex(info->index));
+#endif
+
+    return ZyanVectorPushBack(&g_trampoline_data.free_indices, &info->index);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline chunk                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Encodes a jump from the given `address` in a trampoline chunk to the given
+ *          `destination`.
+ *
+ * @param   buffer      A pointer to the buffer that receives the `ZYREX_SIZEOF_ABSOLUTE_JUMP`
+ *                      instruction bytes.
+ * @param   address     The executable address of the jump.
+ * @param   destination The destination address.
+ * @param   slot        The executable address of the memory that holds the `destination`.
+ *
+ * A relative jump is encoded, if the `destination` is in range. The absolute indirect jump that
+ * reads the `slot` is only used as a fallback. Both forms occupy the same amount of bytes.
+ */
+static void ZyrexTrampolineEncodeJump(ZyanU8* buffer, ZyanUPointer address,
+    ZyanUPointer destination, ZyanUPointer slot)
+{
+    ZYAN_ASSERT(buffer);
+
+    if (ZyrexIsRelativeJumpInRange(address, destination))
+    {
+        const ZyanI32 offset =
+            ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_RELATIVE_JUMP, address, destination);
+        buffer[0] = 0xE9;
+        ZYAN_MEMCPY(&buffer[1], &offset, sizeof(offset));
+        buffer[ZYREX_SIZEOF_RELATIVE_JUMP] = 0xCC;
+        return;
+    }
+
+    buffer[0] = 0xFF;
+    buffer[1] = 0x25;
+#if defined(ZYAN_X64)
+    const ZyanI32 offset = ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_ABSOLUTE_JUMP, address, slot);
+#else
+    const ZyanU32 offset = (ZyanU32)slot;
+#endif
+    ZYAN_MEMCPY(&buffer[2], &offset, sizeof(offset));
+}
+
+/**
+ * @brief   Returns the address of the jump to the callback function at the end of the callback
+ *          stub of the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  The executable address of the jump to the callback function.
+ */
+static ZyanU8* ZyrexTrampolineChunkGetCallbackJump(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+#ifdef ZYREX_HOOK_STATISTICS
+    if (ZyrexStatisticsGetEntry(ZyrexTrampolineGetChunkInfo(chunk)->index))
+    {
+        return &chunk->callback_jump[
+            ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE + ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE];
+    }
+#endif
+
+    return &chunk->callback_jump[ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE];
+}
+
+#ifdef ZYREX_HOOK_THREAD_MASK
+
+/**
+ * @brief   Writes the thread mask check of the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * The check reads the thread mask of the current thread from its TLS slot and redirects the
+ * call straight to the `code_buffer`, if the thread disabled all hooks or the hook of this
+ * chunk. If the thread mask system is not initialized, the check is skipped by a short jump.
+ *
+ * On 64-bit targets, the check uses `r11` which is neither preserved nor used to pass arguments
+ * by any of the supported calling conventions. On 32-bit targets, `eax` is preserved on the
+ * stack and restored by the epilogue at the end of the callback stub.
+ */
+static void ZyrexTrampolineChunkWriteThreadMaskCheck(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(chunk);
+    ZyanU8* const buffer = writable->callback_jump;
+    ZyanU8* instr = buffer;
+
+    ZYAN_MEMSET(buffer, 0xCC, ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE);
+
+    ZyanU32 slot_offset;
+    if (!ZYAN_SUCCESS(ZyrexThreadMaskGetSlotOffset(&slot_offset)))
+    {
+        // jmp short enabled
+        *instr++ = 0xEB;
+        *instr++ = ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE - 2;
+        return;
+    }
+
+    const ZyanU32 index = ZyrexTrampolineGetChunkInfo(chunk)->index;
+    const ZyanU32 word_offset =
+        (ZyanU32)(offsetof(ZyrexThreadMask, disabled_hooks) + (index / 32) * sizeof(ZyanU32));
+    const ZyanU8 bypass = (ZyanU8)(ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE -
+        ZYREX_TRAMPOLINE_THREAD_MASK_EPILOGUE_SIZE);
+    ZyanU8* bit_test;
+    ZyanU8* enabled;
+
+#if defined(ZYAN_X64)
+
+    // mov r11, qword ptr seg:[slot_offset]
+    *instr++ = ZYREX_THREAD_MASK_SEGMENT_PREFIX;
+    *instr++ = 0x4C;
+    *instr++ = 0x8B;
+    *instr++ = 0x1C;
+    *instr++ = 0x25;
+    ZYAN_MEMCPY(instr, &slot_offset, sizeof(slot_offset));
+    instr += sizeof(slot_offset);
+    // test r11, r11
+    *instr++ = 0x4D;
+    *instr++ = 0x85;
+    *instr++ = 0xDB;
+    // jz enabled
+    *instr++ = 0x74;
+    *instr   = (ZyanU8)(ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE - 1 - (instr + 1 - buffer));
+    ++instr;
+    // cmp dword ptr [r11], 0
+    *instr++ = 0x41;
+    *instr++ = 0x83;
+    *instr++ = 0x3B;
+    *instr++ = 0x00;
+    // jnz bypass
+    *instr++ = 0x75;
+    *instr   = (ZyanU8)(bypass - (instr + 1 - buffer));
+    ++instr;
+    // bt dword ptr [r11 + word_offset], index % 32
+    bit_test = instr;
+    *instr++ = 0x41;
+    *instr++ = 0x0F;
+    *instr++ = 0xBA;
+    *instr++ = 0xA3;
+    ZYAN_MEMCPY(instr, &word_offset, sizeof(word_offset));
+    instr += sizeof(word_offset);
+    *instr++ = (ZyanU8)(index % 32);
+    // jc bypass
+    *instr++ = 0x72;
+    *instr   = (ZyanU8)(bypass - (instr + 1 - buffer));
+    ++instr;
+    // enabled: nop
+    enabled = instr;
+    *instr++ = 0x90;
+
+#else
+
+    // push eax
+    *instr++ = 0x50;
+    // mov eax, dword ptr seg:[slot_offset]
+    *instr++ = ZYREX_THREAD_MASK_SEGMENT_PREFIX;
+    *instr++ = 0xA1;
+    ZYAN_MEMCPY(instr, &slot_offset, sizeof(slot_offset));
+    instr += sizeof(slot_offset);
+    // test eax, eax
+    *instr++ = 0x85;
+    *instr++ = 0xC0;
+    // jz enabled
+    *instr++ = 0x74;
+    *instr   = (ZyanU8)(ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE - 6 - (instr + 1 - buffer));
+    ++instr;
+    // cmp dword ptr [eax], 0
+    *instr++ = 0x83;
+    *instr++ = 0x38;
+    *instr++ = 0x00;
+    // jnz bypass
+    *instr++ = 0x75;
+    *instr   = (ZyanU8)(bypass - (instr + 1 - buffer));
+    ++instr;
+    // bt dword ptr [eax + word_offset], index % 32
+    bit_test = instr;
+    *instr++ = 0x0F;
+    *instr++ = 0xBA;
+    *instr++ = 0xA0;
+    ZYAN_MEMCPY(instr, &word_offset, sizeof(word_offset));
+    instr += sizeof(word_offset);
+    *instr++ = (ZyanU8)(index % 32);
+    // jc bypass
+    *instr++ = 0x72;
+    *instr   = (ZyanU8)(bypass - (instr + 1 - buffer));
+    ++instr;
+    // enabled: pop eax
+    enabled = instr;
+    *instr++ = 0x58;
+    // nop dword ptr [eax + eax + 0]
+    *instr++ = 0x0F;
+    *instr++ = 0x1F;
+    *instr++ = 0x44;
+    *instr++ = 0x00;
+    *instr++ = 0x00;
+    // bypass: pop eax
+    buffer[bypass] = 0x58;
+
+#endif
+
+    ZYAN_ASSERT(instr - buffer == ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE);
+
+    if (index >= ZYREX_THREAD_MASK_MAX_ENTRIES)
+    {
+        // The hook can not be disabled individually. jmp short enabled
+        const ZyanUSize size = (ZyanUSize)(enabled - bit_test);
+        ZYAN_MEMSET(bit_test, 0xCC, size);
+        bit_test[0] = 0xEB;
+        bit_test[1] = (ZyanU8)(size - 2);
+    }
+}
+
+#endif
+
+/**
+ * @brief   Writes the callback stub of the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * The stub ends with a jump to the `callback_address` of the chunk. If
+ * `ZYREX_HOOK_STATISTICS` is defined and the chunk is instrumented, the stub atomically
+ * increments the call counter shard of the current processor before. The processor number is
+ * read from the `IA32_TSC_AUX` register by `rdtscp`. If `ZYREX_HOOK_THREAD_MASK` is defined, the
+ * stub starts with the thread mask check. Registers are preserved, but the flags are modified,
+ * which is fine at a function entry.
+ */
+static void ZyrexTrampolineChunkWriteCallbackStub(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(chunk);
+    ZyanU8* instr = writable->callback_jump;
+
+#ifdef ZYREX_HOOK_THREAD_MASK
+    ZyrexTrampolineChunkWriteThreadMaskCheck(chunk);
+    instr += ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE;
+#endif
+
+#ifdef ZYREX_HOOK_STATISTICS
+
+    const ZyanU32 index = ZyrexTrampolineGetChunkInfo(chunk)->index;
+    ZyrexStatisticsCounter* const counters = ZyrexStatisticsGetCounters(index);
+    ZyrexStatisticsResetEntry(index);
+    if (counters)
+    {
+        ZyanU8* const begin = instr;
+        const ZyanUPointer counter = (ZyanUPointer)&counters->value;
+
+#   if defined(ZYAN_X64)
+
+        // push rax
+        *instr++ = 0x50;
+        // push rcx
+        *instr++ = 0x51;
+        // push rdx
+        *instr++ = 0x52;
+        if (ZyrexStatisticsIsProcessorIdSupported())
+        {
+            // rdtscp
+            *instr++ = 0x0F;
+            *instr++ = 0x01;
+            *instr++ = 0xF9;
+        } else
+        {
+            // xor ecx, ecx
+            *instr++ = 0x31;
+            *instr++ = 0xC9;
+            // nop
+            *instr++ = 0x90;
+        }
+        // and ecx, ZYREX_HOOK_STATISTICS_COUNTER_SHARDS - 1
+        *instr++ = 0x83;
+        *instr++ = 0xE1;
+        *instr++ = ZYREX_HOOK_STATISTICS_COUNTER_SHARDS - 1;
+        // shl ecx, ZYREX_HOOK_STATISTICS_COUNTER_SHIFT
+        *instr++ = 0xC1;
+        *instr++ = 0xE1;
+        *instr++ = ZYREX_HOOK_STATISTICS_COUNTER_SHIFT;
+        // mov rax, imm64
+        *instr++ = 0x48;
+        *instr++ = 0xB8;
+        ZYAN_MEMCPY(instr, &counter, sizeof(counter));
+        instr += sizeof(counter);
+        // lock inc qword ptr [rax + rcx]
+        *instr++ = 0xF0;
+        *instr++ = 0x48;
+        *instr++ = 0xFF;
+        *instr++ = 0x04;
+        *instr++ = 0x08;
+        // pop rdx
+        *instr++ = 0x5A;
+        // pop rcx
+        *instr++ = 0x59;
+        // pop rax
+        *instr++ = 0x58;
+
+#   else
+
+        // push eax
+        *instr++ = 0x50;
+        // push ecx
+        *instr++ = 0x51;
+        // push edx
+        *instr++ = 0x52;
+        if (ZyrexStatisticsIsProcessorIdSupported())
+        {
+            // rdtscp
+            *instr++ = 0x0F;
+            *instr++ = 0x01;
+            *instr++ = 0xF9;
+        } else
+        {
+            // xor ecx, ecx
+            *instr++ = 0x31;
+            *instr++ = 0xC9;
+            // nop
+            *instr++ = 0x90;
+        }
+        // and ecx, ZYREX_HOOK_STATISTICS_COUNTER_SHARDS - 1
+        *instr++ = 0x83;
+        *instr++ = 0xE1;
+        *instr++ = ZYREX_HOOK_STATISTICS_COUNTER_SHARDS - 1;
+        // shl ecx, ZYREX_HOOK_STATISTICS_COUNTER_SHIFT
+        *instr++ = 0xC1;
+        *instr++ = 0xE1;
+        *instr++ = ZYREX_HOOK_STATISTICS_COUNTER_SHIFT;
+        // lock add dword ptr [ecx + counter], 1
+        *instr++ = 0xF0;
+        *instr++ = 0x83;
+        *instr++ = 0x81;
+        ZYAN_MEMCPY(instr, &counter, sizeof(counter));
+        instr += sizeof(counter);
+        *instr++ = 0x01;
+        // lock adc dword ptr [ecx + counter + 4], 0
+        const ZyanUPointer counter_hi = counter + 4;
+        *instr++ = 0xF0;
+        *instr++ = 0x83;
+        *instr++ = 0x91;
+        ZYAN_MEMCPY(instr, &counter_hi, sizeof(counter_hi));
+        instr += sizeof(counter_hi);
+        *instr++ = 0x00;
+        // pop edx
+        *instr++ = 0x5A;
+        // pop ecx
+        *instr++ = 0x59;
+        // pop eax
+        *instr++ = 0x58;
+
+#   endif
+
+        // nop
+        while (instr - begin < ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE)
+        {
+            *instr++ = 0x90;
+        }
+
+        ZYAN_ASSERT(instr - writable->callback_jump ==
+            ZYREX_TRAMPOLINE_THREAD_MASK_CHECK_SIZE + ZYREX_TRAMPOLINE_CALL_COUNTER_SIZE);
+    }
+
+#endif
+
+    ZyanU8* const jump = ZyrexTrampolineChunkGetCallbackJump(chunk);
+    ZYAN_ASSERT(instr == ZyrexTrampolineGetWritableAddress(jump));
+    ZyrexTrampolineEncodeJump(instr, (ZyanUPointer)jump, chunk->callback_address,
+        (ZyanUPointer)&chunk->callback_address);
+}
+
+/**
+ * @brief   Initializes a new trampoline chunk and relocates the instructions from the original
+ *          function.
+ *
+ * @param   chunk       A pointer to the `ZyrexTrampolineChunk` struct.
+ * @param   address     The address of the original function.
+ * @param   analysis    A pointer to the analysis result of the original function code or
+ *                      `ZYAN_NULL`, if `entry` is passed.
+ * @param   entry       A pointer to a relocation cache entry of the original function or
+ *                      `ZYAN_NULL`, if `analysis` is passed.
+ * @param   callback    The address of the callback function the hook will redirect to.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineChunkInit(ZyrexTrampolineChunk* chunk, const void* address,
+    const ZyrexCodeAnalysis* analysis, const ZyrexRelocationCacheEntry* entry,
+    const void* callback)
+{
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(analysis || entry);
+    ZYAN_ASSERT(callback);
+
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(chunk);
+    ZyrexTrampolineChunkInfo* const info = ZyrexTrampolineGetChunkInfo(chunk);
+    info->is_used = ZYAN_TRUE;
+    info->is_hot_patch = ZYAN_FALSE;
+    writable->callback_address = (ZyanUPointer)callback;
+
+    ZyanUSize bytes_read;
+    ZyanUSize bytes_written;
+
+    // Relocate instructions or rebase the previously relocated instructions from the cache
+    ZyrexRelocationFixups fixups;
+    if (entry)
+    {
+        ZYAN_CHECK(ZyrexRelocationCacheApply(entry, address, chunk, &bytes_read,
+            &bytes_written));
+    } else
+    {
+        ZYAN_CHECK(ZyrexRelocateCode(analysis, chunk, &fixups, &bytes_read, &bytes_written));
+    }
+
+    ZYAN_ASSERT(bytes_read <= ZYAN_ARRAY_LENGTH(info->original_code));
+    ZYAN_ASSERT(bytes_written <= ZYAN_ARRAY_LENGTH(writable->code_buffer));
+
+    // Write backjump
+    info->code_buffer_size = (ZyanU8)bytes_written;
+    writable->backjump_address = (ZyanUPointer)address + bytes_read;
+    ZyrexTrampolineEncodeJump(&writable->code_buffer[bytes_written],
+        (ZyanUPointer)&chunk->code_buffer[bytes_written], chunk->backjump_address,
+        (ZyanUPointer)&chunk->backjump_address);
+
+    // Fill remaining space with `INT 3` instructions
+    const ZyanUSize bytes_remaining = sizeof(writable->code_buffer) - bytes_written;
+    if (bytes_remaining > 0)
+    {
+        ZYAN_MEMSET(&writable->code_buffer[bytes_written + ZYREX_SIZEOF_ABSOLUTE_JUMP], 0xCC,
+            bytes_remaining - ZYREX_SIZEOF_ABSOLUTE_JUMP);
+    }
+    ZYAN_MEMSET(writable->padding, 0xCC, sizeof(writable->padding));
+
+    // The instruction cache is flushed by `ZyrexTrampolineProtectRegions`
+
+    // Backup original instructions 
+    info->original_code_size = (ZyanU8)bytes_read;
+    ZYAN_MEMCPY(info->original_code, address, bytes_read);
+
+    if (!entry)
+    {
+        // Failing to update the cache does not affect the trampoline
+        ZYAN_UNUSED(ZyrexRelocationCacheInsert(analysis, chunk, &fixups));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Initializes a new trampoline chunk for a hot-patchable function.
+ *
+ * @param   chunk       A pointer to the `ZyrexTrampolineChunk` struct.
+ * @param   address     The address of the hot-patchable function.
+ * @param   callback    The address of the callback function the hook will redirect to.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineChunkInitHotPatch(ZyrexTrampolineChunk* chunk,
+    const void* address, const void* callback)
+{
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(callback);
+
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(chunk);
+    ZyrexTrampolineChunkInfo* const info = ZyrexTrampolineGetChunkInfo(chunk);
+    info->is_used = ZYAN_TRUE;
+    info->is_hot_patch = ZYAN_TRUE;
+    writable->callback_address = (ZyanUPointer)callback;
+
+    // The `mov edi, edi` prologue does not have any side effects and is skipped by the backjump
+    info->code_buffer_size = 0;
+    writable->backjump_address = (ZyanUPointer)address + ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE;
+    ZyrexTrampolineEncodeJump(&writable->code_buffer[0], (ZyanUPointer)&chunk->code_buffer[0],
+        chunk->backjump_address, (ZyanUPointer)&chunk->backjump_address);
+    info->translation_map.count = 0;
+
+    // Fill remaining space with `INT 3` instructions
+    ZYAN_MEMSET(&writable->code_buffer[ZYREX_SIZEOF_ABSOLUTE_JUMP], 0xCC,
+        sizeof(writable->code_buffer) - ZYREX_SIZEOF_ABSOLUTE_JUMP);
+    ZYAN_MEMSET(writable->padding, 0xCC, sizeof(writable->padding));
+
+    // Backup original instructions and padding
+    info->original_code_size = ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE;
+    ZYAN_MEMCPY(info->original_code, address, ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE);
+    ZYAN_MEMCPY(info->hot_patch_padding,
+        (const ZyanU8*)address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE,
+        ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Allocates and initializes a new trampoline chunk in a trampoline-region that
+ *          satisfies the given address range.
+ *
+ * @param   address_lo  The lower bound of the address range.
+ * @param   address_hi  The upper bound of the address range.
+ * @param   address     The address of the function to create the trampoline for.
+ * @param   callback    The address of the callback function the hook will redirect to.
+ * @param   analysis    A pointer to the analysis result of the original function code or
+ *                      `ZYAN_NULL`.
+ * @param   entry       A pointer to a relocation cache entry of the original function or
+ *                      `ZYAN_NULL`.
+ * @param   trampoline  Receives the newly created trampoline chunk.
+ *
+ * @return  A zyan status code.
+ *
+ * A hot-patch trampoline is created, if neither `analysis` nor `entry` is passed.
+ */
+static ZyanStatus ZyrexTrampolineChunkCreate(ZyanUPointer address_lo, ZyanUPointer address_hi,
+    const void* address, const void* callback, const ZyrexCodeAnalysis* analysis,
+    const ZyrexRelocationCacheEntry* entry, ZyrexTrampolineChunk** trampoline)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(callback);
+    ZYAN_ASSERT(trampoline);
+
+    ZyanBool is_new_region = ZYAN_FALSE;
+    ZyrexTrampolineRegion* region;
+    ZyrexTrampolineChunk* chunk;
+    ZyanStatus status = ZyrexTrampolineRegionFindChunk(address_lo, address_hi, &region, &chunk);
+    ZYAN_CHECK(status);
+
+    switch (status)
+    {
+    case ZYAN_STATUS_TRUE:
+    {
+        ZYAN_ASSERT(region);
+        ZYAN_ASSERT(chunk);
+        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
+        break;
+    }
+    case ZYAN_STATUS_FALSE:
+    {
+        ZYAN_CHECK(ZyrexTrampolineRegionAllocate(address_lo, address_hi, &region));
+        is_new_region =
+            ZyrexTrampolineRegionFindChunkInRegion(region, address_lo, address_hi, &chunk);
+        ZYAN_ASSERT(is_new_region);
+        ZYAN_ASSERT(region);
+        ZYAN_ASSERT(chunk);
+        break;
+    }
+    default:
+        ZYAN_UNREACHABLE;
+    }
+
+    ZYAN_ASSERT(region->header.number_of_unused_chunks > 0);
+
+    status = ZyrexTrampolineRegionCommitChunk(region, (ZyanUSize)(chunk - region->chunks));
+    if (ZYAN_SUCCESS(status))
+    {
+        if (analysis || entry)
+        {
+            status = ZyrexTrampolineChunkInit(chunk, address, analysis, entry, callback);
+        } else
+        {
+            status = ZyrexTrampolineChunkInitHotPatch(chunk, address, callback);
+        }
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTrampolineIndexAcquire(chunk);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        // The stub depends on the dense index of the chunk
+        ZyrexTrampolineChunkWriteCallbackStub(chunk);
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        if (is_new_region)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
+        } else
+        {
+            region->header.chunk_info[chunk - region->chunks].is_used = ZYAN_FALSE;
+            ZYAN_UNUSED(ZyrexTrampolineRegionDecommitChunk(region,
+                (ZyanUSize)(chunk - region->chunks)));
+        }
+        return status;
+    }
+
+    --ZyrexTrampolineRegionGetWritable(region)->header.number_of_unused_chunks;
+    ZyrexTrampolineRegionMarkChunk(region, (ZyanUSize)(chunk - region->chunks), ZYAN_TRUE);
+
+    if (is_new_region)
+    {
+        ZYAN_UNUSED(ZyrexTrampolineRegionInsert(region));
+    }
+
+    *trampoline = chunk;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Public functions                                                                               */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Creation and destruction                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
+    ZyanUSize min_bytes_to_reloc, ZyrexTrampolineChunk** trampoline)
+{
+    if (!address || !callback || (min_bytes_to_reloc < 1) || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Check if the memory region of the target function has enough space for the hook code
+    ZyanUSize source_size = ZYREX_TRAMPOLINE_MAX_CODE_SIZE;
+#ifdef ZYAN_WINDOWS
+    ZYAN_CHECK(ZyrexGetSizeOfReadableMemoryRegion(address, &source_size));
+    if (source_size < min_bytes_to_reloc)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+#endif
+
+    ZYAN_CHECK(ZyrexTrampolineInitialize());
+
+    // Reuse the relocated instructions from the relocation cache, if available
+    ZyrexRelocationCacheEntry entry;
+    const ZyanStatus status =
+        ZyrexRelocationCacheLookup(address, source_size, min_bytes_to_reloc, &entry);
+    ZYAN_CHECK(status);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+#ifdef ZYAN_X64
+        ZyanUPointer entry_lo;
+        ZyanUPointer entry_hi;
+        ZyrexRelocationCacheGetTargetRange(&entry, address, &entry_lo, &entry_hi);
+        const ZyanBool is_in_range = ((entry_hi - entry_lo) <= ZYREX_RANGEOF_RELATIVE_JUMP);
+#else
+        const ZyanUPointer entry_lo = (ZyanUPointer)address;
+        const ZyanUPointer entry_hi = (ZyanUPointer)address;
+        const ZyanBool is_in_range = ZYAN_TRUE;
+#endif
+
+        if (is_in_range)
+        {
+            const ZyanStatus create_status = ZyrexTrampolineChunkCreate(entry_lo, entry_hi,
+                address, callback, ZYAN_NULL, &entry, trampoline);
+            if (create_status != ZYAN_STATUS_OUT_OF_RANGE)
+            {
+                return create_status;
+            }
+        }
+
+        // Fall back to the regular relocation
+    }
+
+    // Decode the instructions once. The analysis result is used to find a suitable memory region
+    // for the trampoline and to relocate the instructions afterwards
+    ZyrexCodeAnalysis analysis;
+    ZYAN_CHECK(ZyrexAnalyzeCode(address, source_size, min_bytes_to_reloc, &analysis));
+
+#ifdef ZYAN_X64
+
+    // Gather memory address lower and upper bounds in order to find a suitable memory region for
+    // the trampoline
+    ZyanUPointer lo = analysis.address_lo;
+    ZyanUPointer hi = analysis.address_hi;
 
     const ZyanUPointer address_value = (ZyanUPointer)address;
     if (address_value < lo)
@@ -814,64 +2948,73 @@ ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
 
 #endif
 
-    ZyanBool is_new_region = ZYAN_FALSE;
-    ZyrexTrampolineRegion* region;
-    ZyrexTrampolineChunk* chunk;
-    ZyanStatus status = ZyrexTrampolineRegionFindChunk(lo, hi, &region, &chunk);
-    ZYAN_CHECK(status);
+    return ZyrexTrampolineChunkCreate(lo, hi, address, callback, &analysis, ZYAN_NULL,
+        trampoline);
+}
 
-    switch (status)
-    {
-    case ZYAN_STATUS_TRUE:
+ZyanStatus ZyrexTrampolineCreateHotPatch(const void* address, const void* callback,
+    ZyrexTrampolineChunk** trampoline)
+{
+    if (!address || !callback || !trampoline)
     {
-        ZYAN_ASSERT(region);
-        ZYAN_ASSERT(chunk);
-        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
-        break;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    case ZYAN_STATUS_FALSE:
+
+    const ZyanStatus status = ZyrexTrampolineIsHotPatchable(address);
+    ZYAN_CHECK(status);
+    if (status != ZYAN_STATUS_TRUE)
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionAllocate(lo, hi, &region));
-        is_new_region = ZyrexTrampolineRegionFindChunkInRegion(region, lo, hi, &chunk);
-        ZYAN_ASSERT(is_new_region);
-        ZYAN_ASSERT(region);
-        ZYAN_ASSERT(chunk);
-        break;
-    }
-    default:
-        ZYAN_UNREACHABLE;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZYAN_ASSERT(region->header.number_of_unused_chunks > 0);
+    ZYAN_CHECK(ZyrexTrampolineInitialize());
 
-    status = ZyrexTrampolineChunkInit(chunk, address, callback, min_bytes_to_reloc, source_size);
-    if (!ZYAN_SUCCESS(status))
+    // The relative jump in the padding has to reach the trampoline
+    const ZyanUPointer lo = (ZyanUPointer)address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE;
+    const ZyanUPointer hi = (ZyanUPointer)address;
+
+    return ZyrexTrampolineChunkCreate(lo, hi, address, callback, ZYAN_NULL, ZYAN_NULL,
+        trampoline);
+}
+
+ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline)
+{
+    if (!trampoline)
     {
-        if (is_new_region)
-        {
-            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
-        } else
-        {
-            ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region));
-        }
-        return status;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    --region->header.number_of_unused_chunks;
-    ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region));
-
-    if (is_new_region)
+    ZyrexTrampolineRegion* region;
+    ZyrexTrampolineChunk* chunk;
+    if (!ZyrexTrampolineChunkFromAddress((ZyanUPointer)trampoline, &region, &chunk))
     {
-        ZYAN_UNUSED(ZyrexTrampolineRegionInsert(region));
+        return ZYAN_STATUS_NOT_FOUND;
     }
+    ZYAN_ASSERT(chunk == trampoline);
+
+    // Empty regions are kept, as lookups from other threads might still read the region-header.
+    // Only the memory of the chunk itself is decommitted
+    ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
+    ++ZyrexTrampolineRegionGetWritable(region)->header.number_of_unused_chunks;
+    ZyrexTrampolineRegionMarkChunk(region, (ZyanUSize)(trampoline - region->chunks), ZYAN_FALSE);
+    region->header.chunk_info[trampoline - region->chunks].is_used = ZYAN_FALSE;
+
+    // The chunk has to be invisible to lookups, before the index is released
+    ZYAN_CHECK(ZyrexTrampolineIndexRelease(trampoline));
+
+    ZYAN_CHECK(ZyrexTrampolineRegionDecommitChunk(region,
+        (ZyanUSize)(trampoline - region->chunks)));
 
-    *trampoline = chunk;
     return ZYAN_STATUS_SUCCESS;
 }
 
-ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline)
+ZyanStatus ZyrexTrampolineSetCallback(ZyrexTrampolineChunk* trampoline, const void* callback)
 {
-    if (!trampoline)
+    if (!trampoline || !callback)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
@@ -880,44 +3023,151 @@ ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline)
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)trampoline, 
-        g_trampoline_data.region_size);
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
-
-    if (status == ZYAN_STATUS_FALSE)
+    ZyrexTrampolineRegion* region;
+    ZyrexTrampolineChunk* chunk;
+    if (!ZyrexTrampolineChunkFromAddress((ZyanUPointer)trampoline, &region, &chunk))
     {
         return ZYAN_STATUS_NOT_FOUND;
     }
+    ZYAN_ASSERT(chunk == trampoline);
+
+    ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
+
+    // Both views share the same physical memory
+    ZyrexTrampolineChunk* const writable = ZyrexTrampolineGetWritableAddress(trampoline);
+#if defined(ZYAN_MSVC)
+    InterlockedExchangePointer((volatile PVOID*)&writable->callback_address, (PVOID)callback);
+#else
+    __atomic_store_n(&writable->callback_address, (ZyanUPointer)callback, __ATOMIC_SEQ_CST);
+#endif
+
+    // The jump at the end of the callback stub either reads the new `callback_address` or is
+    // exchanged atomically after the address has been published
+    ZyanU8* const jump = ZyrexTrampolineChunkGetCallbackJump(trampoline);
+    ZyanU8 buffer[ZYREX_SIZEOF_ABSOLUTE_JUMP];
+    ZyrexTrampolineEncodeJump(buffer, (ZyanUPointer)jump, (ZyanUPointer)callback,
+        (ZyanUPointer)&trampoline->callback_address);
+    ZyrexWriteAtomic64(ZyrexTrampolineGetWritableAddress(jump), buffer, sizeof(buffer));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineReserveRegions(const void* address, ZyanUSize count)
+{
+    if (!address || !count)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)region_address;
-    if (region->header.number_of_unused_chunks == g_trampoline_data.chunks_per_region - 1 - 1)
+    ZYAN_CHECK(ZyrexTrampolineInitialize());
+
+    for (ZyanUSize i = 0; i < count; ++i)
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionRemove(region));
-        ZYAN_CHECK(ZyrexTrampolineRegionFree(region));
+        ZyrexTrampolineRegion* region;
+        ZYAN_CHECK(ZyrexTrampolineRegionAllocate((ZyanUPointer)address, (ZyanUPointer)address,
+            &region));
+
+        const ZyanStatus status = ZyrexTrampolineRegionInsert(region);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
+            return status;
+        }
     }
-    else
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineReserveChunks(const void* address_lo, const void* address_hi,
+    ZyanUSize count)
+{
+    if (!address_lo || !address_hi || (address_lo > address_hi))
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
-        ++region->header.number_of_unused_chunks;
-        trampoline->is_used = ZYAN_FALSE;
-        ZYAN_CHECK(ZyrexTrampolineRegionProtect(region));
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    ZyanUSize size;
-    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
-    if (size == 0)
+    ZYAN_CHECK(ZyrexTrampolineInitialize());
+
+    const ZyanUPointer lo = (ZyanUPointer)address_lo;
+    const ZyanUPointer hi = (ZyanUPointer)address_hi;
+
+    // Count the unused chunks in range of the already allocated regions
+    ZyanUSize available = 0;
+    for (ZyanUSize i = 0; (i < g_trampoline_data.regions.size) && (available < count); ++i)
+    {
+        ZyrexTrampolineRegion* const* const element =
+            ZyanVectorGet(&g_trampoline_data.regions, i);
+        ZYAN_ASSERT(element);
+
+        available += ZyrexTrampolineRegionCountChunksInRegion(*element, lo, hi);
+    }
+
+    // Allocate the missing regions at once
+    while (available < count)
     {
-        ZYAN_CHECK(ZyanVectorDestroy(&g_trampoline_data.regions));
-        g_trampoline_data.is_initialized = ZYAN_FALSE;
+        ZyrexTrampolineRegion* region;
+        ZYAN_CHECK(ZyrexTrampolineRegionAllocate(lo, hi, &region));
+
+        const ZyanStatus status = ZyrexTrampolineRegionInsert(region);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
+            return status;
+        }
+
+        const ZyanUSize chunks = ZyrexTrampolineRegionCountChunksInRegion(region, lo, hi);
+        if (chunks == 0)
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        available += chunks;
     }
 
     return ZYAN_STATUS_SUCCESS;
 }
 
+ZyanStatus ZyrexTrampolineProtectRegions(void)
+{
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanStatus result = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < g_trampoline_data.dirty_regions.size; ++i)
+    {
+        ZyrexTrampolineRegion* const* const item =
+            ZyanVectorGet(&g_trampoline_data.dirty_regions, i);
+        ZYAN_ASSERT(item);
+
+        ZyrexTrampolineRegion* const region = *item;
+        ZYAN_ASSERT(region->header.is_writable);
+
+        // The header is no longer writable after changing the protection
+        ZyrexTrampolineRegionGetWritable(region)->header.is_writable = ZYAN_FALSE;
+
+        ZyanUSize size = 0;
+        for (ZyanU32 pages = region->header.committed_pages; pages; pages >>= 1)
+        {
+            size += g_trampoline_data.page_size;
+        }
+
+        ZyanStatus status = ZyrexTrampolineRegionProtect(region);
+        if (ZYAN_SUCCESS(status))
+        {
+            status = ZyanProcessFlushInstructionCache(region, size);
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            result = status;
+        }
+    }
+
+    ZYAN_CHECK(ZyanVectorClear(&g_trampoline_data.dirty_regions));
+
+    return result;
+}
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Searching                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
@@ -933,45 +3183,210 @@ ZyanStatus ZyrexTrampolineFind(const void* original, ZyrexTrampolineChunk** tram
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)original, 
-        g_trampoline_data.region_size);
+    ZyrexTrampolineRegion* region;
+    if (!ZyrexTrampolineChunkFromCode(original, &region, trampoline))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
 
-    ZyanUSize found_index;
-    const ZyanStatus status = 
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
-    
-    if (status == ZYAN_STATUS_FALSE)
+    return ZYAN_STATUS_TRUE;
+}
+
+ZyanStatus ZyrexTrampolineGetIndex(const void* trampoline, ZyanU32* index,
+    ZyanU32* generation)
+{
+    if (!trampoline || !index)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexTrampolineRegion* region;
+    ZyrexTrampolineChunk* chunk;
+    if (!ZyrexTrampolineChunkFromCode(trampoline, &region, &chunk))
     {
         return ZYAN_STATUS_FALSE;
     }
 
-    ZyrexTrampolineRegion** const element = 
-        ZyanVectorGetMutable(&g_trampoline_data.regions, found_index);
-    ZYAN_ASSERT(element && *element);
+    const ZyrexTrampolineChunkInfo* const info = &region->header.chunk_info[chunk - region->chunks];
+    *index = info->index;
+    if (generation)
+    {
+        *generation = info->generation;
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Information                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyrexTrampolineChunkInfo* ZyrexTrampolineGetChunkInfo(const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    const ZyanUPointer region_address =
+        (ZyanUPointer)trampoline & ~((ZyanUPointer)g_trampoline_data.region_size - 1);
+    const ZyrexTrampolineRegion* const region = (const ZyrexTrampolineRegion*)region_address;
+    ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
+
+    const ZyanUSize index = (ZyanUSize)(trampoline - region->chunks);
+    ZYAN_ASSERT((index >= ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS) &&
+        (index < g_trampoline_data.chunks_per_region));
+
+    return &region->header.chunk_info[index];
+}
+
+void* ZyrexTrampolineGetWritableAddress(const void* address)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-    ZyrexTrampolineRegion* const region = *element;
+    const ZyanUPointer region_address =
+        (ZyanUPointer)address & ~((ZyanUPointer)g_trampoline_data.region_size - 1);
+    const ZyrexTrampolineRegion* const region = (const ZyrexTrampolineRegion*)region_address;
     ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
 
-    for (ZyanUSize i = 1; i < g_trampoline_data.chunks_per_region; ++i)
+    return (void*)((ZyanUPointer)address + region->header.writable_offset);
+}
+
+ZyanStatus ZyrexTrampolineGetMemoryInfo(ZyanUSize* reserved_bytes, ZyanUSize* committed_bytes,
+    ZyanUSize* number_of_trampolines)
+{
+    if (!reserved_bytes || !committed_bytes || !number_of_trampolines)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    *reserved_bytes = g_trampoline_data.reserved_bytes;
+    *committed_bytes = g_trampoline_data.committed_bytes;
+    *number_of_trampolines = 0;
+
+    if (g_trampoline_data.is_initialized)
     {
-        ZyrexTrampolineChunk* const chunk = &region->chunks[i];
-        ZYAN_ASSERT(chunk);
+        *number_of_trampolines =
+            g_trampoline_data.chunks.size - g_trampoline_data.free_indices.size;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanUSize ZyrexTrampolineGetRegionAllocationCount(void)
+{
+    return g_trampoline_data.region_allocations;
+}
+
+ZyanStatus ZyrexTrampolineQueryStatistics(ZyrexHookStatistics* statistics, ZyanUSize capacity,
+    ZyanUSize* count)
+{
+    if ((!statistics && capacity) || !count)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+#ifdef ZYREX_HOOK_STATISTICS
+
+    *count = 0;
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
 
-        if (!chunk->is_used)
+    for (ZyanUSize i = 0; i < g_trampoline_data.regions.size; ++i)
+    {
+        const ZyrexTrampolineRegion* const* const element =
+            ZyanVectorGet(&g_trampoline_data.regions, i);
+        ZYAN_ASSERT(element);
+        const ZyrexTrampolineRegion* const region = *element;
+
+        // The leading chunks share memory with the region-header
+        for (ZyanUSize j = ZYREX_TRAMPOLINE_REGION_HEADER_CHUNKS;
+            j < g_trampoline_data.chunks_per_region; ++j)
         {
-            continue;
+            if (region->header.unused_chunks[j / 32] & ((ZyanU32)1 << (j % 32)))
+            {
+                continue;
+            }
+
+            if (*count < capacity)
+            {
+                const ZyrexTrampolineChunk* const chunk = &region->chunks[j];
+                const ZyrexTrampolineChunkInfo* const info = &region->header.chunk_info[j];
+                ZyrexHookStatistics* const item = &statistics[*count];
+                ZYAN_MEMSET(item, 0, sizeof(*item));
+                item->address =
+                    (const void*)(chunk->backjump_address - info->original_code_size);
+                item->trampoline = &chunk->code_buffer;
+
+                const ZyrexStatisticsEntry* const entry = ZyrexStatisticsGetEntry(info->index);
+                if (entry)
+                {
+                    item->call_count = ZyrexStatisticsGetCallCount(info->index);
+                    for (ZyanUSize k = 0; k < ZYREX_HOOK_STATISTICS_HISTOGRAM_SIZE; ++k)
+                    {
+                        item->latency_histogram[k] = entry->latency_histogram[k];
+                    }
+                }
+            }
+            ++*count;
         }
+    }
+
+    return (*count <= capacity) ? ZYAN_STATUS_SUCCESS : ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+
+#else
+
+    ZYAN_UNUSED(statistics);
+    ZYAN_UNUSED(capacity);
+
+    *count = 0;
+    return ZYAN_STATUS_INVALID_OPERATION;
+
+#endif
+}
+
+ZyanStatus ZyrexTrampolineIsHotPatchable(const void* address)
+{
+    if (!address)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // The prologue has to be aligned in order to be replaced by a single atomic write
+    if ((ZyanUPointer)address & (ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE - 1))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyanU8* const padding = (const ZyanU8*)address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE;
+
+#ifdef ZYAN_WINDOWS
+    ZyanUSize size =
+        ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE + ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE;
+    ZYAN_CHECK(ZyrexGetSizeOfReadableMemoryRegion(padding, &size));
+    if (size < ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE + ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+#endif
+
+    // mov edi, edi
+    const ZyanU8* const prologue = (const ZyanU8*)address;
+    if ((prologue[0] != 0x8B) || (prologue[1] != 0xFF))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
 
-        if ((ZyanUPointer)&chunk->code_buffer == (ZyanUPointer)original)
+    for (ZyanUSize i = 0; i < ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE; ++i)
+    {
+        if ((padding[i] != 0xCC) && (padding[i] != 0x90))
         {
-            *trampoline = chunk;
-            return ZYAN_STATUS_TRUE;
+            return ZYAN_STATUS_FALSE;
         }
     }
 
-    return ZYAN_STATUS_FALSE;
+    return ZYAN_STATUS_TRUE;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
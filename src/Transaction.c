@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <Zycore/Comparison.h>
 #include <Zycore/LibC.h>
 #include <Zycore/Vector.h>
 #include <Zycore/Zycore.h>
@@ -33,12 +34,51 @@
 #include <Zycore/API/Memory.h>
 #include <Zycore/API/Process.h>
 #include <Zyrex/Transaction.h>
+#include <Zyrex/Internal/ImportTable.h>
 #include <Zyrex/Internal/InlineHook.h>
 #include <Zyrex/Internal/Trampoline.h>
+#include <Zyrex/Internal/Transaction.h>
 
 #ifdef ZYAN_WINDOWS
 #   include <Windows.h>
 #   include <TlHelp32.h>
+#else
+#   include <time.h>
+#endif
+#if defined(ZYAN_MSVC)
+#   include <intrin.h>
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum distance between the target addresses of inline hooks that are
+ *          grouped together during bulk installation.
+ *
+ * All hooks of a group share the same trampoline-regions. The value leaves enough room for
+ * relative branch targets in the relocated code.
+ */
+#define ZYREX_HOOK_GROUP_RANGE  0x40000000
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the maximum number of passes over the thread list of the current process.
+ *
+ * Threads created while other threads are being suspended are picked up by the next pass. The
+ * enumeration stops as soon as a pass does not find any new threads.
+ */
+#define ZYREX_THREAD_ENUMERATION_MAX_PASSES 4
+
+/**
+ * @brief   Defines the access rights required for threads that are updated by a transaction.
+ */
+#define ZYREX_THREAD_ACCESS \
+    (THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT | \
+     THREAD_QUERY_LIMITED_INFORMATION)
+
 #endif
 
 /* ============================================================================================== */
@@ -57,7 +97,15 @@ typedef enum ZyrexOperationAction_
     /**
      * @brief   Removal action.
      */
-     ZYREX_OPERATION_ACTION_REMOVE
+     ZYREX_OPERATION_ACTION_REMOVE,
+    /**
+     * @brief   Adds a callback to the hook chain of an already hooked function.
+     */
+     ZYREX_OPERATION_ACTION_CHAIN_ADD,
+    /**
+     * @brief   Removes a callback from the hook chain of a hooked function.
+     */
+     ZYREX_OPERATION_ACTION_CHAIN_REMOVE
 } ZyrexOperationAction;
 
 /**
@@ -81,6 +129,20 @@ typedef struct ZyrexOperation_
      * @brief   The trampoline chunk.
      */
     ZyrexTrampolineChunk* trampoline;
+    /**
+     * @brief   The callback of a chained hook.
+     */
+    const void* callback;
+    /**
+     * @brief   The memory passed by the user to store the next function of a chained hook or
+     *          `ZYAN_NULL`, if the operation does not belong to a chained hook.
+     */
+    ZyanConstVoidPointer* next;
+    /**
+     * @brief   The table entries of an import table hook that are exchanged by an attach
+     *          operation.
+     */
+    ZyanVector/*<ZyrexImportSlot>*/ slots;
     /**
      * @brief   This value points to the memory that is passed by the user to store the trampoline
      *          pointer.
@@ -88,6 +150,71 @@ typedef struct ZyrexOperation_
     //ZyanConstVoidPointer* trampoline_accessor;
 } ZyrexOperation;
 
+/**
+ * @brief   Defines the `ZyrexHookChainLink` struct.
+ */
+typedef struct ZyrexHookChainLink_
+{
+    /**
+     * @brief   The callback address.
+     */
+    const void* callback;
+    /**
+     * @brief   The memory passed by the user to store the next function in the chain.
+     */
+    ZyanConstVoidPointer* next;
+} ZyrexHookChainLink;
+
+/**
+ * @brief   Defines the `ZyrexHookChain` struct.
+ *
+ * The callbacks of a chained hook share a single trampoline. The first link is the callback the
+ * trampoline redirects to. Every callback continues the chain by calling the function stored in
+ * its `next` pointer, which is either the callback of the following link or the trampoline code
+ * for the last link.
+ */
+typedef struct ZyrexHookChain_
+{
+    /**
+     * @brief   The trampoline chunk.
+     */
+    ZyrexTrampolineChunk* trampoline;
+    /**
+     * @brief   The links of the chain.
+     */
+    ZyanVector/*<ZyrexHookChainLink>*/ links;
+} ZyrexHookChain;
+
+/**
+ * @brief   Defines the `ZyrexImportHook` struct.
+ */
+typedef struct ZyrexImportHook_
+{
+    /**
+     * @brief   The address of the hooked function.
+     */
+    const void* function;
+    /**
+     * @brief   The table entries that have been redirected to the callback.
+     */
+    ZyanVector/*<ZyrexImportSlot>*/ slots;
+} ZyrexImportHook;
+
+/**
+ * @brief   Defines the `ZyrexPatchPage` struct.
+ */
+typedef struct ZyrexPatchPage_
+{
+    /**
+     * @brief   The base address of the memory page.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The original page protection (platform specific).
+     */
+    ZyanU32 protection;
+} ZyrexPatchPage;
+
 /* ============================================================================================== */
 /* Globals                                                                                        */
 /* ============================================================================================== */
@@ -101,10 +228,23 @@ static struct
      * @brief   The id of the thread that started the current transaction.
      */
     volatile ZyanThreadId transaction_thread_id;
+    /**
+     * @brief   The flags of the current transaction (a combination of `ZyrexTransactionFlags`
+     *          values).
+     */
+    ZyanU32 flags;
     /**
      * @brief   A list with all pending operations.
      */
     ZyanVector/*<ZyrexOperation>*/ pending_operations;
+    /**
+     * @brief   The statistics of the current transaction.
+     */
+    ZyrexTransactionStatistics statistics;
+    /**
+     * @brief   The number of trampoline-regions allocated before the current transaction.
+     */
+    ZyanUSize region_allocations;
 
 #ifdef ZYAN_WINDOWS
 
@@ -112,16 +252,57 @@ static struct
      * @brief   A list with all threads to update.
      */
     ZyanVector/*<HANDLE>*/ threads_to_update;
+    /**
+     * @brief   Signals, if the suspension of all threads has been deferred to the commit.
+     */
+    ZyanBool update_all_threads;
+    /**
+     * @brief   The timestamp at which the first thread has been suspended, or `0`, if no thread
+     *          has been suspended yet.
+     */
+    ZyanU64 frozen_since;
 
 #endif
 } g_transaction_data =
 {
-    0, ZYAN_VECTOR_INITIALIZER,
+    0, ZYREX_TRANSACTION_FLAG_NONE, ZYAN_VECTOR_INITIALIZER, { 0 }, 0,
 #ifdef ZYAN_WINDOWS
-    ZYAN_VECTOR_INITIALIZER
+    ZYAN_VECTOR_INITIALIZER, ZYAN_FALSE, 0
 #endif
 };
 
+/**
+ * @brief   Contains global hook chain data.
+ *
+ * The hook chains are only modified while committing a transaction.
+ */
+static struct
+{
+    /**
+     * @brief   A list with all installed hook chains.
+     */
+    ZyanVector/*<ZyrexHookChain>*/ chains;
+} g_chain_data =
+{
+    ZYAN_VECTOR_INITIALIZER
+};
+
+/**
+ * @brief   Contains global import table hook data.
+ *
+ * The import table hooks are only modified while committing a transaction.
+ */
+static struct
+{
+    /**
+     * @brief   A list with all installed import table hooks.
+     */
+    ZyanVector/*<ZyrexImportHook>*/ hooks;
+} g_import_data =
+{
+    ZYAN_VECTOR_INITIALIZER
+};
+
 /* ============================================================================================== */
 /* Internal functions                                                                             */
 /* ============================================================================================== */
@@ -147,178 +328,290 @@ static void ZyrexWindowsHandleDestroy(HANDLE* item)
 #endif
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Code Patching                                                                                  */
+/* Transaction statistics                                                                         */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Writes the hook jump which redirects the code-flow from the given `address` to the
- *          `trampoline`.
- *
- * @param   address     The target address.
- * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ * @brief   Returns a monotonic timestamp in nanoseconds.
  *
- * @return  A zyan status code.
+ * @return  A monotonic timestamp in nanoseconds.
  */
-static ZyanStatus ZyrexWriteHookJump(void* address, const ZyrexTrampolineChunk* trampoline)
+static ZyanU64 ZyrexGetTimestamp(void)
 {
-    ZYAN_ASSERT(address);
-    ZYAN_ASSERT(trampoline);
-
-    ZYAN_CHECK(ZyanMemoryVirtualProtect(address, ZYREX_SIZEOF_RELATIVE_JUMP,
-        ZYAN_PAGE_EXECUTE_READWRITE));
-
-#if defined(ZYAN_X64)
-
-    ZyrexWriteRelativeJump(address, (ZyanUPointer)&trampoline->callback_jump);
-
-#elif defined(ZYAN_X86)
-
-    ZyrexWriteRelativeJump(address, (ZyanUPointer)trampoline->callback_address);
-
+#ifdef ZYAN_WINDOWS
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (ZyanU64)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
 #else
-#   error "Unsupported platform"
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ZyanU64)ts.tv_sec * 1000000000ULL + (ZyanU64)ts.tv_nsec;
 #endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook specifications                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
 
-    // TODO: Restore actual protection
-    ZYAN_CHECK(ZyanMemoryVirtualProtect(address, ZYREX_SIZEOF_RELATIVE_JUMP,
-        ZYAN_PAGE_EXECUTE_READ));
+/**
+ * @brief   Compares two `ZyrexHookSpec` pointers by their target address.
+ *
+ * @param   left    A pointer to the first `ZyrexHookSpec` pointer.
+ * @param   right   A pointer to the second `ZyrexHookSpec` pointer.
+ *
+ * @return  Returns `0` if the addresses are equal, a value less than `0` if the address of
+ *          `left` is lower, or a value greater than `0` if the address of `left` is higher.
+ */
+static ZyanI32 ZyrexCompareHookSpec(const ZyrexHookSpec* const* left,
+    const ZyrexHookSpec* const* right)
+{
+    ZYAN_ASSERT(left);
+    ZYAN_ASSERT(right);
 
-    return ZyanProcessFlushInstructionCache(address, ZYREX_SIZEOF_RELATIVE_JUMP);
+    if ((*left)->address < (*right)->address)
+    {
+        return -1;
+    }
+    if ((*left)->address > (*right)->address)
+    {
+        return 1;
+    }
+    return 0;
 }
 
 /**
- * @brief   Reads the original code instructions from the `trampoline` and restores them to the
- *          given `address`.
+ * @brief   Releases the resources owned by the given pending operation.
  *
- * @param   address     The target address.
- * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
  *
- * @return  A zyan status code.
+ * Only attach operations own resources (the trampoline or the list of table entries).
  */
-static ZyanStatus ZyrexRestoreInstructions(void* address, const ZyrexTrampolineChunk* trampoline)
+static void ZyrexReleaseOperation(ZyrexOperation* operation)
 {
-    ZYAN_CHECK(ZyanMemoryVirtualProtect(address, ZYREX_SIZEOF_RELATIVE_JUMP,
-        ZYAN_PAGE_EXECUTE_READWRITE));
+    ZYAN_ASSERT(operation);
 
-    ZYAN_MEMCPY(address, &trampoline->original_code, trampoline->original_code_size);
+    if (operation->action != ZYREX_OPERATION_ACTION_ATTACH)
+    {
+        return;
+    }
+    if (operation->type == ZYREX_HOOK_TYPE_IMPORT_TABLE)
+    {
+        ZyanVectorDestroy(&operation->slots);
+        return;
+    }
+    ZYAN_UNUSED(ZyrexTrampolineFree(operation->trampoline));
+}
 
-    // TODO: Restore actual protection
-    ZYAN_CHECK(ZyanMemoryVirtualProtect(address, ZYREX_SIZEOF_RELATIVE_JUMP,
-        ZYAN_PAGE_EXECUTE_READ));
+/**
+ * @brief   Removes and frees all pending operations starting at the given index.
+ *
+ * @param   index   The index of the first operation to remove.
+ */
+static void ZyrexDiscardOperations(ZyanUSize index)
+{
+    while (g_transaction_data.pending_operations.size > index)
+    {
+        ZyrexOperation* const item = ZyanVectorGetMutable(&g_transaction_data.pending_operations,
+            g_transaction_data.pending_operations.size - 1);
+        ZYAN_ASSERT(item);
 
-    return ZyanProcessFlushInstructionCache(address, ZYREX_SIZEOF_RELATIVE_JUMP);
+        ZyrexReleaseOperation(item);
+        ZYAN_UNUSED(ZyanVectorPopBack(&g_transaction_data.pending_operations));
+    }
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread enumeration                                                                             */
 /* ---------------------------------------------------------------------------------------------- */
 
-/* ============================================================================================== */
-/* Exported functions                                                                             */
-/* ============================================================================================== */
+#ifdef ZYAN_WINDOWS
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Transaction                                                                                    */
-/* ---------------------------------------------------------------------------------------------- */
+/**
+ * @brief   Defines the `ZyrexNtGetNextThread` function prototype.
+ */
+typedef LONG (NTAPI* ZyrexNtGetNextThread)(HANDLE process_handle, HANDLE thread_handle,
+    ACCESS_MASK desired_access, ULONG handle_attributes, ULONG flags, PHANDLE new_thread_handle);
 
-ZyanStatus ZyrexTransactionBegin(void)
+/**
+ * @brief   Suspends the given thread and updates the statistics of the current transaction.
+ *
+ * @param   thread_handle   The thread handle.
+ *
+ * @return  `ZYAN_TRUE`, if the thread has been suspended, or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexSuspendThread(HANDLE thread_handle)
 {
-    if (g_transaction_data.transaction_thread_id != 0)
-    {
-        return ZYAN_STATUS_INVALID_OPERATION;
-    }
-
-#ifdef ZYAN_WINDOWS
+    const ZyanU64 timestamp = ZyrexGetTimestamp();
+    const ZyanBool result = (SuspendThread(thread_handle) != (DWORD)(-1));
+    g_transaction_data.statistics.suspend_time += ZyrexGetTimestamp() - timestamp;
 
-    // TODO: Use platform independent APIs
-    if (InterlockedCompareExchange((volatile LONG*)&g_transaction_data.transaction_thread_id,
-        (LONG)GetCurrentThreadId(), 0) != 0)
+    if (result && !g_transaction_data.frozen_since)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        g_transaction_data.frozen_since = timestamp;
     }
 
-#else
-
-    ZyanThreadId tid;
-    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
-    g_transaction_data.transaction_thread_id = tid;
-
-#endif
-
-    ZYAN_CHECK(ZyanVectorInit(&g_transaction_data.pending_operations, sizeof(ZyrexOperation),
-        16, ZYAN_NULL));
+    return result;
+}
 
-#ifdef ZYAN_WINDOWS
+/**
+ * @brief   Returns a pointer to the `NtGetNextThread` function.
+ *
+ * @return  A pointer to the `NtGetNextThread` function or `ZYAN_NULL`, if the function is not
+ *          available on the current system.
+ */
+static ZyrexNtGetNextThread ZyrexGetNtGetNextThread(void)
+{
+    static ZyanBool is_resolved = ZYAN_FALSE;
+    static ZyrexNtGetNextThread function = ZYAN_NULL;
 
-    const ZyanStatus status = ZyanVectorInit(&g_transaction_data.threads_to_update,
-        sizeof(HANDLE), 16, (ZyanMemberProcedure)&ZyrexWindowsHandleDestroy);
-    if (!ZYAN_SUCCESS(status))
+    if (!is_resolved)
     {
-        ZyanVectorDestroy(&g_transaction_data.pending_operations);
-        return status;
+        const HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (ntdll)
+        {
+            function = (ZyrexNtGetNextThread)GetProcAddress(ntdll, "NtGetNextThread");
+        }
+        is_resolved = ZYAN_TRUE;
     }
 
-#endif
-
-    return ZYAN_STATUS_SUCCESS;
+    return function;
 }
 
-ZyanStatus ZyrexUpdateThread(ZyanThreadId thread_id)
+/**
+ * @brief   Suspends all threads of the current process (except the calling one) using the
+ *          `NtGetNextThread` function and adds them to the `threads_to_update` list.
+ *
+ * @param   nt_get_next_thread  A pointer to the `NtGetNextThread` function.
+ *
+ * @return  A zyan status code.
+ *
+ * Only the threads of the current process are enumerated. Threads that are already part of the
+ * `threads_to_update` list are skipped.
+ */
+static ZyanStatus ZyrexSuspendThreadsNative(ZyrexNtGetNextThread nt_get_next_thread)
 {
-    ZyanThreadId tid;
-    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
-
-    if (g_transaction_data.transaction_thread_id != tid)
-    {
-        return ZYAN_STATUS_INVALID_OPERATION;
-    }
+    ZYAN_ASSERT(nt_get_next_thread);
 
-#ifdef ZYAN_WINDOWS
+    const HANDLE h_process = GetCurrentProcess();
+    const DWORD current_thread_id = GetCurrentThreadId();
 
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+    // Keep a sorted list of the ids of all suspended threads to detect duplicates
+    ZyanVector thread_ids;
+    ZYAN_CHECK(ZyanVectorInit(&thread_ids, sizeof(ZyanU32),
+        g_transaction_data.threads_to_update.size + 64, ZYAN_NULL));
 
-    if (thread_id == GetCurrentThreadId())
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < g_transaction_data.threads_to_update.size; ++i)
     {
-        return ZYAN_STATUS_SUCCESS;
+        const HANDLE* const thread_handle =
+            (const HANDLE*)ZyanVectorGet(&g_transaction_data.threads_to_update, i);
+        ZYAN_ASSERT(thread_handle);
+
+        const ZyanU32 id = (ZyanU32)GetThreadId(*thread_handle);
+        ZyanUSize found_index;
+        status = ZyanVectorBinarySearch(&thread_ids, &id, &found_index,
+            (ZyanComparison)&ZyanCompareNumeric32);
+        if (status == ZYAN_STATUS_FALSE)
+        {
+            status = ZyanVectorInsert(&thread_ids, found_index, &id);
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyanVectorDestroy(&thread_ids);
+            return status;
+        }
     }
 
-    const DWORD desired_access = THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT;
-    const HANDLE handle = OpenThread(desired_access, ZYAN_FALSE, thread_id);
-    if (handle == ZYAN_NULL)
+    for (ZyanUSize pass = 0; pass < ZYREX_THREAD_ENUMERATION_MAX_PASSES; ++pass)
     {
-        return ZYAN_STATUS_INVALID_ARGUMENT;
-    }
-    if (SuspendThread(handle) == (DWORD)(-1))
-    {
-        CloseHandle(handle);
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
-    }
+        ZyanBool found_new_threads = ZYAN_FALSE;
+        ZyanBool is_current_kept = ZYAN_FALSE;
+        HANDLE h_current = ZYAN_NULL;
+        HANDLE h_next;
+        while (nt_get_next_thread(h_process, h_current, ZYREX_THREAD_ACCESS, 0, 0, &h_next) >= 0)
+        {
+            // The previous handle is required to continue the enumeration and can not be closed
+            // any earlier
+            if (h_current && !is_current_kept)
+            {
+                CloseHandle(h_current);
+            }
+            h_current = h_next;
+            is_current_kept = ZYAN_FALSE;
 
-    return ZyanVectorPushBack(&g_transaction_data.threads_to_update, &handle);
+            const ZyanU32 id = (ZyanU32)GetThreadId(h_current);
+            if (!id || (id == current_thread_id))
+            {
+                continue;
+            }
 
-#else
+            ZyanUSize found_index;
+            status = ZyanVectorBinarySearch(&thread_ids, &id, &found_index,
+                (ZyanComparison)&ZyanCompareNumeric32);
+            if (status != ZYAN_STATUS_FALSE)
+            {
+                if (!ZYAN_SUCCESS(status))
+                {
+                    break;
+                }
+                continue;
+            }
 
-    ZYAN_UNUSED(thread_id);
-    return ZYAN_STATUS_SUCCESS;
+            if (!ZyrexSuspendThread(h_current))
+            {
+                // The thread might have exited in the meantime
+                status = ZYAN_STATUS_SUCCESS;
+                continue;
+            }
 
-#endif
-}
+            status = ZyanVectorInsert(&thread_ids, found_index, &id);
+            if (ZYAN_SUCCESS(status))
+            {
+                status = ZyanVectorPushBack(&g_transaction_data.threads_to_update, &h_current);
+            }
+            if (!ZYAN_SUCCESS(status))
+            {
+                ResumeThread(h_current);
+                break;
+            }
 
-ZyanStatus ZyrexUpdateAllThreads(void)
-{
-    ZyanThreadId tid;
-    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+            is_current_kept = ZYAN_TRUE;
+            found_new_threads = ZYAN_TRUE;
+        }
 
-    if (g_transaction_data.transaction_thread_id != tid)
-    {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        if (h_current && !is_current_kept)
+        {
+            CloseHandle(h_current);
+        }
+
+        if (!ZYAN_SUCCESS(status) || !found_new_threads)
+        {
+            break;
+        }
     }
 
-#ifdef ZYAN_WINDOWS
+    ZyanVectorDestroy(&thread_ids);
 
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+    return ZYAN_SUCCESS(status) ? ZYAN_STATUS_SUCCESS : status;
+}
 
+/**
+ * @brief   Suspends all threads of the current process (except the calling one) using a
+ *          system-wide thread snapshot and adds them to the `threads_to_update` list.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is used as a fallback, if `NtGetNextThread` is not available.
+ */
+static ZyanStatus ZyrexSuspendThreadsSnapshot(void)
+{
     const DWORD pid = GetCurrentProcessId();
+    const DWORD tid = GetCurrentThreadId();
 
     const HANDLE h_snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, pid);
     if (h_snapshot == INVALID_HANDLE_VALUE)
@@ -337,11 +630,10 @@ ZyanStatus ZyrexUpdateAllThreads(void)
             if ((thread.th32OwnerProcessID == pid) && (thread.th32ThreadID != tid))
             {
                 const HANDLE h_thread =
-                    OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT,
-                        ZYAN_FALSE, thread.th32ThreadID);
+                    OpenThread(ZYREX_THREAD_ACCESS, ZYAN_FALSE, thread.th32ThreadID);
                 if (h_thread != ZYAN_NULL)
                 {
-                    if (SuspendThread(h_thread) == (DWORD)(-1))
+                    if (!ZyrexSuspendThread(h_thread))
                     {
                         CloseHandle(h_thread);
                     }
@@ -359,98 +651,1487 @@ ZyanStatus ZyrexUpdateAllThreads(void)
         return ZYAN_STATUS_BAD_SYSTEMCALL;
     }
 
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Suspends all threads of the current process (except the calling one) and adds them
+ *          to the thread-update list.
+ *
+ * @return  A zyan status code.
+ *
+ * The time that is not spent suspending threads is accounted to the thread enumeration.
+ */
+static ZyanStatus ZyrexSuspendAllThreads(void)
+{
+    ZyrexTransactionStatistics* const statistics = &g_transaction_data.statistics;
+    const ZyanU64 suspend_time = statistics->suspend_time;
+    const ZyanU64 timestamp = ZyrexGetTimestamp();
+
+    ZyanStatus status;
+    const ZyrexNtGetNextThread nt_get_next_thread = ZyrexGetNtGetNextThread();
+    if (nt_get_next_thread)
+    {
+        status = ZyrexSuspendThreadsNative(nt_get_next_thread);
+    } else
+    {
+        status = ZyrexSuspendThreadsSnapshot();
+    }
+
+    statistics->enumerate_time +=
+        (ZyrexGetTimestamp() - timestamp) - (statistics->suspend_time - suspend_time);
+
+    return status;
+}
+
 #endif
 
-    return ZYAN_STATUS_SUCCESS;
+/* ---------------------------------------------------------------------------------------------- */
+/* Code Patching                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically writes the given 16-bit `value` to the given `address`.
+ *
+ * @param   address The target address. Must be aligned to a 2-byte boundary.
+ * @param   value   The value to write.
+ *
+ * The memory at the target address must be writable.
+ */
+static void ZyrexWriteAtomic16(void* address, ZyanU16 value)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(((ZyanUPointer)address & 1) == 0);
+
+#if defined(ZYAN_MSVC)
+    _InterlockedExchange16((volatile short*)address, (short)value);
+#else
+    __atomic_store_n((volatile ZyanU16*)address, value, __ATOMIC_SEQ_CST);
+#endif
 }
 
-ZyanStatus ZyrexTransactionCommit(void)
+/**
+ * @brief   Returns the address the hook jump of the given attach `operation` has to redirect to.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ * @param   address     The address of the hook jump.
+ *
+ * @return  The destination address of the hook jump.
+ *
+ * The hook jump directly redirects to the callback, if it is in range. The callback stub of the
+ * trampoline is only used, if the callback is out of range, may be exchanged later on (chained
+ * hooks), the calls are counted by the stub or the stub checks the thread mask.
+ */
+static ZyanUPointer ZyrexGetCallbackJumpDestination(const ZyrexOperation* operation,
+    ZyanUPointer address)
 {
-    return ZyrexTransactionCommitEx(NULL);
+    ZYAN_ASSERT(operation);
+    ZYAN_ASSERT(operation->trampoline);
+
+    const ZyrexTrampolineChunk* const trampoline = operation->trampoline;
+
+#if !defined(ZYREX_HOOK_STATISTICS) && !defined(ZYREX_HOOK_THREAD_MASK)
+    if (!operation->next &&
+        ZyrexIsRelativeJumpInRange(address, trampoline->callback_address))
+    {
+        return trampoline->callback_address;
+    }
+#else
+    ZYAN_UNUSED(address);
+#endif
+
+    return (ZyanUPointer)&trampoline->callback_jump;
 }
 
-ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation)
+/**
+ * @brief   Writes the relative jump which redirects the code-flow from the given `address` to the
+ *          callback of the given attach `operation`.
+ *
+ * @param   address     The jump address.
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ */
+static void ZyrexWriteCallbackJump(void* address, const ZyrexOperation* operation)
 {
-    ZYAN_UNUSED(failed_operation);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(operation);
 
-    ZyanThreadId tid;
-    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+    ZyrexWriteRelativeJump(address,
+        ZyrexGetCallbackJumpDestination(operation, (ZyanUPointer)address));
+}
 
-    if (g_transaction_data.transaction_thread_id != tid)
+/**
+ * @brief   Atomically writes the hook jump which redirects the code-flow from the target address
+ *          of the given attach `operation` to the callback.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct. The 5 patched bytes at the target
+ *                      address must not cross an 8-byte boundary.
+ *
+ * The memory at the target address must be writable.
+ */
+static void ZyrexWriteHookJumpAtomic(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+    ZYAN_ASSERT(!ZyrexTrampolineGetChunkInfo(operation->trampoline)->is_hot_patch);
+
+    const ZyanUPointer address = (ZyanUPointer)operation->address;
+
+    ZyanU8 jump[ZYREX_SIZEOF_RELATIVE_JUMP];
+    jump[0] = 0xE9;
+    const ZyanI32 offset = ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_RELATIVE_JUMP, address,
+        ZyrexGetCallbackJumpDestination(operation, address));
+    ZYAN_MEMCPY(&jump[1], &offset, sizeof(offset));
+
+    ZyrexWriteAtomic64(operation->address, jump, sizeof(jump));
+}
+
+/**
+ * @brief   Writes the hook jump which redirects the code-flow from the target address of the
+ *          given attach `operation` to the callback.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * The memory at the target address must be writable.
+ *
+ * For hot-patch trampolines, the relative jump is written to the padding in front of the target
+ * function first. The `mov edi, edi` prologue is replaced by a short backward jump to the padding
+ * afterwards, which allows other threads to keep executing the target function.
+ */
+static void ZyrexWriteHookJump(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    void* const address = operation->address;
+    if (!ZyrexTrampolineGetChunkInfo(operation->trampoline)->is_hot_patch)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        ZyrexWriteCallbackJump(address, operation);
+        return;
     }
 
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZyrexWriteCallbackJump((ZyanU8*)address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE,
+        operation);
+
+    // jmp short $-5
+    const ZyanU8 short_jump[ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE] =
+    {
+        0xEB,
+        (ZyanU8)(-(ZyanI8)(ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE +
+            ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE))
+    };
+    ZyanU16 value;
+    ZYAN_MEMCPY(&value, short_jump, sizeof(value));
+    ZyrexWriteAtomic16(address, value);
+}
+
+/**
+ * @brief   Reads the original code instructions from the `trampoline` and restores them to the
+ *          given `address`.
+ *
+ * @param   address     The target address.
+ * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * The memory at the target address must be writable.
+ *
+ * For hot-patch trampolines, the `mov edi, edi` prologue is restored atomically before the
+ * padding in front of the target function is restored.
+ */
+static void ZyrexRestoreInstructions(void* address, const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(trampoline);
+
+    const ZyrexTrampolineChunkInfo* const info = ZyrexTrampolineGetChunkInfo(trampoline);
+    if (!info->is_hot_patch)
+    {
+        ZYAN_MEMCPY(address, &info->original_code, info->original_code_size);
+        return;
+    }
+
+    ZyanU16 value;
+    ZYAN_MEMCPY(&value, &info->original_code, sizeof(value));
+    ZyrexWriteAtomic16(address, value);
+
+    ZYAN_MEMCPY((ZyanU8*)address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE,
+        &info->hot_patch_padding, ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE);
+}
+
+/**
+ * @brief   Returns the memory range the given operation writes to.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ * @param   address     Receives the start address of the memory range.
+ * @param   size        Receives the size of the memory range.
+ */
+static void ZyrexGetOperationPatchRange(const ZyrexOperation* operation, ZyanUPointer* address,
+    ZyanUSize* size)
+{
+    ZYAN_ASSERT(operation);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(size);
+
+    const ZyrexTrampolineChunkInfo* const info =
+        ZyrexTrampolineGetChunkInfo(operation->trampoline);
+    if (info->is_hot_patch)
+    {
+        *address = (ZyanUPointer)operation->address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE;
+        *size = ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE + ZYREX_TRAMPOLINE_HOT_PATCH_PROLOGUE_SIZE;
+        return;
+    }
+
+    *address = (ZyanUPointer)operation->address;
+    switch (operation->action)
+    {
+    case ZYREX_OPERATION_ACTION_ATTACH:
+        *size = ZYREX_SIZEOF_RELATIVE_JUMP;
+        break;
+    case ZYREX_OPERATION_ACTION_REMOVE:
+        *size = info->original_code_size;
+        break;
+    default:
+        ZYAN_UNREACHABLE;
+    }
+}
+
+/**
+ * @brief   Checks, if the given operation is written atomically.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the operation is written atomically and does not require threads to
+ *          be suspended, or `ZYAN_FALSE`, if not.
+ *
+ * The hook jump of an inline hook is only considered atomic, if the first instruction of the
+ * target function covers all patched bytes. Otherwise, a concurrently running thread might
+ * resume in the middle of the new jump instruction.
+ */
+static ZyanBool ZyrexIsOperationAtomic(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    if (!(g_transaction_data.flags & ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES))
+    {
+        return ZYAN_FALSE;
+    }
+    if (operation->type == ZYREX_HOOK_TYPE_IMPORT_TABLE)
+    {
+        return ZYAN_TRUE;
+    }
+    if (operation->type != ZYREX_HOOK_TYPE_INLINE)
+    {
+        return ZYAN_FALSE;
+    }
+    if ((operation->action == ZYREX_OPERATION_ACTION_CHAIN_ADD) ||
+        (operation->action == ZYREX_OPERATION_ACTION_CHAIN_REMOVE))
+    {
+        return ZYAN_TRUE;
+    }
+    if (operation->action != ZYREX_OPERATION_ACTION_ATTACH)
+    {
+        return ZYAN_FALSE;
+    }
+    const ZyrexTrampolineChunkInfo* const info =
+        ZyrexTrampolineGetChunkInfo(operation->trampoline);
+    if (info->is_hot_patch)
+    {
+        return ZYAN_TRUE;
+    }
+
+    // The translation map contains one item per relocated instruction. The smallest non-zero
+    // source offset is the length of the first instruction
+    ZyanUSize first_instruction_length = info->original_code_size;
+    for (ZyanUSize i = 0; i < info->translation_map.count; ++i)
+    {
+        const ZyanU8 offset = info->translation_map.items[i].offset_source;
+        if ((offset != 0) && (offset < first_instruction_length))
+        {
+            first_instruction_length = offset;
+        }
+    }
+    if (first_instruction_length < ZYREX_SIZEOF_RELATIVE_JUMP)
+    {
+        return ZYAN_FALSE;
+    }
+
+    return (((ZyanUPointer)operation->address & 7) + ZYREX_SIZEOF_RELATIVE_JUMP <= 8);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread migration                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
 #ifdef ZYAN_WINDOWS
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
-#endif
 
-    ZyanISize revert_index = (ZyanISize)(-1);
-    ZyanStatus status = ZYAN_STATUS_SUCCESS;
-    for (ZyanISize i = 0; i < (ZyanISize)g_transaction_data.pending_operations.size; ++i)
+/**
+ * @brief   Compares two `ZyrexThreadMigrationRange` items by their source address.
+ */
+ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareMigrationRange, ZyrexThreadMigrationRange, source)
+
+/**
+ * @brief   Collects the code ranges that threads have to be migrated away from for all pending
+ *          operations.
+ *
+ * @param   ranges  A pointer to an initialized `ZyanVector<ZyrexThreadMigrationRange>` instance
+ *                  that receives the list of migration ranges, sorted by their source address.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexCollectMigrationRanges(ZyanVector* ranges)
+{
+    ZYAN_ASSERT(ranges);
+
+    // The padding jump of a hot-patch hook has no equivalent in the original code and maps to the
+    // restored `mov edi, edi` prologue
+    static const ZyrexInstructionTranslationMap hot_patch_translation_map =
     {
-        const ZyrexOperation* item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        1, { { ZYREX_TRANSLATION_TYPE_DEFAULT, 0, 0, 0 } }
+    };
+
+    for (ZyanUSize i = 0; i < g_transaction_data.pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
         ZYAN_ASSERT(item);
 
-        switch (item->type)
+        // Atomic writes and hook chain updates do not require thread migration
+        if ((item->type != ZYREX_HOOK_TYPE_INLINE) ||
+            (item->action == ZYREX_OPERATION_ACTION_CHAIN_ADD) ||
+            (item->action == ZYREX_OPERATION_ACTION_CHAIN_REMOVE) ||
+            ZyrexIsOperationAtomic(item))
         {
-        case ZYREX_HOOK_TYPE_INLINE:
+            continue;
+        }
+
+        const ZyrexTrampolineChunkInfo* const info =
+            ZyrexTrampolineGetChunkInfo(item->trampoline);
+        ZyrexThreadMigrationRange range;
+        if (info->is_hot_patch)
+        {
+            // No instructions are relocated, but threads that already took the short jump and
+            // are about to execute the padding jump would resume on the restored padding
+            if (item->action != ZYREX_OPERATION_ACTION_REMOVE)
+            {
+                continue;
+            }
+            range.source = (ZyanUPointer)item->address - ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE;
+            range.source_length = ZYREX_TRAMPOLINE_HOT_PATCH_PADDING_SIZE;
+            range.destination = (ZyanUPointer)item->address;
+            range.translation_map = &hot_patch_translation_map;
+            range.direction = ZYREX_THREAD_MIGRATION_DIRECTION_SRC_DST;
+        } else
+        {
+            range.translation_map = &info->translation_map;
             switch (item->action)
             {
             case ZYREX_OPERATION_ACTION_ATTACH:
-            {
-#ifdef ZYAN_WINDOWS
+                range.source = (ZyanUPointer)item->address;
+                range.source_length = info->original_code_size;
+                range.destination = (ZyanUPointer)&item->trampoline->code_buffer;
+                range.direction = ZYREX_THREAD_MIGRATION_DIRECTION_SRC_DST;
+                break;
+            case ZYREX_OPERATION_ACTION_REMOVE:
+                range.source = (ZyanUPointer)&item->trampoline->code_buffer;
+                range.source_length = info->code_buffer_size;
+                range.destination = (ZyanUPointer)item->address;
+                range.direction = ZYREX_THREAD_MIGRATION_DIRECTION_DST_SRC;
+                break;
+            default:
+                ZYAN_UNREACHABLE;
+            }
+        }
 
-                for (ZyanISize j = 0; j < (ZyanISize)g_transaction_data.threads_to_update.size;
-                    ++j)
-                {
-                    const HANDLE* const thread_handle =
-                        (const HANDLE*)ZyanVectorGet(&g_transaction_data.threads_to_update, j);
-                    ZYAN_ASSERT(thread_handle);
-
-                    // TODO: Handle status code
-                    ZyrexMigrateThread(*thread_handle, item->address,
-                        item->trampoline->original_code_size, &item->trampoline->code_buffer,
-                        item->trampoline->code_buffer_size, &item->trampoline->translation_map,
-                        ZYREX_THREAD_MIGRATION_DIRECTION_SRC_DST);
-                }
+        ZyanUSize found_index;
+        ZYAN_CHECK(ZyanVectorBinarySearch(ranges, &range, &found_index,
+            (ZyanComparison)&ZyrexCompareMigrationRange));
+        ZYAN_CHECK(ZyanVectorInsert(ranges, found_index, &range));
+    }
 
-#endif
+    return ZYAN_STATUS_SUCCESS;
+}
 
-                // TODO: Check if code has changed between this call and the Attach*
-                status = ZyrexWriteHookJump(item->address, item->trampoline);
-                break;
-            }
-            case ZYREX_OPERATION_ACTION_REMOVE:
+/**
+ * @brief   Checks, if at least one of the pending operations requires threads to be suspended.
+ *
+ * @return  `ZYAN_TRUE`, if at least one of the pending operations can not be written atomically,
+ *          or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexRequiresThreadUpdate(void)
+{
+    for (ZyanUSize i = 0; i < g_transaction_data.pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if (!ZyrexIsOperationAtomic(item))
+        {
+            return ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Migrates all suspended threads away from the code ranges modified by the pending
+ *          operations.
+ *
+ * @return  A zyan status code.
+ *
+ * The context of every thread is read once, regardless of the number of pending operations.
+ */
+static ZyanStatus ZyrexMigrateThreads(void)
+{
+    ZyanVector ranges;
+    ZYAN_CHECK(ZyanVectorInit(&ranges, sizeof(ZyrexThreadMigrationRange),
+        g_transaction_data.pending_operations.size, ZYAN_NULL));
+
+    const ZyanStatus status = ZyrexCollectMigrationRanges(&ranges);
+    if (ZYAN_SUCCESS(status))
+    {
+        for (ZyanUSize i = 0; i < g_transaction_data.threads_to_update.size; ++i)
+        {
+            const HANDLE* const thread_handle =
+                (const HANDLE*)ZyanVectorGet(&g_transaction_data.threads_to_update, i);
+            ZYAN_ASSERT(thread_handle);
+
+            // TODO: Handle status code
+            if (ZyrexMigrateThread(*thread_handle, (const ZyrexThreadMigrationRange*)ranges.data,
+                ranges.size) == ZYAN_STATUS_TRUE)
             {
-#ifdef ZYAN_WINDOWS
+                ++g_transaction_data.statistics.migration_count;
+            }
+        }
+    }
 
-                for (ZyanISize j = 0; j < (ZyanISize)g_transaction_data.threads_to_update.size;
-                    ++j)
-                {
-                    const HANDLE* const thread_handle =
-                        (const HANDLE*)ZyanVectorGet(&g_transaction_data.threads_to_update, j);
-                    ZYAN_ASSERT(thread_handle);
-
-                    // TODO: Handle status code
-                    ZyrexMigrateThread(*thread_handle, &item->trampoline->code_buffer,
-                        item->trampoline->code_buffer_size, item->address,
-                        item->trampoline->original_code_size, &item->trampoline->translation_map,
-                        ZYREX_THREAD_MIGRATION_DIRECTION_DST_SRC);
-                }
+    ZyanVectorDestroy(&ranges);
+
+    return status;
+}
+
+/**
+ * @brief   Resumes all threads that have been suspended by the current transaction.
+ */
+static void ZyrexResumeThreads(void)
+{
+    for (ZyanUSize i = 0; i < g_transaction_data.threads_to_update.size; ++i)
+    {
+        const HANDLE* const thread_handle =
+            (const HANDLE*)ZyanVectorGet(&g_transaction_data.threads_to_update, i);
+        ZYAN_ASSERT(thread_handle);
+
+        ResumeThread(*thread_handle);
+    }
+}
 
 #endif
 
-                status = ZyrexRestoreInstructions(item->address, item->trampoline);
-                if (ZYAN_SUCCESS(status))
-                {
-                    status = ZyrexTrampolineFree(item->trampoline);
-                    if (status == ZYAN_STATUS_FALSE)
-                    {
-                        status = ZYAN_STATUS_NOT_FOUND;
-                    }
-                }
+/* ---------------------------------------------------------------------------------------------- */
+/* Import table hooks                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Searches for the installed import table hook of the given `function`.
+ *
+ * @param   function    The address of the hooked function.
+ *
+ * @return  A pointer to the import table hook or `ZYAN_NULL`, if the function is not hooked by
+ *          an import table hook.
+ */
+static ZyrexImportHook* ZyrexFindImportHook(const void* function)
+{
+    for (ZyanUSize i = 0; i < g_import_data.hooks.size; ++i)
+    {
+        ZyrexImportHook* const hook = ZyanVectorGetMutable(&g_import_data.hooks, i);
+        ZYAN_ASSERT(hook);
+
+        if (hook->function == function)
+        {
+            return hook;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/**
+ * @brief   Searches for a pending import table operation of the given `function`.
+ *
+ * @param   function    The address of the function.
+ * @param   action      The operation action.
+ *
+ * @return  `ZYAN_TRUE`, if a matching operation is pending, or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexIsImportOperationPending(const void* function, ZyrexOperationAction action)
+{
+    for (ZyanUSize i = 0; i < g_transaction_data.pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if ((item->type == ZYREX_HOOK_TYPE_IMPORT_TABLE) && (item->action == action) &&
+            (item->address == function))
+        {
+            return ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Exchanges all table entries of the given import table hook.
+ *
+ * @param   slots   A pointer to the `ZyanVector<ZyrexImportSlot>` instance.
+ * @param   install `ZYAN_TRUE` to redirect the table entries to the callback or `ZYAN_FALSE` to
+ *                  restore the original table entries.
+ *
+ * @return  `ZYAN_STATUS_INVALID_OPERATION`, if a table entry has been modified by someone else, or
+ *          `ZYAN_STATUS_SUCCESS`, if not.
+ *
+ * Every table entry is exchanged with a single atomic write. If one of the entries does not
+ * contain the expected value, all entries exchanged so far are reverted.
+ */
+static ZyanStatus ZyrexImportHookExchangeSlots(const ZyanVector* slots, ZyanBool install)
+{
+    ZYAN_ASSERT(slots);
+
+    for (ZyanUSize i = 0; i < slots->size; ++i)
+    {
+        const ZyrexImportSlot* const slot = ZyanVectorGet(slots, i);
+        ZYAN_ASSERT(slot);
+
+        const ZyanUPointer expected = install ? slot->original : slot->replacement;
+        const ZyanUPointer desired = install ? slot->replacement : slot->original;
+        if (ZyrexImportTableExchangeSlot(slot, expected, desired))
+        {
+            continue;
+        }
+
+        while (i > 0)
+        {
+            const ZyrexImportSlot* const exchanged = ZyanVectorGet(slots, --i);
+            ZYAN_ASSERT(exchanged);
+
+            ZYAN_UNUSED(ZyrexImportTableExchangeSlot(exchanged,
+                install ? exchanged->replacement : exchanged->original,
+                install ? exchanged->original : exchanged->replacement));
+        }
+
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Redirects the table entries of the given attach `operation` to the callback and adds
+ *          the import table hook to the list of installed hooks.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * No table entry is modified, if the function fails. The table entries stay owned by the
+ * `operation` in this case.
+ */
+static ZyanStatus ZyrexImportHookAttach(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    if (!g_import_data.hooks.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_import_data.hooks, sizeof(ZyrexImportHook), 8, ZYAN_NULL));
+    }
+
+    // Reserve the memory of the new hook first, so that the insertion cannot fail after the table
+    // entries have been exchanged
+    ZyanStatus status = ZyanVectorReserve(&g_import_data.hooks, g_import_data.hooks.size + 1);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexImportHookExchangeSlots(&operation->slots, ZYAN_TRUE);
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        if (g_import_data.hooks.size == 0)
+        {
+            ZyanVectorDestroy(&g_import_data.hooks);
+        }
+        return status;
+    }
+
+    ZyrexImportHook hook;
+    hook.function = operation->address;
+    hook.slots = operation->slots;
+
+    return ZyanVectorPushBack(&g_import_data.hooks, &hook);
+}
+
+/**
+ * @brief   Restores the table entries of the import table hook of the given remove `operation`
+ *          and removes it from the list of installed hooks.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook stays installed, if the function fails.
+ */
+static ZyanStatus ZyrexImportHookRemove(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    ZyrexImportHook* const hook = ZyrexFindImportHook(operation->address);
+    if (!hook)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZYAN_CHECK(ZyrexImportHookExchangeSlots(&hook->slots, ZYAN_FALSE));
+
+    ZyanVectorDestroy(&hook->slots);
+    ZYAN_UNUSED(ZyanVectorDelete(&g_import_data.hooks,
+        (ZyanUSize)(hook - (ZyrexImportHook*)g_import_data.hooks.data)));
+
+    if (g_import_data.hooks.size == 0)
+    {
+        ZyanVectorDestroy(&g_import_data.hooks);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Page protection                                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Compares two `ZyrexPatchPage` items by their address.
+ */
+ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexComparePatchPage, ZyrexPatchPage, address)
+
+/**
+ * @brief   Adds all memory pages of the given memory range to the given list, if not already
+ *          contained.
+ *
+ * @param   pages       A pointer to the `ZyanVector<ZyrexPatchPage>` instance.
+ * @param   page_size   The size of a single memory page.
+ * @param   address     The start address of the memory range.
+ * @param   size        The size of the memory range.
+ * @param   protection  The assumed original protection of the pages (only used on platforms that
+ *                      can not query the page protection).
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexAddPatchPages(ZyanVector* pages, ZyanUSize page_size,
+    ZyanUPointer address, ZyanUSize size, ZyanU32 protection)
+{
+    ZYAN_ASSERT(pages);
+    ZYAN_ASSERT(page_size);
+
+    const ZyanUPointer begin = address & ~((ZyanUPointer)page_size - 1);
+    const ZyanUPointer end = address + size;
+    for (ZyanUPointer current = begin; current < end; current += page_size)
+    {
+        const ZyrexPatchPage page = { current, protection };
+
+        ZyanUSize found_index;
+        const ZyanStatus status = ZyanVectorBinarySearch(pages, &page, &found_index,
+            (ZyanComparison)&ZyrexComparePatchPage);
+        ZYAN_CHECK(status);
+
+        if (status == ZYAN_STATUS_FALSE)
+        {
+            ZYAN_CHECK(ZyanVectorInsert(pages, found_index, &page));
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Collects all memory pages that are written by the pending operations.
+ *
+ * @param   pages       A pointer to an initialized `ZyanVector<ZyrexPatchPage>` instance that
+ *                      receives the sorted list of unique pages.
+ * @param   page_size   The size of a single memory page.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexCollectPatchPages(ZyanVector* pages, ZyanUSize page_size)
+{
+    ZYAN_ASSERT(pages);
+    ZYAN_ASSERT(page_size);
+
+    for (ZyanUSize i = 0; i < g_transaction_data.pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if (item->type == ZYREX_HOOK_TYPE_IMPORT_TABLE)
+        {
+            const ZyanVector* slots = &item->slots;
+            if (item->action == ZYREX_OPERATION_ACTION_REMOVE)
+            {
+                const ZyrexImportHook* const hook = ZyrexFindImportHook(item->address);
+                if (!hook)
+                {
+                    continue;
+                }
+                slots = &hook->slots;
+            }
+            for (ZyanUSize j = 0; j < slots->size; ++j)
+            {
+                const ZyrexImportSlot* const slot = ZyanVectorGet(slots, j);
+                ZYAN_ASSERT(slot);
+
+                ZYAN_CHECK(ZyrexAddPatchPages(pages, page_size, (ZyanUPointer)slot->address,
+                    slot->size, slot->protection));
+            }
+            continue;
+        }
+
+        if ((item->type != ZYREX_HOOK_TYPE_INLINE) ||
+            (item->action == ZYREX_OPERATION_ACTION_CHAIN_ADD) ||
+            (item->action == ZYREX_OPERATION_ACTION_CHAIN_REMOVE))
+        {
+            continue;
+        }
+
+        ZyanUPointer patch_address;
+        ZyanUSize patch_size;
+        ZyrexGetOperationPatchRange(item, &patch_address, &patch_size);
+        ZYAN_CHECK(ZyrexAddPatchPages(pages, page_size, patch_address, patch_size,
+            ZYAN_PAGE_EXECUTE_READ));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Makes the given memory pages writable and saves their original protection.
+ *
+ * @param   pages       A pointer to the `ZyanVector<ZyrexPatchPage>` instance.
+ * @param   page_size   The size of a single memory page.
+ * @param   count       Receives the number of pages that have been successfully unprotected.
+ *
+ * @return  A zyan status code.
+ *
+ * Every page is unprotected with a single system call.
+ */
+static ZyanStatus ZyrexUnprotectPatchPages(ZyanVector* pages, ZyanUSize page_size,
+    ZyanUSize* count)
+{
+    ZYAN_ASSERT(pages);
+    ZYAN_ASSERT(count);
+
+    *count = 0;
+    for (ZyanUSize i = 0; i < pages->size; ++i)
+    {
+        ZyrexPatchPage* const page = ZyanVectorGetMutable(pages, i);
+        ZYAN_ASSERT(page);
+
+#ifdef ZYAN_WINDOWS
+
+        DWORD old_protection;
+        if (!VirtualProtect((void*)page->address, page_size, PAGE_EXECUTE_READWRITE,
+            &old_protection))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        page->protection = (ZyanU32)old_protection;
+
+#else
+
+        // The original protection can not be queried on all platforms and is assumed while
+        // collecting the pages
+        ZYAN_CHECK(ZyanMemoryVirtualProtect((void*)page->address, page_size,
+            ZYAN_PAGE_EXECUTE_READWRITE));
+
+#endif
+
+        ++*count;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Restores the original protection of the given memory pages.
+ *
+ * @param   pages       A pointer to the `ZyanVector<ZyrexPatchPage>` instance.
+ * @param   page_size   The size of a single memory page.
+ * @param   count       The number of pages to restore, starting at the first one.
+ *
+ * @return  A zyan status code.
+ *
+ * Adjacent pages with the same original protection are restored with a single system call.
+ */
+static ZyanStatus ZyrexRestorePatchPages(const ZyanVector* pages, ZyanUSize page_size,
+    ZyanUSize count)
+{
+    ZYAN_ASSERT(pages);
+    ZYAN_ASSERT(count <= pages->size);
+
+    ZyanStatus result = ZYAN_STATUS_SUCCESS;
+
+    // Restore page protection
+    ZyanUSize i = 0;
+    while (i < count)
+    {
+        const ZyrexPatchPage* const first = ZyanVectorGet(pages, i);
+        ZYAN_ASSERT(first);
+
+        ZyanUSize size = page_size;
+        for (++i; i < count; ++i)
+        {
+            const ZyrexPatchPage* const page = ZyanVectorGet(pages, i);
+            ZYAN_ASSERT(page);
+            if ((page->address != first->address + size) ||
+                (page->protection != first->protection))
+            {
+                break;
+            }
+            size += page_size;
+        }
+
+#ifdef ZYAN_WINDOWS
+        DWORD old_protection;
+        if (!VirtualProtect((void*)first->address, size, (DWORD)first->protection,
+            &old_protection))
+        {
+            result = ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+#else
+        const ZyanStatus status = ZyanMemoryVirtualProtect((void*)first->address, size,
+            (ZyanMemoryPageProtection)first->protection);
+        if (!ZYAN_SUCCESS(status))
+        {
+            result = status;
+        }
+#endif
+    }
+
+    return result;
+}
+
+/**
+ * @brief   Flushes the instruction cache for the given memory pages.
+ *
+ * @param   pages       A pointer to the `ZyanVector<ZyrexPatchPage>` instance.
+ * @param   page_size   The size of a single memory page.
+ * @param   count       The number of pages to flush, starting at the first one.
+ *
+ * @return  A zyan status code.
+ *
+ * The instruction cache is flushed once for every range of adjacent pages.
+ */
+static ZyanStatus ZyrexFlushPatchPages(const ZyanVector* pages, ZyanUSize page_size,
+    ZyanUSize count)
+{
+    ZYAN_ASSERT(pages);
+    ZYAN_ASSERT(count <= pages->size);
+
+    ZyanStatus result = ZYAN_STATUS_SUCCESS;
+
+    ZyanUSize i = 0;
+    while (i < count)
+    {
+        const ZyrexPatchPage* const first = ZyanVectorGet(pages, i);
+        ZYAN_ASSERT(first);
+
+        ZyanUSize size = page_size;
+        for (++i; i < count; ++i)
+        {
+            const ZyrexPatchPage* const page = ZyanVectorGet(pages, i);
+            ZYAN_ASSERT(page);
+            if (page->address != first->address + size)
+            {
+                break;
+            }
+            size += page_size;
+        }
+
+        const ZyanStatus status = ZyanProcessFlushInstructionCache((void*)first->address, size);
+        if (!ZYAN_SUCCESS(status))
+        {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook chains                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically writes the given `value` to the given pointer `slot`.
+ *
+ * @param   slot    A pointer to the pointer to write.
+ * @param   value   The value to write.
+ */
+static void ZyrexWriteAtomicPointer(ZyanConstVoidPointer* slot, const void* value)
+{
+    ZYAN_ASSERT(slot);
+
+#if defined(ZYAN_MSVC)
+    InterlockedExchangePointer((volatile PVOID*)slot, (PVOID)value);
+#else
+    __atomic_store_n(slot, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief   Searches for the hook chain of the given `trampoline`.
+ *
+ * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A pointer to the hook chain or `ZYAN_NULL`, if the trampoline does not belong to a
+ *          chained hook.
+ */
+static ZyrexHookChain* ZyrexFindHookChain(const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+
+    for (ZyanUSize i = 0; i < g_chain_data.chains.size; ++i)
+    {
+        ZyrexHookChain* const chain = ZyanVectorGetMutable(&g_chain_data.chains, i);
+        ZYAN_ASSERT(chain);
+
+        if (chain->trampoline == trampoline)
+        {
+            return chain;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/**
+ * @brief   Searches for the hook chain of the given target `address`.
+ *
+ * @param   address The address of the hooked function.
+ *
+ * @return  A pointer to the hook chain or `ZYAN_NULL`, if the function is not hooked by a
+ *          chained hook.
+ */
+static ZyrexHookChain* ZyrexFindHookChainByAddress(const void* address)
+{
+    for (ZyanUSize i = 0; i < g_chain_data.chains.size; ++i)
+    {
+        ZyrexHookChain* const chain = ZyanVectorGetMutable(&g_chain_data.chains, i);
+        ZYAN_ASSERT(chain);
+
+        const ZyrexTrampolineChunk* const trampoline = chain->trampoline;
+        if (trampoline->backjump_address -
+            ZyrexTrampolineGetChunkInfo(trampoline)->original_code_size == (ZyanUPointer)address)
+        {
+            return chain;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/**
+ * @brief   Searches for the hook chain link that uses the given `next` pointer.
+ *
+ * @param   next    The memory passed by the user to store the next function in the chain.
+ * @param   chain   Receives a pointer to the hook chain.
+ * @param   index   Receives the index of the link.
+ *
+ * @return  `ZYAN_TRUE`, if the link was found, or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexFindHookChainLink(const ZyanConstVoidPointer* next, ZyrexHookChain** chain,
+    ZyanUSize* index)
+{
+    ZYAN_ASSERT(next);
+    ZYAN_ASSERT(chain);
+    ZYAN_ASSERT(index);
+
+    for (ZyanUSize i = 0; i < g_chain_data.chains.size; ++i)
+    {
+        ZyrexHookChain* const item = ZyanVectorGetMutable(&g_chain_data.chains, i);
+        ZYAN_ASSERT(item);
+
+        for (ZyanUSize j = 0; j < item->links.size; ++j)
+        {
+            const ZyrexHookChainLink* const link = ZyanVectorGet(&item->links, j);
+            ZYAN_ASSERT(link);
+
+            if (link->next == next)
+            {
+                *chain = item;
+                *index = j;
+                return ZYAN_TRUE;
+            }
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Creates the hook chain for the trampoline of the given attach `operation`.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexHookChainCreate(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+    ZYAN_ASSERT(operation->next);
+
+    if (!g_chain_data.chains.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_chain_data.chains, sizeof(ZyrexHookChain), 8, ZYAN_NULL));
+    }
+
+    ZyrexHookChain chain;
+    chain.trampoline = operation->trampoline;
+    ZYAN_CHECK(ZyanVectorInit(&chain.links, sizeof(ZyrexHookChainLink), 4, ZYAN_NULL));
+
+    const ZyrexHookChainLink link = { operation->callback, operation->next };
+    ZyanStatus status = ZyanVectorPushBack(&chain.links, &link);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorPushBack(&g_chain_data.chains, &chain);
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&chain.links);
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Destroys the hook chain of the given `trampoline`, if any.
+ *
+ * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ */
+static void ZyrexHookChainDestroy(const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+
+    ZyrexHookChain* const chain = ZyrexFindHookChain(trampoline);
+    if (!chain)
+    {
+        return;
+    }
+
+    ZyanVectorDestroy(&chain->links);
+    ZYAN_UNUSED(ZyanVectorDelete(&g_chain_data.chains,
+        (ZyanUSize)(chain - (ZyrexHookChain*)g_chain_data.chains.data)));
+
+    if (g_chain_data.chains.size == 0)
+    {
+        ZyanVectorDestroy(&g_chain_data.chains);
+    }
+}
+
+/**
+ * @brief   Adds the callback of the given `operation` to the front of its hook chain.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The `next` pointer of the new link is written before the new callback is published by
+ * exchanging the callback of the trampoline. The hook chain is not modified, if the function
+ * fails.
+ */
+static ZyanStatus ZyrexHookChainAdd(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    ZyrexHookChain* const chain = ZyrexFindHookChain(operation->trampoline);
+    if (!chain)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    const ZyrexHookChainLink* const head = ZyanVectorGet(&chain->links, 0);
+    ZYAN_ASSERT(head);
+
+    // Reserve the memory of the new link first, so that the insertion cannot fail after the
+    // callback has been published
+    ZYAN_CHECK(ZyanVectorReserve(&chain->links, chain->links.size + 1));
+
+    const ZyrexHookChainLink link = { operation->callback, operation->next };
+    ZyrexWriteAtomicPointer(link.next, head->callback);
+    ZYAN_CHECK(ZyrexTrampolineSetCallback(operation->trampoline, operation->callback));
+
+    return ZyanVectorInsert(&chain->links, 0, &link);
+}
+
+/**
+ * @brief   Removes the callback that uses the `next` pointer of the given `operation` from its
+ *          hook chain.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The predecessor of the removed link (or the trampoline) is redirected to its successor. The
+ * `next` pointer of the removed link stays intact, which allows threads that are currently
+ * executing the removed callback to continue the chain. The hook chain is not modified, if the
+ * function fails.
+ */
+static ZyanStatus ZyrexHookChainRemove(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    ZyrexHookChain* chain;
+    ZyanUSize index;
+    if (!ZyrexFindHookChainLink(operation->next, &chain, &index))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+    ZYAN_ASSERT(chain->links.size > 1);
+
+    const ZyrexHookChainLink* const link = ZyanVectorGet(&chain->links, index);
+    ZYAN_ASSERT(link);
+
+    if (index == 0)
+    {
+        ZYAN_CHECK(ZyrexTrampolineSetCallback(chain->trampoline, *link->next));
+    } else
+    {
+        const ZyrexHookChainLink* const previous = ZyanVectorGet(&chain->links, index - 1);
+        ZYAN_ASSERT(previous);
+
+        ZyrexWriteAtomicPointer(previous->next, *link->next);
+    }
+
+    // The link is removed, even if the vector fails to shrink its memory afterwards
+    ZYAN_UNUSED(ZyanVectorDelete(&chain->links, index));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Returns the number of links the hook chain of the given `trampoline` will have after
+ *          the pending operations were committed.
+ *
+ * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  The number of links after the commit.
+ */
+static ZyanISize ZyrexGetPendingChainLength(const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+
+    const ZyrexHookChain* const chain = ZyrexFindHookChain(trampoline);
+    ZyanISize length = chain ? (ZyanISize)chain->links.size : 0;
+
+    for (ZyanUSize i = 0; i < g_transaction_data.pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if ((item->type != ZYREX_HOOK_TYPE_INLINE) || (item->trampoline != trampoline))
+        {
+            continue;
+        }
+
+        switch (item->action)
+        {
+        case ZYREX_OPERATION_ACTION_ATTACH:
+        case ZYREX_OPERATION_ACTION_CHAIN_ADD:
+            ++length;
+            break;
+        case ZYREX_OPERATION_ACTION_REMOVE:
+            length = 0;
+            break;
+        case ZYREX_OPERATION_ACTION_CHAIN_REMOVE:
+            --length;
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    }
+
+    return length;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTransactionBegin(void)
+{
+    return ZyrexTransactionBeginEx(ZYREX_TRANSACTION_FLAG_NONE);
+}
+
+ZyanStatus ZyrexTransactionBeginEx(ZyanU32 flags)
+{
+    if (flags & ~(ZyanU32)ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (g_transaction_data.transaction_thread_id != 0)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+#ifdef ZYAN_WINDOWS
+
+    // TODO: Use platform independent APIs
+    if (InterlockedCompareExchange((volatile LONG*)&g_transaction_data.transaction_thread_id,
+        (LONG)GetCurrentThreadId(), 0) != 0)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+#else
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+    ZyanThreadId expected = 0;
+    if (!__atomic_compare_exchange_n(&g_transaction_data.transaction_thread_id, &expected, tid,
+        ZYAN_FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+#endif
+
+    g_transaction_data.flags = flags;
+    ZYAN_MEMSET(&g_transaction_data.statistics, 0, sizeof(g_transaction_data.statistics));
+    g_transaction_data.region_allocations = ZyrexTrampolineGetRegionAllocationCount();
+
+    ZYAN_CHECK(ZyanVectorInit(&g_transaction_data.pending_operations, sizeof(ZyrexOperation),
+        16, ZYAN_NULL));
+
+#ifdef ZYAN_WINDOWS
+
+    const ZyanStatus status = ZyanVectorInit(&g_transaction_data.threads_to_update,
+        sizeof(HANDLE), 16, (ZyanMemberProcedure)&ZyrexWindowsHandleDestroy);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&g_transaction_data.pending_operations);
+        return status;
+    }
+    g_transaction_data.update_all_threads = ZYAN_FALSE;
+    g_transaction_data.frozen_since = 0;
+
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanBool ZyrexTransactionIsOwnedByCurrentThread(void)
+{
+    ZyanThreadId tid;
+    if (!ZYAN_SUCCESS(ZyanThreadGetCurrentThreadId(&tid)))
+    {
+        return ZYAN_FALSE;
+    }
+
+    return (g_transaction_data.transaction_thread_id == tid);
+}
+
+ZyanStatus ZyrexUpdateThread(ZyanThreadId thread_id)
+{
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+#ifdef ZYAN_WINDOWS
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    if (thread_id == GetCurrentThreadId())
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const HANDLE handle = OpenThread(ZYREX_THREAD_ACCESS, ZYAN_FALSE, thread_id);
+    if (handle == ZYAN_NULL)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!ZyrexSuspendThread(handle))
+    {
+        CloseHandle(handle);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    return ZyanVectorPushBack(&g_transaction_data.threads_to_update, &handle);
+
+#else
+
+    ZYAN_UNUSED(thread_id);
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+ZyanStatus ZyrexUpdateAllThreads(void)
+{
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+#ifdef ZYAN_WINDOWS
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    if (g_transaction_data.flags & ZYREX_TRANSACTION_FLAG_ATOMIC_WRITES)
+    {
+        // Threads are only suspended during the commit, if any of the pending operations can not
+        // be written atomically
+        g_transaction_data.update_all_threads = ZYAN_TRUE;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    return ZyrexSuspendAllThreads();
+
+#else
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+ZyanStatus ZyrexTransactionCommit(void)
+{
+    return ZyrexTransactionCommitEx(NULL);
+}
+
+ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation)
+{
+    return ZyrexTransactionCommitWithStatistics(failed_operation, ZYAN_NULL);
+}
+
+ZyanStatus ZyrexTransactionCommitWithStatistics(const void** failed_operation,
+    ZyrexTransactionStatistics* statistics)
+{
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+#ifdef ZYAN_WINDOWS
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+#endif
+
+    ZyrexTransactionStatistics* const current = &g_transaction_data.statistics;
+    ZyanU64 timestamp;
+
+#ifdef ZYAN_WINDOWS
+
+    if (g_transaction_data.update_all_threads && ZyrexRequiresThreadUpdate())
+    {
+        ZYAN_CHECK(ZyrexSuspendAllThreads());
+    }
+
+    // Move all threads out of the affected code ranges before patching
+    timestamp = ZyrexGetTimestamp();
+    ZYAN_CHECK(ZyrexMigrateThreads());
+    current->migrate_time += ZyrexGetTimestamp() - timestamp;
+
+#endif
+
+    // Make all pages that are going to be patched writable at once
+    const ZyanUSize page_size = ZyanMemoryGetSystemPageSize();
+    ZyanVector pages;
+    ZYAN_CHECK(ZyanVectorInit(&pages, sizeof(ZyrexPatchPage), 16, ZYAN_NULL));
+
+    timestamp = ZyrexGetTimestamp();
+    ZyanUSize unprotected_pages = 0;
+    ZyanStatus status = ZyrexCollectPatchPages(&pages, page_size);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexUnprotectPatchPages(&pages, page_size, &unprotected_pages);
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_UNUSED(ZyrexRestorePatchPages(&pages, page_size, unprotected_pages));
+        ZyanVectorDestroy(&pages);
+        return status;
+    }
+    current->protect_time += ZyrexGetTimestamp() - timestamp;
+    current->page_count = unprotected_pages;
+
+    timestamp = ZyrexGetTimestamp();
+
+    // Every operation is either applied completely or not at all. The commit stops at the first
+    // operation that fails
+    const ZyanUSize operation_count = g_transaction_data.pending_operations.size;
+    ZyanUSize failed_index = operation_count;
+    for (ZyanUSize i = 0; i < operation_count; ++i)
+    {
+        const ZyrexOperation* item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        switch (item->type)
+        {
+        case ZYREX_HOOK_TYPE_INLINE:
+            switch (item->action)
+            {
+            case ZYREX_OPERATION_ACTION_ATTACH:
+            {
+                // The hook chain is created first, as writing the jump cannot fail
+                if (item->next)
+                {
+                    status = ZyrexHookChainCreate(item);
+                    if (!ZYAN_SUCCESS(status))
+                    {
+                        break;
+                    }
+                }
+                // TODO: Check if code has changed between this call and the Attach*
+                if (ZyrexIsOperationAtomic(item) &&
+                    !ZyrexTrampolineGetChunkInfo(item->trampoline)->is_hot_patch)
+                {
+                    ZyrexWriteHookJumpAtomic(item);
+                } else
+                {
+                    ZyrexWriteHookJump(item);
+                }
+                break;
+            }
+            case ZYREX_OPERATION_ACTION_REMOVE:
+            {
+                // The hook is removed, even if its trampoline could not be released
+                ZyrexRestoreInstructions(item->address, item->trampoline);
+                ZyrexHookChainDestroy(item->trampoline);
+                status = ZyrexTrampolineFree(item->trampoline);
+                if (status == ZYAN_STATUS_FALSE)
+                {
+                    status = ZYAN_STATUS_NOT_FOUND;
+                }
+                break;
+            }
+            case ZYREX_OPERATION_ACTION_CHAIN_ADD:
+            {
+                status = ZyrexHookChainAdd(item);
+                break;
+            }
+            case ZYREX_OPERATION_ACTION_CHAIN_REMOVE:
+            {
+                status = ZyrexHookChainRemove(item);
                 break;
             }
             default:
@@ -461,32 +2142,93 @@ ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation)
             break;
         case ZYREX_HOOK_TYPE_CONTEXT:
             break;
+        case ZYREX_HOOK_TYPE_IMPORT_TABLE:
+            switch (item->action)
+            {
+            case ZYREX_OPERATION_ACTION_ATTACH:
+                status = ZyrexImportHookAttach(item);
+                break;
+            case ZYREX_OPERATION_ACTION_REMOVE:
+                status = ZyrexImportHookRemove(item);
+                break;
+            default:
+                ZYAN_UNREACHABLE;
+            }
+            break;
         default:
             ZYAN_UNREACHABLE;
         }
 
         if (!ZYAN_SUCCESS(status))
         {
-            revert_index = i - 1;
+            failed_index = i;
             break;
         }
     }
 
-    if (revert_index >= 0)
+    // The failed operation and all operations after it have not been applied and release the
+    // resources they own
+    if (failed_index < operation_count)
     {
-        // TODO: Revert changes
+        if (failed_operation)
+        {
+            const ZyrexOperation* const item =
+                ZyanVectorGet(&g_transaction_data.pending_operations, failed_index);
+            ZYAN_ASSERT(item);
+
+            *failed_operation = item->address;
+        }
+        for (ZyanUSize i = failed_index; i < operation_count; ++i)
+        {
+            ZyrexOperation* const item =
+                ZyanVectorGetMutable(&g_transaction_data.pending_operations, i);
+            ZYAN_ASSERT(item);
+
+            ZyrexReleaseOperation(item);
+        }
     }
 
+    current->patch_time += ZyrexGetTimestamp() - timestamp;
+
+    // Restore the original page protection and re-protect all trampoline-regions modified during
+    // the transaction
+    timestamp = ZyrexGetTimestamp();
+    ZYAN_UNUSED(ZyrexRestorePatchPages(&pages, page_size, unprotected_pages));
+    ZYAN_UNUSED(ZyrexTrampolineProtectRegions());
+    current->protect_time += ZyrexGetTimestamp() - timestamp;
+
+    // Flush the instruction cache once per range
+    timestamp = ZyrexGetTimestamp();
+    ZYAN_UNUSED(ZyrexFlushPatchPages(&pages, page_size, unprotected_pages));
+    current->flush_time += ZyrexGetTimestamp() - timestamp;
+    ZyanVectorDestroy(&pages);
+
 #ifdef ZYAN_WINDOWS
 
+    timestamp = ZyrexGetTimestamp();
+    ZyrexResumeThreads();
+    const ZyanU64 resumed = ZyrexGetTimestamp();
+    current->resume_time += resumed - timestamp;
+    if (g_transaction_data.frozen_since)
+    {
+        current->frozen_time = resumed - g_transaction_data.frozen_since;
+    }
+    current->thread_count = g_transaction_data.threads_to_update.size;
     ZyanVectorDestroy(&g_transaction_data.threads_to_update);
 
 #endif
 
+    current->region_count =
+        ZyrexTrampolineGetRegionAllocationCount() - g_transaction_data.region_allocations;
+    if (statistics && ZYAN_SUCCESS(status))
+    {
+        *statistics = *current;
+    }
+
     ZyanVectorDestroy(&g_transaction_data.pending_operations);
     g_transaction_data.transaction_thread_id = 0;
 
-    return ZYAN_STATUS_SUCCESS;
+    return status;
 }
 
 ZyanStatus ZyrexTransactionAbort(void)
@@ -504,19 +2246,17 @@ ZyanStatus ZyrexTransactionAbort(void)
     ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
 #endif
 
-    ZYAN_VECTOR_FOREACH_MUTABLE(const ZyrexOperation, &g_transaction_data.pending_operations, 
+    ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexOperation, &g_transaction_data.pending_operations,
         operation,
     {
-        ZyrexTrampolineFree(operation->trampoline);
+        ZyrexReleaseOperation(operation);
     });
 
-#ifdef ZYAN_WINDOWS
+    ZYAN_UNUSED(ZyrexTrampolineProtectRegions());
 
-    ZYAN_VECTOR_FOREACH(HANDLE, &g_transaction_data.threads_to_update, handle,
-    {
-        ResumeThread(handle);
-    });
+#ifdef ZYAN_WINDOWS
 
+    ZyrexResumeThreads();
     ZyanVectorDestroy(&g_transaction_data.threads_to_update);
 
 #endif
@@ -533,6 +2273,13 @@ ZyanStatus ZyrexTransactionAbort(void)
 
 ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback,
     ZyanConstVoidPointer* trampoline)
+{
+    return ZyrexInstallInlineHookEx(address, callback, ZYREX_INLINE_HOOK_MODE_DEFAULT,
+        trampoline);
+}
+
+ZyanStatus ZyrexInstallInlineHookEx(void* address, const void* callback,
+    ZyrexInlineHookMode mode, ZyanConstVoidPointer* trampoline)
 {
     if (!address || !callback || !trampoline)
     {
@@ -557,17 +2304,219 @@ ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback,
         /* type                */ ZYREX_HOOK_TYPE_INLINE,
         /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
         /* address             */ ZYAN_NULL,
-        /* trampoline          */ ZYAN_NULL
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
     };
     operation.address = address;
-    ZYAN_CHECK(ZyrexTrampolineCreate(address, callback, ZYREX_SIZEOF_RELATIVE_JUMP,
-        &operation.trampoline));
+
+    switch (mode)
+    {
+    case ZYREX_INLINE_HOOK_MODE_DEFAULT:
+        ZYAN_CHECK(ZyrexTrampolineCreate(address, callback, ZYREX_SIZEOF_RELATIVE_JUMP,
+            &operation.trampoline));
+        break;
+    case ZYREX_INLINE_HOOK_MODE_HOT_PATCH:
+        ZYAN_CHECK(ZyrexTrampolineCreateHotPatch(address, callback, &operation.trampoline));
+        break;
+    case ZYREX_INLINE_HOOK_MODE_PREFER_HOT_PATCH:
+    {
+        const ZyanStatus status = ZyrexTrampolineIsHotPatchable(address);
+        ZYAN_CHECK(status);
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            ZYAN_CHECK(ZyrexTrampolineCreateHotPatch(address, callback, &operation.trampoline));
+        } else
+        {
+            ZYAN_CHECK(ZyrexTrampolineCreate(address, callback, ZYREX_SIZEOF_RELATIVE_JUMP,
+                &operation.trampoline));
+        }
+        break;
+    }
+    default:
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
     *trampoline = &operation.trampoline->code_buffer;
 
     return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
 }
 
+ZyanStatus ZyrexInstallInlineHooks(const ZyrexHookSpec* specs, ZyanUSize count,
+    ZyanUSize* failed_index)
+{
+    if (!specs || !count)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        if (!specs[i].address || !specs[i].callback || !specs[i].trampoline)
+        {
+            if (failed_index)
+            {
+                *failed_index = i;
+            }
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+
+    ZYAN_CHECK(ZyanVectorReserve(&g_transaction_data.pending_operations,
+        g_transaction_data.pending_operations.size + count));
+
+    // Sort the hooks by their target address
+    ZyanVector sorted;
+    ZYAN_CHECK(ZyanVectorInit(&sorted, sizeof(const ZyrexHookSpec*), count, ZYAN_NULL));
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; (i < count) && ZYAN_SUCCESS(status); ++i)
+    {
+        const ZyrexHookSpec* const spec = &specs[i];
+        ZyanUSize found_index;
+        status = ZyanVectorBinarySearch(&sorted, &spec, &found_index,
+            (ZyanComparison)&ZyrexCompareHookSpec);
+        if (ZYAN_SUCCESS(status))
+        {
+            status = ZyanVectorInsert(&sorted, found_index, &spec);
+        }
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&sorted);
+        return status;
+    }
+
+    // Install the hooks group by group. The trampoline chunks of each group of neighboring hooks
+    // are reserved up front, so that the hooks fill the same regions one chunk after another
+    const ZyanUSize first_operation = g_transaction_data.pending_operations.size;
+    const ZyrexHookSpec* const* const items = (const ZyrexHookSpec* const*)sorted.data;
+    ZyanUSize group_begin = 0;
+    while (group_begin < count)
+    {
+        const ZyanUPointer group_lo = (ZyanUPointer)items[group_begin]->address;
+        ZyanUSize group_end = group_begin + 1;
+        while ((group_end < count) &&
+            ((ZyanUPointer)items[group_end]->address - group_lo <= ZYREX_HOOK_GROUP_RANGE))
+        {
+            ++group_end;
+        }
+
+        // Failing to reserve the chunks is not fatal, as every trampoline searches for a
+        // suitable region on its own
+        ZYAN_UNUSED(ZyrexTrampolineReserveChunks(items[group_begin]->address,
+            items[group_end - 1]->address, group_end - group_begin));
+
+        for (ZyanUSize i = group_begin; i < group_end; ++i)
+        {
+            const ZyrexHookSpec* const spec = items[i];
+            status = ZyrexInstallInlineHook(spec->address, spec->callback, spec->trampoline);
+            if (!ZYAN_SUCCESS(status))
+            {
+                ZyrexDiscardOperations(first_operation);
+                if (failed_index)
+                {
+                    *failed_index = (ZyanUSize)(spec - specs);
+                }
+                ZyanVectorDestroy(&sorted);
+                return status;
+            }
+        }
+
+        group_begin = group_end;
+    }
+
+    ZyanVectorDestroy(&sorted);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexInstallImportHook(const void* function, const void* callback,
+    ZyanConstVoidPointer* original)
+{
+    if (!function || !callback || !original)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+
+    if (ZyrexFindImportHook(function) ||
+        ZyrexIsImportOperationPending(function, ZYREX_OPERATION_ACTION_ATTACH))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyrexOperation operation =
+    {
+        /* type                */ ZYREX_HOOK_TYPE_IMPORT_TABLE,
+        /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
+    };
+    operation.address = (void*)function;
+    operation.callback = callback;
+
+    // The table entries are collected up front, so that the pages can be unprotected at once
+    ZYAN_CHECK(ZyanVectorInit(&operation.slots, sizeof(ZyrexImportSlot), 8, ZYAN_NULL));
+    ZyanStatus status = ZyrexImportTableCollectSlots(function, callback, &operation.slots);
+    if (ZYAN_SUCCESS(status) && (operation.slots.size == 0))
+    {
+        status = ZYAN_STATUS_NOT_FOUND;
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&operation.slots);
+        return status;
+    }
+
+    *original = function;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexReserveTrampolineMemory(const void* address, ZyanUSize count)
+{
+    if (!address || !count)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTrampolineReserveRegions(address, count);
+}
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook installation                                                                              */
 /* ---------------------------------------------------------------------------------------------- */
@@ -590,15 +2539,18 @@ ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* original)
     ZyrexTrampolineChunk* trampoline;
     ZYAN_CHECK(ZyrexTrampolineFind(*original, &trampoline));
 
-    ZyanVoidPointer const target =
-        (ZyanVoidPointer)(trampoline->backjump_address - trampoline->original_code_size);
+    ZyanVoidPointer const target = (ZyanVoidPointer)(trampoline->backjump_address -
+        ZyrexTrampolineGetChunkInfo(trampoline)->original_code_size);
 
     ZyrexOperation operation =
     {
         /* type                */ ZYREX_HOOK_TYPE_INLINE,
         /* action              */ ZYREX_OPERATION_ACTION_REMOVE,
         /* address             */ ZYAN_NULL,
-        /* trampoline          */ ZYAN_NULL
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
     };
     operation.address = target;
     operation.trampoline = trampoline;
@@ -608,6 +2560,174 @@ ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* original)
     return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
 }
 
+ZyanStatus ZyrexRemoveImportHook(const void* function)
+{
+    if (!function)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+
+    if (!ZyrexFindImportHook(function))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+    if (ZyrexIsImportOperationPending(function, ZYREX_OPERATION_ACTION_REMOVE))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyrexOperation operation =
+    {
+        /* type                */ ZYREX_HOOK_TYPE_IMPORT_TABLE,
+        /* action              */ ZYREX_OPERATION_ACTION_REMOVE,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
+    };
+    operation.address = (void*)function;
+
+    return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook chaining                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexInstallInlineHookChained(void* address, const void* callback,
+    ZyanConstVoidPointer* next)
+{
+    if (!address || !callback || !next)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+
+    ZyrexOperation operation =
+    {
+        /* type                */ ZYREX_HOOK_TYPE_INLINE,
+        /* action              */ ZYREX_OPERATION_ACTION_CHAIN_ADD,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
+    };
+    operation.address = address;
+    operation.callback = callback;
+    operation.next = next;
+
+    // Search for a chained hook that is already installed or pending for the target function
+    const ZyrexHookChain* const chain = ZyrexFindHookChainByAddress(address);
+    if (chain)
+    {
+        operation.trampoline = chain->trampoline;
+    }
+    for (ZyanUSize i = 0; !operation.trampoline &&
+        (i < g_transaction_data.pending_operations.size); ++i)
+    {
+        const ZyrexOperation* const item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if ((item->action == ZYREX_OPERATION_ACTION_ATTACH) && item->next &&
+            (item->address == address))
+        {
+            operation.trampoline = item->trampoline;
+        }
+    }
+
+    if (operation.trampoline)
+    {
+        return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
+    }
+
+    // The first callback installs the hook itself
+    ZYAN_CHECK(ZyrexInstallInlineHookEx(address, callback, ZYREX_INLINE_HOOK_MODE_DEFAULT, next));
+
+    ZyrexOperation* const item = ZyanVectorGetMutable(&g_transaction_data.pending_operations,
+        g_transaction_data.pending_operations.size - 1);
+    ZYAN_ASSERT(item);
+    item->callback = callback;
+    item->next = next;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexRemoveInlineHookChained(ZyanConstVoidPointer* next)
+{
+    if (!next)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanThreadId tid;
+    ZYAN_CHECK(ZyanThreadGetCurrentThreadId(&tid));
+
+    if (g_transaction_data.transaction_thread_id != tid)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+
+    ZyrexHookChain* chain;
+    ZyanUSize index;
+    if (!ZyrexFindHookChainLink(next, &chain, &index))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZyrexTrampolineChunk* const trampoline = chain->trampoline;
+    ZyrexOperation operation =
+    {
+        /* type                */ ZYREX_HOOK_TYPE_INLINE,
+        /* action              */ ZYREX_OPERATION_ACTION_CHAIN_REMOVE,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* callback            */ ZYAN_NULL,
+        /* next                */ ZYAN_NULL,
+        /* slots               */ ZYAN_VECTOR_INITIALIZER
+    };
+    operation.address = (ZyanVoidPointer)(trampoline->backjump_address -
+        ZyrexTrampolineGetChunkInfo(trampoline)->original_code_size);
+    operation.trampoline = trampoline;
+    operation.next = next;
+
+    // The last callback removes the hook itself
+    const ZyanISize length = ZyrexGetPendingChainLength(trampoline);
+    if (length < 1)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+    if (length == 1)
+    {
+        operation.action = ZYREX_OPERATION_ACTION_REMOVE;
+        operation.next = ZYAN_NULL;
+    }
+
+    return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
+}
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
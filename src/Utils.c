@@ -24,4 +24,55 @@
 
 ***************************************************************************************************/
 
-int b = 0;
+#include <Zycore/LibC.h>
+#include <Zyrex/Internal/Utils.h>
+
+#if defined(ZYAN_MSVC)
+#   include <intrin.h>
+#endif
+
+/* ============================================================================================== */
+/* Utility functions                                                                              */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Code patching                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+void ZyrexWriteAtomic64(void* address, const void* data, ZyanUSize size)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(data);
+
+    const ZyanUSize offset = (ZyanUPointer)address & 7;
+    ZYAN_ASSERT(offset + size <= 8);
+
+    volatile ZyanU64* const qword = (volatile ZyanU64*)((ZyanUPointer)address - offset);
+
+    ZyanU64 expected = *qword;
+    for (;;)
+    {
+        ZyanU64 desired = expected;
+        ZYAN_MEMCPY((ZyanU8*)&desired + offset, data, size);
+
+#if defined(ZYAN_MSVC)
+        const ZyanU64 previous = (ZyanU64)_InterlockedCompareExchange64(
+            (volatile __int64*)qword, (__int64)desired, (__int64)expected);
+        if (previous == expected)
+        {
+            break;
+        }
+        expected = previous;
+#else
+        if (__atomic_compare_exchange_n(qword, &expected, desired, ZYAN_FALSE, __ATOMIC_SEQ_CST,
+            __ATOMIC_SEQ_CST))
+        {
+            break;
+        }
+#endif
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
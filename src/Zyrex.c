@@ -27,6 +27,7 @@
 #include <Zycore/Zycore.h>
 #include <Zydis/Zydis.h>
 #include <Zyrex/Zyrex.h>
+#include <Zyrex/Internal/Trampoline.h>
 
 /* ============================================================================================== */
 /* Exported functions                                                                             */
@@ -69,6 +70,23 @@ ZyanU64 ZyrexGetVersion(void)
     return ZYREX_VERSION;
 }
 
+ZyanStatus ZyrexGetMemoryInfo(ZyrexMemoryInfo* info)
+{
+    if (!info)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    return ZyrexTrampolineGetMemoryInfo(&info->reserved_bytes, &info->committed_bytes,
+        &info->number_of_trampolines);
+}
+
+ZyanStatus ZyrexQueryHookStatistics(ZyrexHookStatistics* statistics, ZyanUSize capacity,
+    ZyanUSize* count)
+{
+    return ZyrexTrampolineQueryStatistics(statistics, capacity, count);
+}
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */